@@ -0,0 +1,725 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "hash_utils.h"
+#include "keyspace.h"
+#include "enumerator.h"
+#include "search.h"
+#include "shared_state.h"
+
+/**
+ * Benchmark do quebra-senhas (make bench)
+ *
+ * Mede candidatos/s de:
+ *   - md5_string(), o caminho de referência
+ *   - md5_batch_isa() e dos núcleos especializados por comprimento, para cada
+ *     conjunto de instruções suportado pela CPU
+ *   - enumeração sozinha (enumerator_next, sem MD5)
+ *   - busca ponta a ponta (search_dynamic sobre a fila compartilhada) com 1 a
+ *     N threads e N processos, para vários comprimentos e tamanhos de charset
+ *
+ * Cada medida é calibrada para durar cerca de --seconds, passa por uma
+ * execução de aquecimento e é repetida --reps vezes com CLOCK_MONOTONIC.
+ * O resultado sai em JSON (stdout ou -o); o progresso legível vai para stderr.
+ *
+ * Linha de base (make check): --save-baseline grava a taxa mediana de cada
+ * medida num arquivo de texto, e --baseline compara uma execução nova com
+ * ele. A melhor repetição precisa chegar a (100 - --tolerance)% da mediana
+ * gravada; abaixo disso a medida é uma regressão e o benchmark sai com 2.
+ * Comparar a melhor repetição deixa de fora o ruído de uma repetição lenta.
+ * A linha de base vale para a máquina em que foi gravada.
+ *
+ * Uso: ./benchmark [--quick] [--reps N] [--seconds S] [--max-workers N] [-o arquivo]
+ *                  [--save-baseline arquivo | --baseline arquivo [--tolerance P]]
+ */
+
+#define BENCH_SCHEMA 1
+#define BENCH_DEFAULT_REPS 5
+#define BENCH_DEFAULT_SECONDS 0.25
+#define BENCH_MAX_REPS 100
+#define BENCH_DEFAULT_TOLERANCE 20.0    // Queda aceita (%) em relação à linha de base
+#define BENCH_BASELINE_MAX 256          // Medidas numa linha de base
+#define BENCH_LABEL_MAX 96
+#define BENCH_BASELINE_RETRIES 2        // Novas medidas antes de contar uma regressão
+// Alvo que nunca aparece: as buscas ponta a ponta percorrem todo o espaço
+#define BENCH_TARGET "ffffffffffffffffffffffffffffffff"
+
+/**
+ * Corpo de uma medida: processa cerca de iters candidatos
+ *
+ * @return Candidatos efetivamente processados
+ */
+typedef long long (*BenchFn)(void *arg, long long iters);
+
+/**
+ * Taxas (candidatos/s) das repetições de uma medida
+ */
+typedef struct {
+    double median, min, max, mean, stddev;
+    double seconds;             // Mediana do tempo de uma repetição
+    long long candidates;       // Candidatos por repetição
+    int reps;
+} BenchStats;
+
+typedef struct {
+    int reps;
+    double seconds;
+    int max_workers;
+    int quick;
+} BenchConfig;
+
+// Evita que o compilador descarte os laços medidos
+static volatile uint32_t bench_sink;
+
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Escolhe iters para que uma execução dure cerca de target segundos
+ * As execuções de calibração também aquecem caches, preditores e frequência.
+ * Para quando fn processa menos que o pedido (espaço de busca esgotado).
+ */
+static long long bench_calibrate(BenchFn fn, void *arg, double target) {
+    long long iters = 1024;
+
+    for (;;) {
+        double start = monotonic_seconds();
+        long long done = fn(arg, iters);
+        double elapsed = monotonic_seconds() - start;
+
+        if (done < iters) {
+            return done;
+        }
+        if (elapsed >= target / 4) {
+            double scaled = iters * (target / elapsed);
+            return scaled > iters ? (long long)scaled : iters;
+        }
+        iters *= 4;
+    }
+}
+
+// Última medida de bench_repeat(), repetida pela comparação com a linha de base
+static struct {
+    BenchFn fn;
+    void *arg;
+    long long iters;
+    int reps;
+} last_measure;
+
+/**
+ * Uma execução de aquecimento e reps execuções medidas de iters candidatos
+ */
+static void bench_repeat(BenchFn fn, void *arg, long long iters, int reps, BenchStats *stats) {
+    double rates[BENCH_MAX_REPS], times[BENCH_MAX_REPS];
+    last_measure.fn = fn;
+    last_measure.arg = arg;
+    last_measure.iters = iters;
+    last_measure.reps = reps;
+    long long done = fn(arg, iters);
+
+    for (int r = 0; r < reps; r++) {
+        double start = monotonic_seconds();
+        done = fn(arg, iters);
+        times[r] = monotonic_seconds() - start;
+        rates[r] = done / (times[r] > 0 ? times[r] : 1e-9);
+    }
+
+    double sum = 0, sum_sq = 0;
+    for (int r = 0; r < reps; r++) {
+        sum += rates[r];
+        sum_sq += rates[r] * rates[r];
+    }
+    qsort(rates, reps, sizeof(double), compare_doubles);
+    qsort(times, reps, sizeof(double), compare_doubles);
+
+    stats->reps = reps;
+    stats->candidates = done;
+    stats->min = rates[0];
+    stats->max = rates[reps - 1];
+    stats->median = reps % 2 ? rates[reps / 2] : (rates[reps / 2 - 1] + rates[reps / 2]) / 2;
+    stats->mean = sum / reps;
+    stats->stddev = sqrt(fmax(0, sum_sq / reps - stats->mean * stats->mean));
+    stats->seconds = times[reps / 2];
+}
+
+// ---------------------------------------------------------------------------
+// Saída JSON: um objeto por medida no vetor "results"
+
+static FILE *json;
+static int json_results;
+
+/**
+ * Abre o objeto de uma medida; os parâmetros vêm em seguida com json_param_*
+ */
+static void json_begin(const char *group) {
+    fprintf(json, "%s\n    {\"group\": \"%s\"", json_results++ ? "," : "", group);
+}
+
+static void json_param_str(const char *key, const char *value) {
+    fprintf(json, ", \"%s\": \"%s\"", key, value);
+}
+
+static void json_param_int(const char *key, long long value) {
+    fprintf(json, ", \"%s\": %lld", key, value);
+}
+
+static void json_param_double(const char *key, double value) {
+    fprintf(json, ", \"%s\": %.4f", key, value);
+}
+
+// ---------------------------------------------------------------------------
+// Linha de base: "taxa mediana rótulo" por linha; '#' começa um comentário
+
+typedef struct {
+    char label[BENCH_LABEL_MAX];
+    double median;
+} BaselineEntry;
+
+static BaselineEntry baseline[BENCH_BASELINE_MAX];
+static int baseline_count;
+static double baseline_tolerance = BENCH_DEFAULT_TOLERANCE;
+static int baseline_compared;
+static int baseline_regressions;
+static FILE *baseline_out;      // --save-baseline, ou NULL
+
+/**
+ * Lê a linha de base gravada por --save-baseline
+ *
+ * @return 0 em caso de sucesso, -1 se o arquivo não abre ou não tem medidas
+ */
+static int baseline_load(const char *path) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        perror(path);
+        return -1;
+    }
+
+    char line[BENCH_LABEL_MAX + 64];
+    while (fgets(line, sizeof(line), file) != NULL && baseline_count < BENCH_BASELINE_MAX) {
+        BaselineEntry *entry = &baseline[baseline_count];
+        int label_start;
+        line[strcspn(line, "\n")] = '\0';
+        if (line[0] == '#' || sscanf(line, "%lf %n", &entry->median, &label_start) != 1 ||
+            line[label_start] == '\0') {
+            continue;
+        }
+        snprintf(entry->label, sizeof(entry->label), "%s", line + label_start);
+        baseline_count++;
+    }
+    fclose(file);
+
+    if (baseline_count == 0) {
+        fprintf(stderr, "Erro: Nenhuma medida na linha de base %s\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Grava a medida em --save-baseline e a compara com a linha de base lida
+ * Uma queda é medida de novo até BENCH_BASELINE_RETRIES vezes antes de
+ * contar: uma rajada de outro processo na máquina passa, uma regressão de
+ * verdade continua lá.
+ */
+static void baseline_check(const BenchStats *stats, const char *label) {
+    if (baseline_out != NULL) {
+        fprintf(baseline_out, "%.0f %s\n", stats->median, label);
+    }
+
+    for (int i = 0; i < baseline_count; i++) {
+        if (strcmp(baseline[i].label, label) != 0 || baseline[i].median <= 0) {
+            continue;
+        }
+        double best = stats->max;
+        double floor = baseline[i].median * (1 - baseline_tolerance / 100);
+        for (int retry = 0; retry < BENCH_BASELINE_RETRIES && best < floor; retry++) {
+            BenchStats again;
+            bench_repeat(last_measure.fn, last_measure.arg, last_measure.iters, last_measure.reps,
+                         &again);
+            best = again.max > best ? again.max : best;
+        }
+        baseline_compared++;
+        if (best < floor) {
+            baseline_regressions++;
+            fprintf(stderr, "  ✗ REGRESSÃO em %s: %.2f M/s na melhor repetição, linha de base "
+                    "%.2f M/s (%.0f%%)\n", label, best / 1e6, baseline[i].median / 1e6,
+                    100 * best / baseline[i].median);
+        }
+        return;
+    }
+}
+
+/**
+ * Fecha o objeto com as estatísticas e mostra a taxa mediana em stderr
+ */
+static void json_end(const BenchStats *stats, const char *label) {
+    fprintf(json, ", \"candidates\": %lld, \"reps\": %d, \"seconds\": %.6f, "
+                  "\"candidates_per_sec\": {\"median\": %.0f, \"min\": %.0f, \"max\": %.0f, "
+                  "\"mean\": %.0f, \"stddev\": %.0f}}",
+            stats->candidates, stats->reps, stats->seconds,
+            stats->median, stats->min, stats->max, stats->mean, stats->stddev);
+    fprintf(stderr, "  %-44s %10.2f M/s (±%.1f%%)\n", label, stats->median / 1e6,
+            stats->mean > 0 ? 100 * stats->stddev / stats->mean : 0);
+    baseline_check(stats, label);
+}
+
+/**
+ * Nome da CPU (/proc/cpuinfo), para comparar resultados entre máquinas
+ * Aspas e barras são trocadas para não quebrar o JSON.
+ */
+static void cpu_model(char *output, size_t size) {
+    FILE *file = fopen("/proc/cpuinfo", "r");
+    char line[256];
+
+    snprintf(output, size, "desconhecida");
+    while (file != NULL && fgets(line, sizeof(line), file) != NULL) {
+        char *value = strchr(line, ':');
+        if (strncmp(line, "model name", 10) == 0 && value != NULL) {
+            snprintf(output, size, "%s", value + 2);
+            output[strcspn(output, "\n")] = '\0';
+            for (char *p = output; *p != '\0'; p++) {
+                if (*p == '"' || *p == '\\') *p = '\'';
+            }
+            break;
+        }
+    }
+    if (file != NULL) {
+        fclose(file);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Núcleos isolados
+
+/**
+ * md5_string() sobre senhas de 8 bytes, trocando um caractere por iteração
+ */
+static long long run_md5_string(void *arg, long long iters) {
+    char password[9] = "aaaaaaaa", hex[33];
+    (void)arg;
+
+    for (long long i = 0; i < iters; i++) {
+        password[7] = (char)('a' + (i & 15));
+        password[6] = (char)('a' + ((i >> 4) & 15));
+        md5_string(password, hex);
+        bench_sink += (uint8_t)hex[0];
+    }
+    return iters;
+}
+
+typedef struct {
+    MD5Isa isa;
+    MD5Block blocks[MD5_BATCH_MAX];
+} BatchArg;
+
+/**
+ * md5_batch_isa() em lotes de MD5_BATCH_MAX blocos de 8 bytes
+ */
+static long long run_batch(void *arg, long long iters) {
+    BatchArg *batch = arg;
+    uint32_t states[MD5_BATCH_MAX][4];
+    long long batches = (iters + MD5_BATCH_MAX - 1) / MD5_BATCH_MAX;
+
+    for (long long i = 0; i < batches; i++) {
+        md5_block_set_byte(&batch->blocks[i & (MD5_BATCH_MAX - 1)], 0, (uint8_t)i);
+        md5_batch_isa(batch->isa, batch->blocks, MD5_BATCH_MAX, states);
+        bench_sink += states[0][0];
+    }
+    return batches * MD5_BATCH_MAX;
+}
+
+typedef struct {
+    MD5ScanFn scan;
+    uint32_t init[4];
+    MD5Block block;
+    int len;
+    uint8_t values[64];
+    uint32_t target[4];
+} ScanArg;
+
+/**
+ * Núcleo especializado: 64 valores no último caractere por chamada
+ */
+static long long run_scan(void *arg, long long iters) {
+    ScanArg *scan = arg;
+    long long calls = (iters + 63) / 64;
+
+    for (long long i = 0; i < calls; i++) {
+        md5_block_set_byte(&scan->block, 0, (uint8_t)('a' + (i & 15)));
+        bench_sink += (uint32_t)scan->scan(scan->init, &scan->block, scan->values, 64, scan->target);
+    }
+    return calls * 64;
+}
+
+typedef struct {
+    Keyspace keyspace;
+} EnumArg;
+
+/**
+ * Só o enumerador: avança o odômetro sem calcular MD5
+ */
+static long long run_enumerate(void *arg, long long iters) {
+    EnumArg *en = arg;
+    KeyspaceIndex size = keyspace_size(&en->keyspace);
+    long long count = iters < size ? iters : (long long)size;
+    Enumerator e;
+
+    enumerator_init(&e, &en->keyspace, 0, count);
+    do {
+        bench_sink += md5_block_get_byte(&e.block, en->keyspace.length - 1);
+    } while (enumerator_next(&e));
+    return count;
+}
+
+// ---------------------------------------------------------------------------
+// Busca ponta a ponta
+
+typedef struct {
+    SharedState *shared;        // Mapeamento compartilhado (sobrevive ao fork)
+    SearchJob job;
+    int workers;
+    int processes;              // 1 = fork() por worker, 0 = threads
+} ScaleArg;
+
+/**
+ * Contexto de uma thread, numa linha de cache própria
+ * (thread_engine_run() não é usado porque imprime um resumo por thread)
+ */
+typedef struct {
+    SearchContext ctx;
+    pthread_t thread;
+} ScaleSlot;
+
+static void *scale_thread(void *arg) {
+    search_dynamic(&((ScaleSlot *)arg)->ctx);
+    return NULL;
+}
+
+/**
+ * Uma busca completa pelos primeiros iters índices do espaço, distribuídos
+ * pela fila dinâmica entre os workers
+ */
+static long long run_scale(void *arg, long long iters) {
+    ScaleArg *scale = arg;
+    SharedState *shared = scale->shared;
+    KeyspaceIndex size = keyspace_size(&shared->keyspace);
+
+    atomic_store(&shared->found, 0);
+    atomic_store(&shared->winner, -1);
+    atomic_store(&shared->next_index, 0);
+    shared_state_set_queue(shared, iters < size ? iters : size);
+    shared->num_workers = scale->workers;
+
+    if (scale->processes) {
+        for (int i = 0; i < scale->workers; i++) {
+            pid_t pid = fork();
+            if (pid == 0) {
+                SearchContext ctx;
+                search_context_init(&ctx, &scale->job, shared, i);
+                search_dynamic(&ctx);
+                _exit(0);
+            } else if (pid < 0) {
+                perror("fork");
+            }
+        }
+        while (wait(NULL) > 0) {
+        }
+    } else {
+        ScaleSlot *slots = aligned_alloc(CACHE_LINE_SIZE, scale->workers * sizeof(ScaleSlot));
+        if (slots == NULL) {
+            perror("aligned_alloc");
+            return 0;
+        }
+        for (int i = 0; i < scale->workers; i++) {
+            search_context_init(&slots[i].ctx, &scale->job, shared, i);
+            pthread_create(&slots[i].thread, NULL, scale_thread, &slots[i]);
+        }
+        for (int i = 0; i < scale->workers; i++) {
+            pthread_join(slots[i].thread, NULL);
+        }
+        free(slots);
+    }
+    return (long long)shared->total;
+}
+
+/**
+ * Escalonamento forte: o mesmo trabalho (calibrado para um worker) com
+ * 1, 2, 4, ... até max_workers threads e processos
+ */
+static void bench_scaling(const BenchConfig *config, SharedState *shared, const char *charset_name,
+                          const char *charset, int len) {
+    ScaleArg scale = {.shared = shared, .workers = 1, .processes = 0};
+    char label[BENCH_LABEL_MAX];
+
+    keyspace_init_charset(&shared->keyspace, charset, len);
+    search_job_init(&scale.job, BENCH_TARGET, &shared->keyspace);
+    long long iters = bench_calibrate(run_scale, &scale, config->seconds);
+
+    for (int processes = 0; processes <= 1; processes++) {
+        double base = 0;
+        for (int workers = 1; ; workers = workers * 2 < config->max_workers ?
+                                           workers * 2 : config->max_workers) {
+            BenchStats stats;
+            scale.workers = workers;
+            scale.processes = processes;
+            bench_repeat(run_scale, &scale, iters, config->reps, &stats);
+            if (workers == 1) {
+                base = stats.median;
+            }
+
+            json_begin("scaling");
+            json_param_str("engine", processes ? "processes" : "threads");
+            json_param_int("workers", workers);
+            json_param_int("len", len);
+            json_param_str("charset", charset_name);
+            json_param_int("charset_size", (long long)strlen(charset));
+            json_param_double("speedup", stats.median / base);
+            json_param_double("efficiency", stats.median / base / workers);
+            snprintf(label, sizeof(label), "%s x%d, %d x %s", processes ? "processos" : "threads",
+                     workers, len, charset_name);
+            json_end(&stats, label);
+
+            if (workers == config->max_workers) {
+                break;
+            }
+        }
+    }
+}
+
+static void print_usage(const char *program) {
+    fprintf(stderr, "Uso: %s [opções]\n", program);
+    fprintf(stderr, "  -q, --quick              Menos casos, repetições e tempo (verificação rápida)\n");
+    fprintf(stderr, "  -r, --reps N             Repetições medidas por caso (padrão: %d)\n",
+            BENCH_DEFAULT_REPS);
+    fprintf(stderr, "  -t, --seconds S          Duração alvo de cada repetição (padrão: %.2f)\n",
+            BENCH_DEFAULT_SECONDS);
+    fprintf(stderr, "  -w, --max-workers N      Maior número de workers (padrão: CPUs online)\n");
+    fprintf(stderr, "  -o, --output ARQUIVO     Grava o JSON no arquivo em vez de stdout\n");
+    fprintf(stderr, "  -s, --save-baseline ARQ  Grava a taxa mediana de cada medida como linha de base\n");
+    fprintf(stderr, "  -b, --baseline ARQUIVO   Compara com a linha de base; sai com 2 se houver regressão\n");
+    fprintf(stderr, "  -T, --tolerance P        Queda aceita em %% (padrão: %.0f)\n",
+            BENCH_DEFAULT_TOLERANCE);
+}
+
+int main(int argc, char *argv[]) {
+    BenchConfig config = {BENCH_DEFAULT_REPS, BENCH_DEFAULT_SECONDS,
+                          (int)sysconf(_SC_NPROCESSORS_ONLN), 0};
+    const char *output_path = NULL;
+    const char *baseline_path = NULL;
+    const char *save_path = NULL;
+    static const struct option long_options[] = {
+        {"quick", no_argument, NULL, 'q'},
+        {"reps", required_argument, NULL, 'r'},
+        {"seconds", required_argument, NULL, 't'},
+        {"max-workers", required_argument, NULL, 'w'},
+        {"output", required_argument, NULL, 'o'},
+        {"save-baseline", required_argument, NULL, 's'},
+        {"baseline", required_argument, NULL, 'b'},
+        {"tolerance", required_argument, NULL, 'T'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+    int opt;
+
+    while ((opt = getopt_long(argc, argv, "qr:t:w:o:s:b:T:h", long_options, NULL)) != -1) {
+        switch (opt) {
+            case 'q':
+                config.quick = 1;
+                config.reps = 3;
+                config.seconds = 0.05;
+                break;
+            case 'r':
+                config.reps = atoi(optarg);
+                break;
+            case 't':
+                config.seconds = atof(optarg);
+                break;
+            case 'w':
+                config.max_workers = atoi(optarg);
+                break;
+            case 'o':
+                output_path = optarg;
+                break;
+            case 's':
+                save_path = optarg;
+                break;
+            case 'b':
+                baseline_path = optarg;
+                break;
+            case 'T':
+                baseline_tolerance = atof(optarg);
+                break;
+            default:
+                print_usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (config.reps < 1 || config.reps > BENCH_MAX_REPS || config.seconds <= 0 ||
+        config.max_workers < 1) {
+        fprintf(stderr, "Erro: reps deve estar entre 1 e %d, seconds e max-workers devem ser positivos\n",
+                BENCH_MAX_REPS);
+        return 1;
+    }
+    if (baseline_tolerance <= 0 || baseline_tolerance >= 100) {
+        fprintf(stderr, "Erro: tolerance deve estar entre 0 e 100\n");
+        return 1;
+    }
+    if (baseline_path != NULL && baseline_load(baseline_path) != 0) {
+        return 1;
+    }
+
+    json = output_path != NULL ? fopen(output_path, "w") : stdout;
+    if (json == NULL) {
+        perror(output_path);
+        return 1;
+    }
+
+    int shm_fd;
+    SharedState *shared = shared_state_create(&shm_fd, 0);
+    if (shared == NULL) {
+        return 1;
+    }
+    shared->dynamic = 1;
+
+    char model[128], date[32];
+    time_t now = time(NULL);
+    cpu_model(model, sizeof(model));
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+    fprintf(json, "{\n  \"schema\": %d,\n  \"date\": \"%s\",\n", BENCH_SCHEMA, date);
+    fprintf(json, "  \"host\": {\"cpu\": \"%s\", \"cpus_online\": %ld, \"isa\": \"%s\", \"lanes\": %d},\n",
+            model, sysconf(_SC_NPROCESSORS_ONLN), md5_isa_name(md5_isa_best()),
+            md5_isa_lanes(md5_isa_best()));
+    fprintf(json, "  \"config\": {\"reps\": %d, \"warmup\": 1, \"target_seconds\": %.3f, "
+                  "\"max_workers\": %d, \"quick\": %s},\n  \"results\": [",
+            config.reps, config.seconds, config.max_workers, config.quick ? "true" : "false");
+
+    if (save_path != NULL) {
+        baseline_out = fopen(save_path, "w");
+        if (baseline_out == NULL) {
+            perror(save_path);
+            return 1;
+        }
+        fprintf(baseline_out, "# %s, %s, %d repetições de ~%.2f s%s\n", model, date, config.reps,
+                config.seconds, config.quick ? ", --quick" : "");
+    }
+
+    fprintf(stderr, "=== Benchmark (%s, %d repetições de ~%.2f s) ===\n", model, config.reps,
+            config.seconds);
+    char label[BENCH_LABEL_MAX];
+    BenchStats stats;
+
+    // Caminho de referência
+    fprintf(stderr, "\nMD5 isolado:\n");
+    bench_repeat(run_md5_string, NULL, bench_calibrate(run_md5_string, NULL, config.seconds),
+                 config.reps, &stats);
+    json_begin("md5_string");
+    json_param_int("len", 8);
+    json_end(&stats, "md5_string, 8 bytes");
+
+    // Lotes e núcleos especializados, por conjunto de instruções
+    static const int scan_lengths[] = {4, 8, 16, 32, 55};
+    int num_scan_lengths = config.quick ? 2 : (int)(sizeof(scan_lengths) / sizeof(scan_lengths[0]));
+    for (int isa = MD5_ISA_SCALAR; isa < MD5_ISA_COUNT; isa++) {
+        if (!md5_isa_supported(isa)) {
+            continue;
+        }
+
+        BatchArg batch = {.isa = isa};
+        for (int i = 0; i < MD5_BATCH_MAX; i++) {
+            md5_block_init(&batch.blocks[i], "benchmrk", 8);
+        }
+        bench_repeat(run_batch, &batch, bench_calibrate(run_batch, &batch, config.seconds),
+                     config.reps, &stats);
+        json_begin("batch");
+        json_param_str("isa", md5_isa_name(isa));
+        json_param_int("lanes", md5_isa_lanes(isa));
+        json_param_int("len", 8);
+        snprintf(label, sizeof(label), "md5_batch %s, 8 bytes", md5_isa_name(isa));
+        json_end(&stats, label);
+
+        for (int l = 0; l < num_scan_lengths; l++) {
+            ScanArg scan = {.len = scan_lengths[l], .target = {0, 0, 0, 0}};
+            char password[MD5_BLOCK_MAX_INPUT + 1];
+            memset(password, 'a', scan.len);
+            md5_block_init(&scan.block, password, scan.len);
+            md5_midstate(NULL, 0, scan.init);
+            for (int v = 0; v < 64; v++) {
+                scan.values[v] = (uint8_t)(' ' + v);
+            }
+            scan.scan = md5_scan_kernel(isa, scan.len);
+            if (scan.scan == NULL) {
+                continue;
+            }
+            bench_repeat(run_scan, &scan, bench_calibrate(run_scan, &scan, config.seconds),
+                         config.reps, &stats);
+            json_begin("scan");
+            json_param_str("isa", md5_isa_name(isa));
+            json_param_int("lanes", md5_isa_lanes(isa));
+            json_param_int("len", scan.len);
+            snprintf(label, sizeof(label), "varredura %s, %d bytes", md5_isa_name(isa), scan.len);
+            json_end(&stats, label);
+        }
+    }
+
+    // Enumeração e busca completa por comprimento e tamanho de charset
+    static const struct {
+        const char *name;
+        const char *charset;
+    } charsets[] = {
+        {"digits", "0123456789"},
+        {"lower", "abcdefghijklmnopqrstuvwxyz"},
+        {"alnum", "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789"},
+    };
+    static const int lengths[] = {4, 6, 8};
+    int num_charsets = config.quick ? 2 : (int)(sizeof(charsets) / sizeof(charsets[0]));
+    int num_lengths = config.quick ? 2 : (int)(sizeof(lengths) / sizeof(lengths[0]));
+
+    fprintf(stderr, "\nEnumeração (sem MD5):\n");
+    for (int c = 0; c < num_charsets; c++) {
+        EnumArg en;
+        keyspace_init_charset(&en.keyspace, charsets[c].charset, 8);
+        bench_repeat(run_enumerate, &en, bench_calibrate(run_enumerate, &en, config.seconds),
+                     config.reps, &stats);
+        json_begin("enumerate");
+        json_param_int("len", 8);
+        json_param_str("charset", charsets[c].name);
+        json_param_int("charset_size", (long long)strlen(charsets[c].charset));
+        snprintf(label, sizeof(label), "enumerador, 8 x %s", charsets[c].name);
+        json_end(&stats, label);
+    }
+
+    fprintf(stderr, "\nBusca ponta a ponta (fila dinâmica, até %d workers):\n", config.max_workers);
+    for (int c = 0; c < num_charsets; c++) {
+        for (int l = 0; l < num_lengths; l++) {
+            bench_scaling(&config, shared, charsets[c].name, charsets[c].charset, lengths[l]);
+        }
+    }
+
+    fprintf(json, "\n  ]\n}\n");
+    if (json != stdout) {
+        fclose(json);
+        fprintf(stderr, "\nResultados gravados em %s\n", output_path);
+    }
+    shared_state_destroy(shared, shm_fd);
+
+    if (baseline_out != NULL) {
+        fclose(baseline_out);
+        fprintf(stderr, "Linha de base gravada em %s\n", save_path);
+    }
+    if (baseline_path != NULL) {
+        fprintf(stderr, "\nLinha de base %s: %d medidas comparadas, %d regressões "
+                "(tolerância de %.0f%%)\n", baseline_path, baseline_compared,
+                baseline_regressions, baseline_tolerance);
+        return baseline_regressions > 0 ? 2 : 0;
+    }
+    return 0;
+}
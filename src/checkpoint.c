@@ -0,0 +1,372 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include "checkpoint.h"
+#include "hash_utils.h"
+#include "rules.h"
+
+void checkpoint_job_id(const SharedState *shared, const char *target, const char *wordlist_path,
+                       KeyspaceIndex total, char job_id[33]) {
+    char *buffer = NULL;
+    size_t size = 0;
+    FILE *desc = open_memstream(&buffer, &size);
+    if (desc == NULL) {
+        perror("open_memstream");
+        job_id[0] = '\0';
+        return;
+    }
+
+    char total_str[KEYSPACE_INDEX_STR];
+    fprintf(desc, "alvo %s\nlista %d\ntotal %s\n", target, shared->targets_offset != 0,
+            keyspace_index_str(total, total_str));
+    if (wordlist_path != NULL) {
+        fprintf(desc, "wordlist %s\n", wordlist_path);
+    }
+    for (int i = 0; i < shared->keyspace.length; i++) {
+        fprintf(desc, "posicao %d ", i);
+        fwrite(shared->keyspace.sets[i], 1, shared->keyspace.set_len[i], desc);
+        fputc('\n', desc);
+    }
+    if (shared->keyspace.order.enabled) {
+        // A ordem dos charsets já aparece acima; os níveis mudam os índices
+        fputs("markov", desc);
+        for (int i = 0; i < shared->keyspace.length; i++) {
+            for (int l = 0; l < KEYSPACE_LEVELS; l++) {
+                fprintf(desc, "%c%d", l == 0 ? ' ' : ',', shared->keyspace.order.level_end[i][l]);
+            }
+        }
+        fputc('\n', desc);
+    }
+    if (shared->keyspace.prefix_len > 0) {
+        fputs("prefixo ", desc);
+        fwrite(shared->keyspace.prefix, 1, shared->keyspace.prefix_len, desc);
+        fputc('\n', desc);
+    }
+    if (shared->keyspace.suffix_len > 0) {
+        fputs("sufixo ", desc);
+        fwrite(shared->keyspace.suffix, 1, shared->keyspace.suffix_len, desc);
+        fputc('\n', desc);
+    }
+    const Rule *rules = rules_from_shared(shared);
+    for (int r = 0; r < shared->num_rules; r++) {
+        fputs("regra", desc);
+        for (int k = 0; k < rules[r].count; k++) {
+            fprintf(desc, " %c%u,%u", rules[r].ops[k].op, rules[r].ops[k].arg1, rules[r].ops[k].arg2);
+        }
+        fputc('\n', desc);
+    }
+    fclose(desc);
+
+    uint32_t state[4];
+    md5_bytes(buffer, size, state);
+    md5_state_to_hex(state, job_id);
+    free(buffer);
+}
+
+static int compare_ranges(const void *a, const void *b) {
+    const IndexRange *x = a, *y = b;
+    return (x->start > y->start) - (x->start < y->start);
+}
+
+int checkpoint_write(const char *path, const char *job_id, SharedState *shared,
+                     KeyspaceIndex total) {
+    WorkerProgress *progress = shared_state_progress(shared);
+    const IndexRange *queue = shared_state_ranges(shared);
+    int num_queue = queue != NULL ? shared->num_ranges : 1;
+    IndexRange *pending = malloc((shared->num_workers + num_queue) * sizeof(IndexRange));
+    int n = 0;
+
+    if (pending == NULL) {
+        perror("malloc");
+        return -1;
+    }
+
+    // O que ainda está na fila. next_index é lido antes do progresso dos
+    // workers: um bloco reivindicado depois desta leitura continua aqui
+    if (shared->dynamic) {
+        long long next = atomic_load(&shared->next_index);
+        for (int i = 0; i < num_queue; i++) {
+            IndexRange range = queue != NULL ? queue[i] : (IndexRange){0, shared->total, 0};
+            KeyspaceIndex claimed = shared_state_range_claimed(shared, &range, next);
+            if (claimed < range.count) {
+                pending[n++] = (IndexRange){range.start + claimed, range.count - claimed, 0};
+            }
+        }
+        atomic_thread_fence(memory_order_seq_cst);
+    }
+
+    // O que cada worker tem em andamento
+    for (int i = 0; progress != NULL && i < shared->num_workers; i++) {
+        KeyspaceIndex start, end, next;
+        if (atomic_load(&progress[i].claiming) ||
+            !worker_progress_read(&progress[i], &start, &end, &next)) {
+            free(pending);
+            return 1;
+        }
+        if (next < end) {
+            pending[n++] = (IndexRange){next, end - next, 0};
+        }
+    }
+    qsort(pending, n, sizeof(IndexRange), compare_ranges);
+
+    char tmp_path[4096];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+    FILE *file = fopen(tmp_path, "w");
+    if (file == NULL) {
+        perror(tmp_path);
+        free(pending);
+        return -1;
+    }
+
+    fprintf(file, "# Checkpoint do quebra-senhas (retomar com --resume)\n");
+    char a[KEYSPACE_INDEX_STR], b[KEYSPACE_INDEX_STR];
+    fprintf(file, "trabalho %s\ntotal %s\n", job_id, keyspace_index_str(total, a));
+
+    // Feito = complemento do que está pendente
+    KeyspaceIndex cursor = 0;
+    for (int i = 0; i < n; i++) {
+        if (pending[i].start > cursor) {
+            fprintf(file, "feito %s %s\n", keyspace_index_str(cursor, a),
+                    keyspace_index_str(pending[i].start - cursor, b));
+        }
+        if (pending[i].start + pending[i].count > cursor) {
+            cursor = pending[i].start + pending[i].count;
+        }
+    }
+    if (cursor < total) {
+        fprintf(file, "feito %s %s\n", keyspace_index_str(cursor, a),
+                keyspace_index_str(total - cursor, b));
+    }
+    free(pending);
+
+    TargetSet *targets = target_set_from_shared(shared);
+    for (int i = 0; targets != NULL && i < targets->count; i++) {
+        TargetEntry *entry = target_set_entry(targets, i);
+        int winner = atomic_load_explicit(&entry->winner, memory_order_acquire);
+        if (winner >= 0) {
+            char hash[33];
+            md5_state_to_hex(entry->state, hash);
+            fprintf(file, "quebrado %s %d %s\n", hash, winner, entry->password);
+        }
+    }
+
+    // Só substitui o checkpoint anterior depois que o novo está no disco
+    if (fflush(file) != 0 || fsync(fileno(file)) != 0) {
+        perror(tmp_path);
+        fclose(file);
+        unlink(tmp_path);
+        return -1;
+    }
+    fclose(file);
+    if (rename(tmp_path, path) != 0) {
+        perror("rename");
+        unlink(tmp_path);
+        return -1;
+    }
+    return 0;
+}
+
+int checkpoint_load(const char *path, Checkpoint *ckpt) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return -1;
+    }
+
+    memset(ckpt, 0, sizeof(*ckpt));
+    ckpt->total = -1;
+    int done_capacity = 0, cracked_capacity = 0, valid = 1;
+    char line[256];
+
+    while (valid && fgets(line, sizeof(line), file) != NULL) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0' || line[0] == '#') {
+            continue;
+        }
+
+        KeyspaceIndex start, count;
+        char hash[33];
+        int worker_id, pos;
+        if (sscanf(line, "trabalho %32s", ckpt->job_id) == 1) {
+            continue;
+        }
+        if (strncmp(line, "total ", 6) == 0) {
+            valid = keyspace_index_parse(line + 6, &ckpt->total) != NULL;
+            continue;
+        }
+        if (strncmp(line, "feito ", 6) == 0) {
+            const char *p = keyspace_index_parse(line + 6, &start);
+            p = p != NULL ? keyspace_index_parse(p, &count) : NULL;
+            if (p == NULL || *p != '\0') {
+                valid = 0;
+                break;
+            }
+            // Gravados em ordem e sem sobreposição
+            KeyspaceIndex prev_end = ckpt->num_done > 0 ?
+                ckpt->done[ckpt->num_done - 1].start + ckpt->done[ckpt->num_done - 1].count : 0;
+            if (start < prev_end || count <= 0) {
+                valid = 0;
+                break;
+            }
+            if (ckpt->num_done == done_capacity) {
+                done_capacity = done_capacity ? done_capacity * 2 : 16;
+                IndexRange *grown = realloc(ckpt->done, done_capacity * sizeof(IndexRange));
+                if (grown == NULL) {
+                    valid = 0;
+                    break;
+                }
+                ckpt->done = grown;
+            }
+            ckpt->done[ckpt->num_done++] = (IndexRange){start, count, 0};
+            continue;
+        }
+        if (sscanf(line, "quebrado %32s %d%n", hash, &worker_id, &pos) == 2 && line[pos] == ' ') {
+            if (ckpt->num_cracked == cracked_capacity) {
+                cracked_capacity = cracked_capacity ? cracked_capacity * 2 : 16;
+                CheckpointCrack *grown = realloc(ckpt->cracked,
+                                                 cracked_capacity * sizeof(CheckpointCrack));
+                if (grown == NULL) {
+                    valid = 0;
+                    break;
+                }
+                ckpt->cracked = grown;
+            }
+            CheckpointCrack *crack = &ckpt->cracked[ckpt->num_cracked];
+            if (md5_hex_to_state(hash, crack->state) != 0) {
+                valid = 0;
+                break;
+            }
+            crack->worker_id = worker_id;
+            snprintf(crack->password, sizeof(crack->password), "%s", line + pos + 1);
+            ckpt->num_cracked++;
+            continue;
+        }
+        valid = 0;
+    }
+    fclose(file);
+
+    if (valid && ckpt->num_done > 0) {
+        const IndexRange *last = &ckpt->done[ckpt->num_done - 1];
+        valid = last->start + last->count <= ckpt->total;
+    }
+    if (!valid || ckpt->job_id[0] == '\0' || ckpt->total < 0) {
+        checkpoint_free(ckpt);
+        errno = EINVAL;
+        return -1;
+    }
+    return 0;
+}
+
+void checkpoint_free(Checkpoint *ckpt) {
+    free(ckpt->done);
+    free(ckpt->cracked);
+    ckpt->done = NULL;
+    ckpt->cracked = NULL;
+    ckpt->num_done = ckpt->num_cracked = 0;
+}
+
+int checkpoint_remaining(const Checkpoint *ckpt, IndexRange *ranges, KeyspaceIndex *remaining) {
+    KeyspaceIndex cursor = 0, sum = 0;
+    int n = 0;
+
+    for (int i = 0; i < ckpt->num_done; i++) {
+        if (ckpt->done[i].start > cursor) {
+            ranges[n++] = (IndexRange){cursor, ckpt->done[i].start - cursor, 0};
+            sum += ckpt->done[i].start - cursor;
+        }
+        cursor = ckpt->done[i].start + ckpt->done[i].count;
+    }
+    if (cursor < ckpt->total) {
+        ranges[n++] = (IndexRange){cursor, ckpt->total - cursor, 0};
+        sum += ckpt->total - cursor;
+    }
+
+    *remaining = sum;
+    return n;
+}
+
+int checkpoint_restore_targets(const Checkpoint *ckpt, TargetSet *targets) {
+    int restored = 0;
+    for (int i = 0; i < ckpt->num_cracked; i++) {
+        int index = target_set_lookup(targets, ckpt->cracked[i].state);
+        if (index >= 0 && target_set_publish(targets, index, ckpt->cracked[i].worker_id,
+                                             ckpt->cracked[i].password)) {
+            restored++;
+        }
+    }
+    return restored;
+}
+
+/**
+ * Grava o checkpoint; se um worker estava reivindicando um bloco, tenta de
+ * novo logo depois (a janela dura nanossegundos)
+ */
+static void writer_flush(CheckpointWriter *writer) {
+    const struct timespec pause = {0, 1000000};
+    for (int tries = 0; tries < 100; tries++) {
+        if (checkpoint_write(writer->path, writer->job_id, writer->shared, writer->total) != 1) {
+            return;
+        }
+        nanosleep(&pause, NULL);
+    }
+}
+
+static void *writer_main(void *arg) {
+    CheckpointWriter *writer = arg;
+
+    pthread_mutex_lock(&writer->lock);
+    while (!writer->stop) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += CHECKPOINT_INTERVAL;
+        while (!writer->stop &&
+               pthread_cond_timedwait(&writer->wake, &writer->lock, &deadline) != ETIMEDOUT) {
+        }
+        if (writer->stop) {
+            break;
+        }
+
+        pthread_mutex_unlock(&writer->lock);
+        writer_flush(writer);
+        pthread_mutex_lock(&writer->lock);
+    }
+    pthread_mutex_unlock(&writer->lock);
+    return NULL;
+}
+
+int checkpoint_writer_start(CheckpointWriter *writer, const char *path, const char *job_id,
+                            SharedState *shared, KeyspaceIndex total) {
+    writer->stop = 0;
+    writer->path = path;
+    snprintf(writer->job_id, sizeof(writer->job_id), "%s", job_id);
+    writer->shared = shared;
+    writer->total = total;
+    pthread_mutex_init(&writer->lock, NULL);
+    pthread_cond_init(&writer->wake, NULL);
+
+    if (pthread_create(&writer->thread, NULL, writer_main, writer) != 0) {
+        perror("pthread_create");
+        pthread_cond_destroy(&writer->wake);
+        pthread_mutex_destroy(&writer->lock);
+        return -1;
+    }
+    return 0;
+}
+
+void checkpoint_writer_stop(CheckpointWriter *writer, int keep) {
+    pthread_mutex_lock(&writer->lock);
+    writer->stop = 1;
+    pthread_cond_signal(&writer->wake);
+    pthread_mutex_unlock(&writer->lock);
+    pthread_join(writer->thread, NULL);
+    pthread_cond_destroy(&writer->wake);
+    pthread_mutex_destroy(&writer->lock);
+
+    if (keep) {
+        writer_flush(writer);
+    } else {
+        unlink(writer->path);
+    }
+}
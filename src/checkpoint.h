@@ -0,0 +1,125 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include "shared_state.h"
+#include "target_set.h"
+
+/**
+ * Checkpoint de buscas longas (--resume)
+ *
+ * A cada CHECKPOINT_INTERVAL segundos o coordinator lê o progresso que cada
+ * worker publica na página compartilhada (uma store relaxed por lote, na linha
+ * de cache do próprio worker) e grava os intervalos de índices já verificados
+ * num arquivo pequeno, de forma atômica (arquivo temporário + fsync + rename).
+ * Nada disso passa pelo laço quente além daquela store.
+ *
+ * Formato (texto, uma entrada por linha):
+ *   trabalho <id>          MD5 dos parâmetros: alvo, espaço de busca, regras
+ *   total <n>              Tamanho do espaço de busca
+ *   feito <início> <n>     Intervalo já verificado
+ *   quebrado <hash> <worker> <senha>   Alvo da lista já quebrado (--list)
+ *
+ * Com --resume o coordinator monta a fila só com o complemento dos
+ * intervalos feitos. O número de workers pode mudar entre execuções.
+ */
+
+#define CHECKPOINT_FILE "checkpoint.txt"
+#define CHECKPOINT_INTERVAL 5  // Segundos entre gravações
+
+/**
+ * Alvo da lista já quebrado numa execução anterior
+ */
+typedef struct {
+    uint32_t state[4];
+    int worker_id;
+    char password[SHARED_PASSWORD_MAX];
+} CheckpointCrack;
+
+/**
+ * Conteúdo de um arquivo de checkpoint
+ */
+typedef struct {
+    char job_id[33];
+    KeyspaceIndex total;
+    IndexRange *done;           // Ordenados e sem sobreposição
+    int num_done;
+    CheckpointCrack *cracked;
+    int num_cracked;
+} Checkpoint;
+
+/**
+ * Gravação periódica numa thread do coordinator (serve aos dois motores)
+ */
+typedef struct {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    int stop;
+    const char *path;
+    char job_id[33];
+    SharedState *shared;
+    KeyspaceIndex total;        // Espaço de busca real (shared->total é o da fila)
+} CheckpointWriter;
+
+/**
+ * Identificador do trabalho: MD5 do alvo e de tudo o que define os índices
+ * (charset de cada posição ou wordlist, regras e tamanho total)
+ * Deve ser calculado com a página já preenchida.
+ */
+void checkpoint_job_id(const SharedState *shared, const char *target, const char *wordlist_path,
+                       KeyspaceIndex total, char job_id[33]);
+
+/**
+ * Grava o progresso atual de forma atômica
+ *
+ * @return 0 em caso de sucesso, 1 se um worker estava no meio de uma
+ *         reivindicação (tentar de novo depois), -1 em erro de E/S
+ */
+int checkpoint_write(const char *path, const char *job_id, SharedState *shared,
+                     KeyspaceIndex total);
+
+/**
+ * Lê um arquivo de checkpoint
+ *
+ * @return 0 em caso de sucesso, -1 se não existe ou está corrompido
+ */
+int checkpoint_load(const char *path, Checkpoint *ckpt);
+
+void checkpoint_free(Checkpoint *ckpt);
+
+/**
+ * Intervalos ainda não verificados (complemento de ckpt->done em [0, total));
+ * os deslocamentos da fila vêm de shared_state_set_queue()
+ *
+ * @param ranges Saída, com espaço para ckpt->num_done + 1 intervalos
+ * @param remaining Saída: soma dos intervalos
+ * @return Número de intervalos
+ */
+int checkpoint_remaining(const Checkpoint *ckpt, IndexRange *ranges, KeyspaceIndex *remaining);
+
+/**
+ * Marca no conjunto de alvos os hashes quebrados antes
+ *
+ * @return Quantos alvos foram restaurados
+ */
+int checkpoint_restore_targets(const Checkpoint *ckpt, TargetSet *targets);
+
+/**
+ * Inicia a thread que grava o checkpoint a cada CHECKPOINT_INTERVAL segundos
+ *
+ * @return 0 em caso de sucesso, -1 se a thread não pôde ser criada
+ */
+int checkpoint_writer_start(CheckpointWriter *writer, const char *path, const char *job_id,
+                            SharedState *shared, KeyspaceIndex total);
+
+/**
+ * Para a thread de gravação
+ *
+ * @param keep 1 para gravar um checkpoint final (busca interrompida), 0 para
+ *             apagar o arquivo (busca concluída)
+ */
+void checkpoint_writer_stop(CheckpointWriter *writer, int keep);
+
+#endif // CHECKPOINT_H
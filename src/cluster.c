@@ -0,0 +1,769 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include "cluster.h"
+#include "hash_utils.h"
+#include "keyspace.h"
+#include "search.h"
+
+#define PROGRESS_REPORT_SECONDS 5
+
+/**
+ * Leitura de linhas de um socket, com buffer próprio
+ */
+typedef struct {
+    int fd;
+    size_t len;
+    char buf[CLUSTER_LINE_MAX];
+} LineReader;
+
+/**
+ * Extrai a próxima linha completa do buffer, sem o '\n'
+ *
+ * @return 1 se havia uma linha, 0 caso contrário
+ */
+static int reader_take(LineReader *r, char *line) {
+    char *newline = memchr(r->buf, '\n', r->len);
+    if (newline == NULL) {
+        return 0;
+    }
+    size_t n = newline - r->buf;
+    memcpy(line, r->buf, n);
+    line[n] = '\0';
+    r->len -= n + 1;
+    memmove(r->buf, newline + 1, r->len);
+    return 1;
+}
+
+/**
+ * Lê o que houver no socket para o buffer (uma chamada a recv)
+ *
+ * @return Bytes lidos; 0 se a conexão fechou ou a linha não cabe no buffer
+ */
+static ssize_t reader_fill(LineReader *r) {
+    if (r->len == sizeof(r->buf)) {
+        return 0;  // Linha maior que CLUSTER_LINE_MAX: protocolo violado
+    }
+    ssize_t n;
+    do {
+        n = recv(r->fd, r->buf + r->len, sizeof(r->buf) - r->len, 0);
+    } while (n < 0 && errno == EINTR);
+    if (n > 0) {
+        r->len += n;
+    }
+    return n < 0 ? 0 : n;
+}
+
+/**
+ * Próxima linha, bloqueando até ela chegar
+ *
+ * @return 1 se leu uma linha, 0 se a conexão fechou
+ */
+static int reader_next(LineReader *r, char *line) {
+    while (!reader_take(r, line)) {
+        if (reader_fill(r) == 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * Envia uma mensagem (uma linha) inteira
+ *
+ * @return 0 em caso de sucesso, -1 se a conexão caiu
+ */
+static int send_line(int fd, const char *format, ...) {
+    char line[CLUSTER_LINE_MAX];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(line, sizeof(line) - 1, format, args);
+    va_end(args);
+    if (len < 0 || len >= (int)sizeof(line) - 1) {
+        return -1;
+    }
+    line[len++] = '\n';
+
+    for (int sent = 0; sent < len; ) {
+        ssize_t n = send(fd, line + sent, len - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return -1;
+        }
+        sent += n;
+    }
+    return 0;
+}
+
+static void hex_encode(const char *data, size_t len, char *out) {
+    static const char digits[] = "0123456789abcdef";
+    for (size_t i = 0; i < len; i++) {
+        out[2 * i] = digits[(uint8_t)data[i] >> 4];
+        out[2 * i + 1] = digits[(uint8_t)data[i] & 15];
+    }
+    out[2 * len] = '\0';
+}
+
+/**
+ * @return Bytes decodificados, ou -1 se o texto não é hex ou não cabe em max
+ */
+static int hex_decode(const char *hex, char *out, size_t max) {
+    size_t len = strlen(hex);
+    if (len % 2 != 0 || len / 2 > max) {
+        return -1;
+    }
+    for (size_t i = 0; i < len / 2; i++) {
+        unsigned int byte;
+        if (sscanf(hex + 2 * i, "%2x", &byte) != 1) {
+            return -1;
+        }
+        out[i] = (char)byte;
+    }
+    return (int)(len / 2);
+}
+
+/* ---------------------------------------------------------------------- */
+/* Servidor                                                               */
+/* ---------------------------------------------------------------------- */
+
+/**
+ * Um nó conectado (um worker remoto)
+ */
+typedef struct {
+    LineReader in;
+    int id;                     // Ordem de conexão; identifica o vencedor
+    KeyspaceIndex chunk_start;  // Bloco em andamento
+    KeyspaceIndex chunk_count;  // 0 = nenhum
+    long long waiting;          // CLAIM respondido com WAIT (tamanho pedido), ou 0
+    long long checked;
+} ClusterNode;
+
+typedef struct {
+    SharedState *shared;
+    uint32_t target_state[4];
+    ClusterNode *nodes;
+    int num_nodes;
+    int capacity;
+    IndexRange *returned;       // Blocos de nós que caíram, entregues primeiro
+    int num_returned;
+    int returned_capacity;
+    int next_id;
+    long long checked;
+    int finished;
+    int failed;                 // Sem memória: a busca parou incompleta
+} ClusterServer;
+
+int cluster_listen(int *port) {
+    int fd = socket(AF_INET6, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    int ipv6 = fd >= 0;
+    if (!ipv6) {
+        fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    }
+    if (fd < 0) {
+        perror("socket");
+        return -1;
+    }
+
+    int on = 1, off = 0;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+    struct sockaddr_storage addr;
+    socklen_t addr_len;
+    memset(&addr, 0, sizeof(addr));
+    if (ipv6) {
+        // Aceita IPv4 também (endereços mapeados)
+        setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &off, sizeof(off));
+        struct sockaddr_in6 *in6 = (struct sockaddr_in6 *)&addr;
+        in6->sin6_family = AF_INET6;
+        in6->sin6_addr = in6addr_any;
+        in6->sin6_port = htons(*port);
+        addr_len = sizeof(*in6);
+    } else {
+        struct sockaddr_in *in4 = (struct sockaddr_in *)&addr;
+        in4->sin_family = AF_INET;
+        in4->sin_addr.s_addr = htonl(INADDR_ANY);
+        in4->sin_port = htons(*port);
+        addr_len = sizeof(*in4);
+    }
+
+    if (bind(fd, (struct sockaddr *)&addr, addr_len) < 0 || listen(fd, 64) < 0 ||
+        getsockname(fd, (struct sockaddr *)&addr, &addr_len) < 0) {
+        perror("bind/listen");
+        close(fd);
+        return -1;
+    }
+    *port = ntohs(ipv6 ? ((struct sockaddr_in6 *)&addr)->sin6_port :
+                         ((struct sockaddr_in *)&addr)->sin_port);
+    return fd;
+}
+
+/**
+ * Nada na fila, nada devolvido e nenhum bloco em andamento
+ */
+static int server_exhausted(const ClusterServer *server) {
+    if (atomic_load(&server->shared->next_index) < server->shared->queue_size ||
+        server->num_returned > 0) {
+        return 0;
+    }
+    for (int i = 0; i < server->num_nodes; i++) {
+        if (server->nodes[i].chunk_count > 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * Responde a um CLAIM: primeiro os blocos devolvidos, depois a fila
+ */
+static void server_claim(ClusterServer *server, ClusterNode *node, long long want) {
+    KeyspaceIndex start, count;
+
+    node->waiting = 0;
+    if (server->num_returned > 0) {
+        IndexRange *range = &server->returned[server->num_returned - 1];
+        start = range->start;
+        count = range->count < want ? range->count : want;
+        range->start += count;
+        range->count -= count;
+        if (range->count == 0) {
+            server->num_returned--;
+        }
+    } else {
+        // O tamanho guiado da fila divide o que resta pelos nós conectados
+        server->shared->num_workers = server->num_nodes > 0 ? server->num_nodes : 1;
+        start = shared_state_claim(server->shared, want, &count);
+        if (start < 0) {
+            if (server_exhausted(server)) {
+                server->finished = 1;
+            } else {
+                // Outros nós ainda trabalham: se algum cair, o bloco vem para cá
+                node->waiting = want;
+                send_line(node->in.fd, "WAIT");
+            }
+            return;
+        }
+    }
+
+    node->chunk_start = start;
+    node->chunk_count = count;
+    char start_str[KEYSPACE_INDEX_STR], count_str[KEYSPACE_INDEX_STR];
+    send_line(node->in.fd, "CHUNK %s %s", keyspace_index_str(start, start_str),
+              keyspace_index_str(count, count_str));
+}
+
+/**
+ * Nó desconectado: o bloco em andamento volta para a fila
+ */
+static void server_drop(ClusterServer *server, ClusterNode *node) {
+    if (node->chunk_count > 0 && server->num_returned == server->returned_capacity) {
+        int capacity = server->returned_capacity ? server->returned_capacity * 2 : 16;
+        IndexRange *returned = realloc(server->returned, capacity * sizeof(IndexRange));
+        if (returned == NULL) {
+            // Sem onde guardar o bloco, a busca não pode mais terminar completa
+            perror("realloc");
+            server->failed = 1;
+            server->finished = 1;
+        } else {
+            server->returned = returned;
+            server->returned_capacity = capacity;
+        }
+    }
+    if (node->chunk_count > 0 && !server->failed) {
+        server->returned[server->num_returned++] =
+            (IndexRange){node->chunk_start, node->chunk_count, 0};
+        char start_str[KEYSPACE_INDEX_STR], count_str[KEYSPACE_INDEX_STR];
+        printf("Nó %d desconectou - bloco %s (+%s) volta para a fila\n", node->id,
+               keyspace_index_str(node->chunk_start, start_str),
+               keyspace_index_str(node->chunk_count, count_str));
+    } else {
+        printf("Nó %d desconectou\n", node->id);
+    }
+    fflush(stdout);
+    close(node->in.fd);
+    node->in.fd = -1;
+    node->chunk_count = 0;
+}
+
+/**
+ * Trata uma mensagem de um nó
+ *
+ * @return 0 para manter a conexão, -1 para encerrá-la (protocolo violado)
+ */
+static int server_handle(ClusterServer *server, ClusterNode *node, const char *line,
+                         time_t start_time) {
+    long long value;
+    char hex[2 * SHARED_PASSWORD_MAX + 1];
+
+    if (sscanf(line, "CLAIM %lld", &value) == 1 && value > 0) {
+        if (node->chunk_count > 0) {
+            return -1;
+        }
+        server_claim(server, node, value);
+    } else if (sscanf(line, "DONE %lld", &value) == 1) {
+        // Só o dono de um bloco o encerra; um DONE avulso inflaria checked e
+        // poderia dar a busca por terminada antes da hora
+        if (node->chunk_count == 0 || value < 0 || value > node->chunk_count) {
+            return -1;
+        }
+        node->checked += value;
+        server->checked += value;
+        node->chunk_count = 0;
+        if (server_exhausted(server)) {
+            server->finished = 1;
+        }
+    } else if (sscanf(line, "FOUND %128s", hex) == 1) {
+        // O servidor confere o acerto antes de parar todos os nós
+        char password[SHARED_PASSWORD_MAX];
+        int len = hex_decode(hex, password, SHARED_PASSWORD_MAX - 1);
+        uint32_t state[4];
+        if (len < 0) {
+            return -1;
+        }
+        password[len] = '\0';
+        // O hash é o da mensagem inteira: prefixo || senha || sufixo
+        const Keyspace *ks = &server->shared->keyspace;
+        char candidate[KEYSPACE_PREFIX_MAX + SHARED_PASSWORD_MAX + KEYSPACE_SUFFIX_MAX];
+        memcpy(candidate, ks->prefix, ks->prefix_len);
+        memcpy(candidate + ks->prefix_len, password, len);
+        memcpy(candidate + ks->prefix_len + len, ks->suffix, ks->suffix_len);
+        md5_bytes(candidate, ks->prefix_len + len + ks->suffix_len, state);
+        if (!md5_state_equal(state, server->target_state)) {
+            printf("Nó %d relatou uma senha que não corresponde ao hash - ignorada\n", node->id);
+            return -1;
+        }
+        if (shared_state_publish(server->shared, node->id, password)) {
+            printf("Senha encontrada pelo nó %d após %.0f segundos - parando todos os nós\n",
+                   node->id, difftime(time(NULL), start_time));
+        }
+        server->finished = 1;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Novo nó: recebe a descrição do trabalho
+ */
+static void server_accept(ClusterServer *server, int listen_fd, const char *target_hash) {
+    int fd = accept4(listen_fd, NULL, NULL, SOCK_CLOEXEC);
+    if (fd < 0) {
+        return;
+    }
+    int on = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+
+    if (server->num_nodes == server->capacity) {
+        int capacity = server->capacity ? server->capacity * 2 : 16;
+        ClusterNode *nodes = realloc(server->nodes, capacity * sizeof(ClusterNode));
+        if (nodes == NULL) {
+            // Os nós já conectados seguem; este fica de fora
+            perror("realloc");
+            close(fd);
+            return;
+        }
+        server->nodes = nodes;
+        server->capacity = capacity;
+    }
+    ClusterNode *node = &server->nodes[server->num_nodes++];
+    memset(node, 0, sizeof(*node));
+    node->in.fd = fd;
+    node->id = server->next_id++;
+
+    const Keyspace *ks = &server->shared->keyspace;
+    char hex[2 * KEYSPACE_PREFIX_MAX + 1];  // O maior campo: SET e SUFFIX cabem
+    int failed = send_line(fd, "JOB %s %d", target_hash, ks->length);
+    for (int i = 0; i < ks->length && !failed; i++) {
+        hex_encode(ks->sets[i], ks->set_len[i], hex);
+        failed = send_line(fd, "SET %s", hex);
+    }
+    for (int i = 0; i < ks->length && ks->order.enabled && !failed; i++) {
+        char levels[KEYSPACE_LEVELS * 6 + 1];
+        int n = 0;
+        for (int l = 0; l < KEYSPACE_LEVELS; l++) {
+            n += snprintf(levels + n, sizeof(levels) - n, " %d", ks->order.level_end[i][l]);
+        }
+        failed = send_line(fd, "LEVELS %d%s", i, levels);
+    }
+    if (ks->prefix_len > 0 && !failed) {
+        hex_encode(ks->prefix, ks->prefix_len, hex);
+        failed = send_line(fd, "PREFIX %s", hex);
+    }
+    if (ks->suffix_len > 0 && !failed) {
+        hex_encode(ks->suffix, ks->suffix_len, hex);
+        failed = send_line(fd, "SUFFIX %s", hex);
+    }
+    if (failed || send_line(fd, "GO") != 0) {
+        server_drop(server, node);
+        return;
+    }
+    printf("Nó %d conectado (%d nós)\n", node->id, server->num_nodes);
+    fflush(stdout);
+}
+
+int cluster_serve(int listen_fd, SharedState *shared, const char *target_hash, time_t start_time) {
+    ClusterServer server;
+    memset(&server, 0, sizeof(server));
+    server.shared = shared;
+    if (md5_hex_to_state(target_hash, server.target_state) != 0) {
+        printf("Hash alvo inválido - nenhuma senha pode corresponder\n");
+        return 0;
+    }
+
+    time_t last_report = time(NULL);
+    struct pollfd *fds = NULL;
+    int fds_capacity = 0;
+
+    while (!server.finished) {
+        if (fds_capacity < server.num_nodes + 1) {
+            int capacity = (server.num_nodes + 1) * 2;
+            struct pollfd *grown = realloc(fds, capacity * sizeof(struct pollfd));
+            if (grown == NULL) {
+                perror("realloc");
+                server.failed = 1;
+                break;
+            }
+            fds = grown;
+            fds_capacity = capacity;
+        }
+        fds[0] = (struct pollfd){listen_fd, POLLIN, 0};
+        for (int i = 0; i < server.num_nodes; i++) {
+            fds[i + 1] = (struct pollfd){server.nodes[i].in.fd, POLLIN, 0};
+        }
+
+        int ready = poll(fds, server.num_nodes + 1, 1000);
+        if (ready < 0 && errno != EINTR) {
+            perror("poll");
+            break;
+        }
+
+        // Mensagens dos nós já conectados (antes de aceitar: os índices batem com fds)
+        for (int i = 0; ready > 0 && i < server.num_nodes && !server.finished; i++) {
+            ClusterNode *node = &server.nodes[i];
+            if (fds[i + 1].revents == 0) {
+                continue;
+            }
+            char line[CLUSTER_LINE_MAX];
+            int alive = reader_fill(&node->in) > 0;
+            while (alive && !server.finished && reader_take(&node->in, line)) {
+                alive = server_handle(&server, node, line, start_time) == 0;
+            }
+            if (!alive && !server.finished) {
+                server_drop(&server, node);
+            }
+        }
+
+        // Remove os nós desconectados e entrega a quem espera os blocos devolvidos
+        int kept = 0;
+        for (int i = 0; i < server.num_nodes; i++) {
+            if (server.nodes[i].in.fd >= 0) {
+                server.nodes[kept++] = server.nodes[i];
+            }
+        }
+        server.num_nodes = kept;
+        for (int i = 0; i < server.num_nodes && !server.finished; i++) {
+            if (server.nodes[i].waiting > 0 && server.num_returned > 0) {
+                server_claim(&server, &server.nodes[i], server.nodes[i].waiting);
+            }
+        }
+        if (!server.finished && server_exhausted(&server) && server.num_nodes > 0) {
+            server.finished = 1;
+        }
+
+        if (ready > 0 && (fds[0].revents & POLLIN) && !server.finished) {
+            server_accept(&server, listen_fd, target_hash);
+        }
+
+        if (difftime(time(NULL), last_report) >= PROGRESS_REPORT_SECONDS) {
+            last_report = time(NULL);
+            printf("Progresso: %lld senhas verificadas (%.1f%%), %d nós conectados\n",
+                   server.checked, 100.0 * server.checked / (double)shared->total,
+                   server.num_nodes);
+            fflush(stdout);
+        }
+    }
+
+    // Fim da busca: todos os nós param
+    for (int i = 0; i < server.num_nodes; i++) {
+        send_line(server.nodes[i].in.fd, "STOP");
+        close(server.nodes[i].in.fd);
+    }
+    printf("Servidor encerrado: %lld senhas verificadas por %d nós\n", server.checked,
+           server.next_id);
+    fflush(stdout);
+
+    free(fds);
+    free(server.nodes);
+    free(server.returned);
+    return server.failed ? -1 : 0;
+}
+
+/* ---------------------------------------------------------------------- */
+/* Worker remoto                                                          */
+/* ---------------------------------------------------------------------- */
+
+/**
+ * Conexão do worker remoto; uma thread lê as respostas e os avisos de parada
+ * enquanto a principal busca
+ */
+typedef struct {
+    LineReader in;
+    SharedState *shared;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    KeyspaceIndex chunk_start;
+    KeyspaceIndex chunk_count;  // 0 = nenhum bloco recebido
+    int stop;
+} ClusterLink;
+
+static void *link_reader(void *arg) {
+    ClusterLink *link = arg;
+    char line[CLUSTER_LINE_MAX];
+    KeyspaceIndex start, count;
+    const char *p;
+
+    while (reader_next(&link->in, line)) {
+        if (strncmp(line, "CHUNK ", 6) == 0 && (p = keyspace_index_parse(line + 6, &start)) &&
+            (p = keyspace_index_parse(p, &count)) && *p == '\0') {
+            pthread_mutex_lock(&link->lock);
+            link->chunk_start = start;
+            link->chunk_count = count;
+            pthread_cond_signal(&link->wake);
+            pthread_mutex_unlock(&link->lock);
+        } else if (strcmp(line, "STOP") == 0) {
+            break;
+        }
+        // WAIT: a resposta de verdade chega depois
+    }
+
+    // STOP ou conexão perdida: o laço de busca para no próximo lote
+    atomic_store_explicit(&link->shared->found, 1, memory_order_release);
+    pthread_mutex_lock(&link->lock);
+    link->stop = 1;
+    pthread_cond_signal(&link->wake);
+    pthread_mutex_unlock(&link->lock);
+    return NULL;
+}
+
+static int connect_to(const char *address) {
+    char host[256];
+    const char *colon = strrchr(address, ':');
+    if (colon == NULL || colon - address >= (long)sizeof(host)) {
+        fprintf(stderr, "Endereço inválido (use host:porta): %s\n", address);
+        return -1;
+    }
+    memcpy(host, address, colon - address);
+    host[colon - address] = '\0';
+
+    struct addrinfo hints, *results;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    int err = getaddrinfo(host, colon + 1, &hints, &results);
+    if (err != 0) {
+        fprintf(stderr, "%s: %s\n", address, gai_strerror(err));
+        return -1;
+    }
+
+    int fd = -1;
+    for (struct addrinfo *ai = results; ai != NULL && fd < 0; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC, ai->ai_protocol);
+        if (fd >= 0 && connect(fd, ai->ai_addr, ai->ai_addrlen) < 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(results);
+    if (fd < 0) {
+        perror(address);
+        return -1;
+    }
+
+    int on = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    return fd;
+}
+
+/**
+ * Recebe JOB, SET, LEVELS/PREFIX/SUFFIX (opcionais) e GO e monta o espaço de busca
+ *
+ * @return 0 em caso de sucesso, -1 se a descrição é inválida
+ */
+static int receive_job(LineReader *in, char *target_hash, Keyspace *ks) {
+    char line[CLUSTER_LINE_MAX];
+
+    if (!reader_next(in, line) || sscanf(line, "JOB %32s %d", target_hash, &ks->length) != 2 ||
+        ks->length < 1 || ks->length > MAX_PASSWORD_LEN) {
+        return -1;
+    }
+    for (int i = 0; i < ks->length; i++) {
+        if (!reader_next(in, line) || strncmp(line, "SET ", 4) != 0) {
+            return -1;
+        }
+        ks->set_len[i] = hex_decode(line + 4, ks->sets[i], KEYSPACE_SET_MAX);
+        if (ks->set_len[i] <= 0) {
+            return -1;
+        }
+        ks->sets[i][ks->set_len[i]] = '\0';
+    }
+    ks->prefix_len = 0;
+    ks->suffix_len = 0;
+    ks->order.enabled = 0;
+    int levels = 0;
+    while (reader_next(in, line)) {
+        if (strcmp(line, "GO") == 0) {
+            // O fim do prefixo, a senha e o sufixo precisam caber no último bloco
+            int last_block = keyspace_block_offset(ks) + ks->length + ks->suffix_len;
+            if (last_block > MD5_BLOCK_MAX_INPUT) {
+                return -1;
+            }
+            // Ordem Markov: um LEVELS por posição, com os charsets já reordenados
+            if (levels > 0 && (levels != ks->length || keyspace_order_prepare(ks) != 0)) {
+                return -1;
+            }
+            return 0;
+        } else if (strncmp(line, "LEVELS ", 7) == 0) {
+            // Posição e o fim de cada nível no charset dela
+            char *p = line + 7, *next;
+            if (strtol(p, &next, 10) != levels || next == p || levels >= ks->length ||
+                levels >= KEYSPACE_ORDER_MAX_LEN) {
+                return -1;
+            }
+            for (int l = 0; l < KEYSPACE_LEVELS; l++) {
+                p = next;
+                long end = strtol(p, &next, 10);
+                if (next == p || end < 0 || end > ks->set_len[levels]) {
+                    return -1;
+                }
+                ks->order.level_end[levels][l] = (short)end;
+            }
+            levels++;
+        } else if (strncmp(line, "PREFIX ", 7) == 0) {
+            ks->prefix_len = hex_decode(line + 7, ks->prefix, KEYSPACE_PREFIX_MAX);
+            if (ks->prefix_len < 0) {
+                return -1;
+            }
+        } else if (strncmp(line, "SUFFIX ", 7) == 0) {
+            ks->suffix_len = hex_decode(line + 7, ks->suffix, KEYSPACE_SUFFIX_MAX);
+            if (ks->suffix_len < 0) {
+                return -1;
+            }
+        } else {
+            return -1;
+        }
+    }
+    return -1;
+}
+
+int cluster_work(const char *address, int worker_id) {
+    ClusterLink link;
+    memset(&link, 0, sizeof(link));
+    link.in.fd = connect_to(address);
+    if (link.in.fd < 0) {
+        return -1;
+    }
+
+    char target_hash[33];
+    link.shared = shared_state_create_private();
+    if (link.shared == NULL || receive_job(&link.in, target_hash, &link.shared->keyspace) != 0) {
+        fprintf(stderr, "[Worker %d] Servidor %s não enviou um trabalho válido\n", worker_id,
+                address);
+        close(link.in.fd);
+        shared_state_destroy(link.shared, -1);
+        return -1;
+    }
+    shared_state_set_queue(link.shared, keyspace_size(&link.shared->keyspace));
+
+    SearchJob job;
+    SearchContext ctx;
+    if (search_job_init(&job, target_hash, &link.shared->keyspace) != 0) {
+        fprintf(stderr, "[Worker %d] Hash alvo inválido\n", worker_id);
+        close(link.in.fd);
+        shared_state_destroy(link.shared, -1);
+        return -1;
+    }
+    search_context_init(&ctx, &job, link.shared, worker_id);
+    printf("[Worker %d] Conectado a %s: %s, tamanho %d\n", worker_id, address, target_hash,
+           link.shared->keyspace.length);
+    fflush(stdout);
+
+    // report_found() avisa o "coordinator" com SIGUSR1; aqui ele é o próprio
+    // processo, e o aviso de verdade é a mensagem FOUND
+    signal(SIGUSR1, SIG_IGN);
+    pthread_mutex_init(&link.lock, NULL);
+    pthread_cond_init(&link.wake, NULL);
+    pthread_t reader;
+    if (pthread_create(&reader, NULL, link_reader, &link) != 0) {
+        perror("pthread_create");
+        close(link.in.fd);
+        shared_state_destroy(link.shared, -1);
+        return -1;
+    }
+
+    long long want = SCHED_CHUNK_MIN;
+    SearchStatus status = SEARCH_DONE;
+    while (send_line(link.in.fd, "CLAIM %lld", want) == 0) {
+        pthread_mutex_lock(&link.lock);
+        while (link.chunk_count == 0 && !link.stop) {
+            pthread_cond_wait(&link.wake, &link.lock);
+        }
+        KeyspaceIndex start = link.chunk_start, count = link.chunk_count;
+        link.chunk_count = 0;
+        int stop = link.stop;
+        pthread_mutex_unlock(&link.lock);
+        if (stop) {
+            status = SEARCH_STOPPED;
+            break;
+        }
+
+        long long checked_before = ctx.passwords_checked;
+        double chunk_start = monotonic_seconds();
+        ctx.chunks_claimed++;
+        status = search_range(&ctx, start, count);
+        if (status == SEARCH_FOUND) {
+            char hex[2 * SHARED_PASSWORD_MAX + 1];
+            hex_encode(link.shared->password, strlen(link.shared->password), hex);
+            send_line(link.in.fd, "FOUND %s", hex);
+            break;
+        }
+        if (status == SEARCH_STOPPED ||
+            send_line(link.in.fd, "DONE %lld", ctx.passwords_checked - checked_before) != 0) {
+            break;
+        }
+
+        // Blocos do tamanho da taxa medida, como na fila dinâmica local
+        double elapsed = monotonic_seconds() - chunk_start;
+        want = elapsed > 0 ? (long long)((double)count / elapsed * CLUSTER_CHUNK_SECONDS) :
+                             want * 2;
+        if (want < SCHED_CHUNK_MIN) want = SCHED_CHUNK_MIN;
+        if (want > CHUNK_MAX) want = CHUNK_MAX;
+    }
+
+    // Encerrar a conexão também acorda a thread de leitura
+    shutdown(link.in.fd, SHUT_RDWR);
+    pthread_join(reader, NULL);
+    close(link.in.fd);
+    pthread_cond_destroy(&link.wake);
+    pthread_mutex_destroy(&link.lock);
+
+    printf("[Worker %d] %s. %lld blocos, %lld senhas verificadas.\n", worker_id,
+           status == SEARCH_FOUND ? "Senha enviada ao servidor" :
+           status == SEARCH_STOPPED ? "Parado pelo servidor" : "Conexão encerrada",
+           ctx.chunks_claimed, ctx.passwords_checked);
+    shared_state_destroy(link.shared, -1);
+    return 0;
+}
@@ -0,0 +1,61 @@
+#ifndef CLUSTER_H
+#define CLUSTER_H
+
+#include <time.h>
+#include "shared_state.h"
+
+/**
+ * Modo distribuído: o coordinator (--server) entrega blocos do espaço de
+ * busca por TCP, e workers remotos (worker --connect, ou um coordinator
+ * --connect que cria vários deles) em qualquer número de máquinas os
+ * reivindicam, verificam e devolvem.
+ *
+ * Protocolo em texto, uma mensagem por linha:
+ *
+ *   servidor -> worker   JOB <hash> <tamanho>    ao conectar, seguido de uma
+ *                        SET <charset em hex>    linha SET por posição, das
+ *                        LEVELS <pos> <fins>     linhas opcionais LEVELS (uma
+ *                        PREFIX <texto em hex>   por posição, --markov), PREFIX
+ *                        SUFFIX <texto em hex>   e SUFFIX (--prefix, --suffix)
+ *                        GO                      e de GO
+ *                        CHUNK <início> <n>      resposta a CLAIM
+ *                        WAIT                    nada livre agora; o CHUNK vem
+ *                                                quando um nó cair ou STOP
+ *                        STOP                    senha encontrada ou espaço esgotado
+ *   worker -> servidor   CLAIM <n>               pede um bloco de até n índices
+ *                        DONE <n>                bloco concluído, n senhas verificadas
+ *                        FOUND <senha em hex>    acerto (conferido pelo servidor)
+ *
+ * Um bloco entregue fica associado à conexão até o DONE; se a conexão cair
+ * antes, ele volta para a fila e vai para o próximo nó que pedir.
+ */
+
+#define CLUSTER_CHUNK_SECONDS 0.5  // Duração alvo de um bloco remoto (a rede custa mais)
+#define CLUSTER_LINE_MAX 1024
+
+/**
+ * Abre a porta do servidor (0 = porta livre escolhida pelo sistema)
+ *
+ * @param port Saída: porta efetivamente usada
+ * @return Socket de escuta, ou -1 em caso de erro
+ */
+int cluster_listen(int *port);
+
+/**
+ * Servidor de blocos: atende os nós até a senha ser encontrada (publicada em
+ * shared, como fazem os workers locais) ou o espaço acabar
+ * Suporta hash único com charset ou máscara (shared->keyspace).
+ *
+ * @return 0 ao fim da busca, -1 em erro do servidor
+ */
+int cluster_serve(int listen_fd, SharedState *shared, const char *target_hash, time_t start_time);
+
+/**
+ * Worker remoto: conecta a "host:porta", recebe o trabalho e verifica blocos
+ * até receber STOP
+ *
+ * @return 0 ao fim, -1 se não foi possível conectar ou o servidor não respondeu
+ */
+int cluster_work(const char *address, int worker_id);
+
+#endif // CLUSTER_H
@@ -5,132 +5,1510 @@
 #include <sys/wait.h>
 #include <sys/types.h>
 #include <fcntl.h>
+#include <signal.h>
+#include <errno.h>
 #include <time.h>
+#include <getopt.h>
+#include <poll.h>
 #include "hash_utils.h"
+#include "shared_state.h"
+#include "keyspace.h"
+#include "search.h"
+#include "thread_engine.h"
+#include "target_set.h"
+#include "wordlist.h"
+#include "rules.h"
+#include "checkpoint.h"
+#include "telemetry.h"
+#include "rainbow.h"
+#include "potfile.h"
+#include "cluster.h"
+#include "pool.h"
+#include "markov.h"
+#include "topology.h"
 
 /**
  * PROCESSO COORDENADOR - Mini-Projeto 1: Quebra de Senhas Paralelo
  * 
  * Este programa coordena múltiplos workers para quebrar senhas MD5 em paralelo.
- * O MD5 JÁ ESTÁ IMPLEMENTADO - você deve focar na paralelização (fork/exec/wait).
+ * Cada worker é um processo criado com fork() + execl() que recebe uma parte do
+ * espaço de busca; o coordenador espera todos com wait() e lê o resultado.
  * 
- * Uso: ./coordinator <hash_md5> <tamanho> <charset> <num_workers>
+ * Uso: ./coordinator [opções] <hash_md5> <tamanho> <charset> <num_workers|auto>
+ *      ./coordinator [opções] --mask <máscara> <hash_md5> <num_workers|auto>
+ *      ./coordinator [opções] --wordlist <arquivo> <hash_md5> <num_workers|auto>
+ *      ./coordinator [opções] --rainbow <tabela> <hash_md5> <num_workers|auto>
+ *      ./coordinator [opções] --queue <arquivo|-> <num_workers|auto>
+ *      ./coordinator --connect <host:porta> <num_workers|auto>
  * 
  * Exemplo: ./coordinator "900150983cd24fb0d6963f7d28e17f72" 3 "abc" 4
  * 
- * SEU TRABALHO: Implementar os TODOs marcados abaixo
+ * Opções:
+ *   -s, --sched static|dynamic   Divisão fixa em intervalos contíguos (padrão) ou
+ *                                fila de blocos reivindicados pelos workers
+ *   -e, --engine processes|threads
+ *                                Um processo worker por fork() + execl() (padrão) ou
+ *                                um pool de threads fixadas às CPUs no próprio coordinator
+ *   -l, --list                   hash_md5 é um arquivo com um hash por linha: todos são
+ *                                procurados numa única passada pelo espaço de busca
+ *   -m, --mask MÁSCARA           Um charset por posição (ex.: ?u?l?l?l?d?d); substitui
+ *                                os argumentos tamanho e charset
+ *   -1 ... -4 CHARSET            Charsets personalizados ?1 a ?4 usados na máscara
+ *   -w, --wordlist ARQUIVO       Testa as linhas do arquivo (mapeado em memória, dividido
+ *                                em intervalos de bytes); substitui tamanho e charset
+ *   -r, --rules ARQUIVO          Regras no estilo do hashcat aplicadas a cada linha da
+ *                                wordlist (uma regra por linha do arquivo)
+ *   -c, --checkpoint ARQUIVO     Onde gravar o progresso (padrão: checkpoint.txt)
+ *       --resume                 Retoma do checkpoint: só os intervalos ainda não
+ *                                verificados entram na fila (escalonamento dinâmico)
+ *       --server PORTA           Entrega os blocos por TCP a nós remotos; num_workers
+ *                                (pode ser 0) workers locais se conectam pelo loopback
+ *       --connect HOST:PORTA     Nó remoto: cria num_workers workers que buscam os
+ *                                blocos do servidor
+ *       --rainbow TABELA         Procura o hash numa tabela rainbow (rainbow_gen) em vez
+ *                                de percorrer o espaço; o espaço vem da tabela
+ *       --status SEGUNDOS        Intervalo do relatório de progresso: taxa total e por
+ *                                worker, fração coberta, ETA e workers lentos
+ *                                (padrão: 5; 0 desliga)
+ *       --potfile ARQUIVO        Hashes já quebrados (padrão: password.pot): consultado
+ *                                antes de criar os workers, recebe cada senha nova
+ *       --no-potfile             Não consulta nem grava o potfile
+ *       --prefix TEXTO           Texto fixo antes da senha (sal: md5(sal || senha)); os
+ *                                blocos de 64 bytes inteiros são comprimidos uma só vez
+ *       --suffix TEXTO           Texto fixo depois da senha
+ *       --markov MODELO          Percorre o espaço dos candidatos mais prováveis aos menos
+ *                                prováveis, pelo modelo de markov_train (escalonamento
+ *                                dinâmico: os blocos saem em ordem de probabilidade)
+ *       --queue ARQUIVO|-        Lê trabalhos ("hash tamanho charset" ou "hash máscara",
+ *                                um por linha) do arquivo ou do stdin; os workers ficam
+ *                                vivos entre os trabalhos e cada um é informado ao terminar
+ *       --perf                   Cada worker mede a própria busca com contadores de
+ *                                hardware (perf_event_open) e mostra ciclos por senha,
+ *                                IPC, faltas de cache e ciclos parados ao terminar; sem
+ *                                contadores, só o tempo de CPU e as trocas de contexto
+ * 
+ * Com "auto" no lugar de num_workers, o número sai da topologia (topology.c):
+ * CPUs permitidas, núcleos físicos, cota do cgroup e, havendo SMT, uma
+ * calibração curta. Cada worker é fixado numa CPU, um por núcleo físico
+ * primeiro, e aloca os seus dados já no nó NUMA dela.
  */
 
-#define MAX_WORKERS 16
-#define RESULT_FILE "password_found.txt"
+#define MAX_WORKERS 4096  // Apenas um limite de sanidade; os vetores são alocados sob demanda
+
+// Sinalizado pelo worker vencedor (SIGUSR1) assim que publica o resultado
+static volatile sig_atomic_t result_signaled = 0;
+
+static void on_result_signal(int sig) {
+    (void)sig;
+    result_signaled = 1;
+}
 
 /**
- * Calcula o tamanho total do espaço de busca
- * 
- * @param charset_len Tamanho do conjunto de caracteres
- * @param password_len Comprimento da senha
- * @return Número total de combinações possíveis
+ * Grava o resultado no formato "worker_id:password"
+ * Os workers publicam na memória compartilhada; o arquivo continua existindo
+ * para quem consome o resultado fora do processo.
  */
-long long calculate_search_space(int charset_len, int password_len) {
-    long long total = 1;
-    for (int i = 0; i < password_len; i++) {
-        total *= charset_len;
+void save_result_file(int worker_id, const char *password) {
+    FILE *result = fopen(RESULT_FILE, "w");
+    if (result == NULL) {
+        perror("fopen");
+        return;
     }
-    return total;
+    fprintf(result, "%d:%s\n", worker_id, password);
+    fclose(result);
 }
 
 /**
- * Converte um índice numérico para uma senha
- * Usado para definir os limites de cada worker
+ * Fixa o worker recém-criado (antes do execl()) na CPU escolhida pelo auto
+ * A memória que ele tocar primeiro fica no nó NUMA dessa CPU.
+ *
+ * @param placement Topologia de num_workers = auto, ou NULL para não fixar
+ */
+static void place_worker(const Topology *placement, int worker) {
+    if (placement != NULL && placement->num_cpus > 0) {
+        topology_pin(topology_worker_cpu(placement, worker));
+    }
+}
+
+/**
+ * Número de workers do argv: um número, ou "auto" (topology_auto())
+ */
+static int parse_num_workers(const char *arg, Topology *topology) {
+    return strcmp(arg, "auto") == 0 ? topology_auto(topology) : atoi(arg);
+}
+
+void print_usage(const char *program) {
+    printf("Uso: %s [opções] <hash_md5> <tamanho> <charset> <num_workers>\n", program);
+    printf("     %s [opções] --mask <máscara> <hash_md5> <num_workers>\n", program);
+    printf("     %s [opções] --wordlist <arquivo> <hash_md5> <num_workers>\n", program);
+    printf("     %s [opções] --rainbow <tabela> <hash_md5> <num_workers>\n", program);
+    printf("     %s [opções] --queue <arquivo|-> <num_workers>\n", program);
+    printf("     %s --connect <host:porta> <num_workers>\n", program);
+    printf("Exemplo: %s 900150983cd24fb0d6963f7d28e17f72 3 abc 4\n", program);
+    printf("Opções:\n");
+    printf("  -s, --sched static|dynamic   Divisão fixa (padrão) ou fila de blocos dinâmica\n");
+    printf("  -e, --engine processes|threads\n");
+    printf("                               Processos worker (padrão) ou threads fixadas às CPUs\n");
+    printf("  -l, --list                   hash_md5 é um arquivo de hashes (um por linha)\n");
+    printf("  -m, --mask MÁSCARA           Um charset por posição: ?l ?u ?d ?s ?a ?1-?4 ou literal\n");
+    printf("  -1 ... -4 CHARSET            Charsets personalizados ?1 a ?4 da máscara\n");
+    printf("  -w, --wordlist ARQUIVO       Testa as linhas de um arquivo (dicionário)\n");
+    printf("  -r, --rules ARQUIVO          Regras (estilo hashcat) aplicadas a cada linha da wordlist\n");
+    printf("  -c, --checkpoint ARQUIVO     Progresso gravado a cada %d s (padrão: %s)\n",
+           CHECKPOINT_INTERVAL, CHECKPOINT_FILE);
+    printf("      --resume                 Continua a busca a partir do checkpoint\n");
+    printf("      --server PORTA           Servidor de blocos para nós remotos (TCP)\n");
+    printf("      --connect HOST:PORTA     Nó remoto de um servidor de blocos\n");
+    printf("      --rainbow TABELA         Busca numa tabela rainbow gerada por rainbow_gen\n");
+    printf("      --status SEGUNDOS        Intervalo do relatório de progresso (padrão: %d; 0 desliga)\n",
+           TELEMETRY_INTERVAL);
+    printf("      --potfile ARQUIVO        Hashes já quebrados, consultados antes da busca (padrão: %s)\n",
+           POTFILE_FILE);
+    printf("      --no-potfile             Ignora o potfile\n");
+    printf("      --prefix, --salt TEXTO   Texto fixo antes da senha: md5(prefixo || senha || sufixo)\n");
+    printf("      --suffix TEXTO           Texto fixo depois da senha\n");
+    printf("      --markov MODELO          Candidatos mais prováveis primeiro (modelo de markov_train)\n");
+    printf("      --queue ARQUIVO|-        Trabalhos \"hash tamanho charset\" ou \"hash máscara\" por linha\n");
+    printf("      --perf                   Contadores de hardware por worker (ciclos/senha, IPC)\n");
+    printf("  num_workers = auto           Pela topologia: núcleos físicos, SMT calibrado, cota do cgroup\n");
+}
+
+/**
+ * Motor de processos: um worker por fork() + execl(), aguardados com wait()
+ * Com wordlist_path, cada worker recebe um intervalo de bytes do arquivo em vez
+ * das senhas inicial e final.
  * 
- * @param index Índice numérico da senha
- * @param charset Conjunto de caracteres
- * @param charset_len Tamanho do conjunto
- * @param password_len Comprimento da senha
- * @param output Buffer para armazenar a senha gerada
+ * @param placement CPU de cada worker (auto), ou NULL
+ * @return 0 em caso de sucesso, 1 se não foi possível criar os workers ou se
+ *         algum terminou por um sinal ou com código diferente de 0 (o
+ *         intervalo dele pode não ter sido verificado)
+ */
+int run_process_engine(const char *target_hash, const char *charset, const char *wordlist_path,
+                       const WorkerRange *ranges, int num_workers, SharedState *shared,
+                       int shm_fd, time_t start_time, const Topology *placement) {
+    const Keyspace *keyspace = &shared->keyspace;
+    char shm_fd_str[16];
+    snprintf(shm_fd_str, sizeof(shm_fd_str), "%d", shm_fd);
+    
+    // Vetor para armazenar PIDs dos workers
+    pid_t *workers = malloc(num_workers * sizeof(pid_t));
+    if (workers == NULL) {
+        perror("malloc");
+        return 1;
+    }
+    
+    printf("Iniciando workers...\n");
+    fflush(stdout);  // Evita que o buffer seja duplicado nos filhos
+    
+    for (int i = 0; i < num_workers; i++) {
+        // Converter indices para senhas de inicio e fim, ou para bytes [início, fim)
+        // (no modo dinâmico o intervalo do argv é o espaço inteiro, só informativo)
+        KeyspaceIndex start_index = shared->dynamic ? 0 : ranges[i].start_index;
+        KeyspaceIndex end_index = shared->dynamic ? shared->total - 1 :
+                                  ranges[i].start_index + ranges[i].count - 1;
+        char start_password[MAX_PASSWORD_LEN + KEYSPACE_INDEX_STR];
+        char end_password[MAX_PASSWORD_LEN + KEYSPACE_INDEX_STR];
+        if (wordlist_path != NULL) {
+            keyspace_index_str(start_index, start_password);
+            keyspace_index_str(end_index + 1, end_password);
+        } else {
+            keyspace_index_to_password(keyspace, start_index, start_password);
+            keyspace_index_to_password(keyspace, end_index, end_password);
+        }
+        
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("fork");
+            // Aguarda os workers já criados antes de sair
+            for (int j = 0; j < i; j++) {
+                waitpid(workers[j], NULL, 0);
+            }
+            free(workers);
+            return 1;
+        }
+        
+        if (pid == 0) {
+            // Processo filho: substituir a imagem pelo worker
+            place_worker(placement, i);
+            char len_str[16], id_str[16];
+            snprintf(len_str, sizeof(len_str), "%d", keyspace->length);
+            snprintf(id_str, sizeof(id_str), "%d", i);
+            if (wordlist_path != NULL) {
+                execl("./worker", "worker", "--wordlist", wordlist_path, target_hash,
+                      start_password, end_password, id_str, shm_fd_str, (char *)NULL);
+            } else {
+                execl("./worker", "worker", target_hash, start_password, end_password,
+                      charset, len_str, id_str, shm_fd_str, (char *)NULL);
+            }
+            perror("execl");
+            _exit(1);
+        }
+        
+        // Processo pai: armazenar PID
+        workers[i] = pid;
+        if (shared->dynamic) {
+            printf("  Worker %d (PID %d): blocos dinâmicos\n", i, pid);
+        } else {
+            char count_str[KEYSPACE_INDEX_STR];
+            printf("  Worker %d (PID %d): %s%s até %s (%s %s)\n", i, pid,
+                   wordlist_path != NULL ? "bytes " : "", start_password, end_password,
+                   keyspace_index_str(ranges[i].count, count_str),
+                   wordlist_path != NULL ? "bytes" : "senhas");
+        }
+    }
+    
+    printf("\nTodos os workers foram iniciados. Aguardando conclusão...\n");
+    fflush(stdout);
+    
+    // Aguardar todos os workers terminarem (evita zumbis)
+    int finished = 0;
+    int announced = 0;
+    int abnormal = 0;
+    TargetSet *targets = target_set_from_shared(shared);
+    while (finished < num_workers) {
+        // Lista de alvos: cada aviso é um (ou mais) hash quebrado
+        if (result_signaled && targets != NULL) {
+            result_signaled = 0;
+            printf("Hashes quebrados: %d de %d após %.0f segundos\n",
+                   atomic_load(&targets->cracked), targets->count,
+                   difftime(time(NULL), start_time));
+            fflush(stdout);
+        }
+        
+        // Resultado publicado: anunciar já, sem esperar os demais workers
+        if (result_signaled && !announced &&
+            atomic_load_explicit(&shared->found, memory_order_acquire)) {
+            announced = 1;
+            printf("Senha encontrada pelo Worker %d após %.0f segundos - encerrando workers\n",
+                   atomic_load(&shared->winner), difftime(time(NULL), start_time));
+            fflush(stdout);
+        }
+        
+        int status;
+        pid_t pid = wait(&status);
+        if (pid < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("wait");
+            break;
+        }
+        
+        // Identificar qual worker terminou
+        int worker_id = -1;
+        for (int i = 0; i < num_workers; i++) {
+            if (workers[i] == pid) {
+                worker_id = i;
+                break;
+            }
+        }
+        
+        if (WIFEXITED(status)) {
+            printf("Worker %d (PID %d) terminou com código %d\n",
+                   worker_id, pid, WEXITSTATUS(status));
+            abnormal += WEXITSTATUS(status) != 0;
+        } else if (WIFSIGNALED(status)) {
+            printf("Worker %d (PID %d) terminou pelo sinal %d\n",
+                   worker_id, pid, WTERMSIG(status));
+            abnormal++;
+        }
+        finished++;
+    }
+    
+    free(workers);
+    if (abnormal > 0) {
+        printf("%d worker(s) terminaram antes de concluir o seu trabalho\n", abnormal);
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * Cria workers remotos (worker --connect) ligados ao servidor em address
+ *
+ * @param placement CPU de cada worker (auto), ou NULL
+ * @return PIDs dos workers criados (num_workers entradas), ou NULL em caso de erro
+ */
+pid_t *spawn_remote_workers(const char *address, int num_workers, const Topology *placement) {
+    pid_t *workers = calloc(num_workers + 1, sizeof(pid_t));
+    if (workers == NULL) {
+        perror("calloc");
+        return NULL;
+    }
+    
+    fflush(stdout);
+    for (int i = 0; i < num_workers; i++) {
+        char id_str[16];
+        snprintf(id_str, sizeof(id_str), "%d", i);
+        
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("fork");
+            for (int j = 0; j < i; j++) {
+                kill(workers[j], SIGTERM);
+                waitpid(workers[j], NULL, 0);
+            }
+            free(workers);
+            return NULL;
+        }
+        if (pid == 0) {
+            place_worker(placement, i);
+            execl("./worker", "worker", "--connect", address, id_str, (char *)NULL);
+            perror("execl");
+            _exit(1);
+        }
+        workers[i] = pid;
+    }
+    return workers;
+}
+
+/**
+ * Aguarda os workers remotos deste nó (evita zumbis)
+ */
+void wait_remote_workers(pid_t *workers, int num_workers) {
+    for (int finished = 0; finished < num_workers; ) {
+        int status;
+        pid_t pid = wait(&status);
+        if (pid < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("wait");
+            break;
+        }
+        for (int i = 0; i < num_workers; i++) {
+            if (workers[i] == pid && WIFEXITED(status)) {
+                printf("Worker %d (PID %d) terminou com código %d\n", i, pid, WEXITSTATUS(status));
+            }
+        }
+        finished++;
+    }
+}
+
+/**
+ * Modo servidor (--server): os blocos saem pela rede; os num_workers workers
+ * locais se conectam pelo loopback como qualquer outro nó
+ *
+ * @return 0 em caso de sucesso, 1 se a porta não pôde ser aberta ou se o
+ *         servidor parou antes de esgotar o espaço (falta de memória)
+ */
+int run_server(int port, const char *target_hash, int num_workers, SharedState *shared,
+               time_t start_time, const Topology *placement) {
+    int listen_fd = cluster_listen(&port);
+    if (listen_fd < 0) {
+        return 1;
+    }
+    printf("Servidor de blocos escutando na porta %d\n", port);
+    printf("Nós remotos: ./coordinator --connect <este_host>:%d <num_workers>\n\n", port);
+    
+    char address[32];
+    snprintf(address, sizeof(address), "127.0.0.1:%d", port);
+    pid_t *workers = spawn_remote_workers(address, num_workers, placement);
+    if (workers == NULL) {
+        close(listen_fd);
+        return 1;
+    }
+    
+    int failed = cluster_serve(listen_fd, shared, target_hash, start_time) != 0;
+    close(listen_fd);
+    wait_remote_workers(workers, num_workers);
+    free(workers);
+    return failed;
+}
+
+/**
+ * Nó remoto (--connect): só cria os workers; o trabalho vem do servidor
+ */
+int run_remote_node(const char *address, int num_workers, const Topology *placement) {
+    printf("=== Mini-Projeto 1: Quebra de Senhas Paralelo ===\n");
+    printf("Nó remoto do servidor %s\n", address);
+    printf("Número de workers: %d\n", num_workers);
+    if (placement != NULL) {
+        topology_print(placement);
+    }
+    printf("\n");
+    
+    pid_t *workers = spawn_remote_workers(address, num_workers, placement);
+    if (workers == NULL) {
+        return 1;
+    }
+    wait_remote_workers(workers, num_workers);
+    free(workers);
+    printf("\nServidor encerrou a busca (o resultado fica no servidor)\n");
+    return 0;
+}
+
+/**
+ * Tira da lista os hashes que o potfile já conhece e grava cada um no
+ * arquivo de resultado, como os workers fariam
+ *
+ * @return Quantos hashes saíram da lista
+ */
+int take_known_targets(const Potfile *pot, uint32_t (*states)[4], int *count) {
+    int kept = 0, known = 0;
+    for (int i = 0; i < *count; i++) {
+        char password[SHARED_PASSWORD_MAX];
+        if (pot == NULL || !potfile_lookup(pot, states[i], password, sizeof(password))) {
+            memmove(states[kept++], states[i], sizeof(states[i]));
+            continue;
+        }
+        char hash[33];
+        md5_state_to_hex(states[i], hash);
+        if (known++ == 0) {
+            printf("Já quebrados (potfile):\n");
+        }
+        printf("  %s  %s\n", hash, password);
+        append_result(hash, POTFILE_WORKER_ID, password);
+    }
+    if (known > 0) {
+        printf("\n");
+    }
+    *count = kept;
+    return known;
+}
+
+/**
+ * Confere se password gera o hash alvo
+ * Compara os estados brutos, então o hash pode vir em maiúsculas.
+ */
+static int hash_matches(const char *password, const char *target_hash) {
+    char computed_hash[33];
+    uint32_t computed[4], target[4];
+    md5_string(password, computed_hash);
+    return md5_hex_to_state(computed_hash, computed) == 0 &&
+           md5_hex_to_state(target_hash, target) == 0 && md5_state_equal(computed, target);
+}
+
+/**
+ * Hash único já quebrado numa execução anterior: mostra e grava o resultado
+ *
+ * @return 1 se o potfile tinha o hash (nenhum worker é necessário), 0 caso contrário
  */
-void index_to_password(long long index, const char *charset, int charset_len, 
-                       int password_len, char *output) {
-    for (int i = password_len - 1; i >= 0; i--) {
-        output[i] = charset[index % charset_len];
-        index /= charset_len;
+int report_known_target(const Potfile *pot, const char *target_hash) {
+    uint32_t state[4];
+    char password[SHARED_PASSWORD_MAX];
+    if (pot == NULL || md5_hex_to_state(target_hash, state) != 0 ||
+        !potfile_lookup(pot, state, password, sizeof(password))) {
+        return 0;
     }
-    output[password_len] = '\0';
+    
+    save_result_file(POTFILE_WORKER_ID, password);
+    printf("=== Resultado ===\n");
+    printf("✓ Senha encontrada!\n");
+    printf("  Senha: %s\n", password);
+    printf("  Hash: %s\n", target_hash);
+    printf("  Encontrada no potfile (nenhum worker criado)\n");
+    printf("  Verificação: %s\n", hash_matches(password, target_hash) ?
+           "✓ Hash corresponde!" : "✗ Hash NÃO corresponde!");
+    return 1;
+}
+
+/**
+ * Busca na tabela rainbow (--rainbow): as posições das cadeias são divididas
+ * entre num_workers threads; com --list, todos os hashes do arquivo que o
+ * potfile ainda não conhece
+ *
+ * @return 0 em caso de sucesso, 1 em caso de erro
+ */
+int run_rainbow_lookup(const char *table_path, const char *target_hash, int use_list,
+                       int num_workers, Potfile *pot) {
+    RainbowTable table;
+    if (rainbow_open(table_path, &table) != 0) {
+        return 1;
+    }
+    const RainbowHeader *header = table.header;
+    
+    uint32_t (*target_states)[4] = NULL;
+    int num_targets = 1;
+    if (use_list) {
+        if (target_list_load(target_hash, &target_states, &num_targets) != 0) {
+            rainbow_close(&table);
+            return 1;
+        }
+    } else {
+        target_states = malloc(sizeof(*target_states));
+        if (target_states == NULL || md5_hex_to_state(target_hash, target_states[0]) != 0) {
+            // Hash inválido: nada pode corresponder, como na busca por força bruta
+            num_targets = 0;
+        }
+    }
+    RainbowResult *results = calloc(num_targets + 1, sizeof(RainbowResult));
+    if (results == NULL) {
+        perror("calloc");
+        free(target_states);
+        rainbow_close(&table);
+        return 1;
+    }
+    
+    printf("=== Mini-Projeto 1: Quebra de Senhas Paralelo ===\n");
+    printf("%s: %s\n", use_list ? "Lista de hashes" : "Hash MD5 alvo", target_hash);
+    printf("Tabela rainbow: %s (%llu cadeias de comprimento %u, índice %u)\n", table_path,
+           (unsigned long long)header->num_chains, header->chain_len, header->table_index);
+    printf("Tamanho da senha: %d\n", header->keyspace.length);
+    printf("Espaço de busca: %llu combinações (cobertura estimada da tabela: %.1f%%)\n",
+           (unsigned long long)header->space,
+           100 * rainbow_coverage((long long)header->space, (long long)header->generated_chains,
+                                  (int)header->chain_len));
+    printf("Número de threads: %d\n", num_workers);
+    if (pot != NULL) {
+        printf("Potfile: %llu hashes já quebrados\n", (unsigned long long)pot->header->count);
+    }
+    printf("\n");
+    
+    // Hashes que o potfile já conhece não passam pela tabela
+    int known = 0;
+    if (use_list) {
+        unlink(RESULT_FILE);
+        known = take_known_targets(pot, target_states, &num_targets);
+    } else if (num_targets > 0 && report_known_target(pot, target_hash)) {
+        free(results);
+        free(target_states);
+        rainbow_close(&table);
+        return 0;
+    }
+    fflush(stdout);
+    
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    RainbowStats stats = {0, 0};
+    int found = num_targets > 0 ?
+                rainbow_lookup(&table, (const uint32_t (*)[4])target_states, num_targets,
+                               num_workers, results, &stats) : 0;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double elapsed = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    
+    printf("=== Resultado ===\n");
+    if (found < 0) {
+        found = 0;
+    }
+    if (use_list) {
+        for (int i = 0; i < num_targets; i++) {
+            if (!results[i].found) {
+                continue;
+            }
+            char hash[33];
+            md5_state_to_hex(target_states[i], hash);
+            append_result(hash, results[i].worker_id, results[i].password);
+            if (pot != NULL) {
+                potfile_add(pot, target_states[i], results[i].password);
+            }
+            printf("  %s  %s  Worker %d\n", hash, results[i].password, results[i].worker_id);
+        }
+        printf("%s %d de %d hashes quebrados (resultados em %s)\n", found + known > 0 ? "✓" : "✗",
+               found + known, num_targets + known, RESULT_FILE);
+        if (found < num_targets) {
+            printf("✗ %d hashes não encontrados na tabela.\n", num_targets - found);
+        }
+    } else if (found > 0) {
+        save_result_file(results[0].worker_id, results[0].password);
+        if (pot != NULL) {
+            potfile_add(pot, target_states[0], results[0].password);
+        }
+        printf("✓ Senha encontrada!\n");
+        printf("  Senha: %s\n", results[0].password);
+        printf("  Hash: %s\n", target_hash);
+        printf("  Encontrada pelo Worker %d\n", results[0].worker_id);
+        printf("  Verificação: %s\n", hash_matches(results[0].password, target_hash) ?
+               "✓ Hash corresponde!" : "✗ Hash NÃO corresponde!");
+    } else {
+        printf("✗ Senha não encontrada na tabela rainbow.\n");
+        printf("  A tabela cobre só parte do espaço: gere outra com --index diferente ou use a "
+               "força bruta.\n");
+    }
+    
+    printf("\n=== Estatísticas ===\n");
+    printf("Tempo total: %.2f segundos\n", elapsed);
+    printf("Hashes calculados: %lld (%lld falsos alarmes)\n", stats.hashes, stats.false_alarms);
+    
+    free(results);
+    free(target_states);
+    rainbow_close(&table);
+    return 0;
+}
+
+/**
+ * Leitor de linhas da fila de trabalhos (arquivo ou stdin, sem buffer do stdio)
+ */
+typedef struct {
+    int fd;
+    size_t start, end;          // Bytes ainda não consumidos em buffer
+    int eof;
+    char buffer[4096];
+} QueueReader;
+
+/**
+ * Próxima linha da fila
+ *
+ * @param timeout_ms Espera máxima por dados novos; -1 bloqueia até chegar uma linha
+ * @return 1 com a linha em line, 0 se nada chegou no prazo, -1 no fim da entrada
+ */
+static int queue_read_line(QueueReader *reader, char *line, size_t size, int timeout_ms) {
+    for (;;) {
+        char *begin = reader->buffer + reader->start;
+        size_t available = reader->end - reader->start;
+        char *newline = memchr(begin, '\n', available);
+        size_t length = newline != NULL ? (size_t)(newline - begin) : available;
+        // Linha completa, última linha sem '\n', ou linha maior que o buffer
+        if (newline != NULL || (reader->eof && available > 0) ||
+            available == sizeof(reader->buffer)) {
+            size_t copy = length < size - 1 ? length : size - 1;
+            memcpy(line, begin, copy);
+            line[copy] = '\0';
+            reader->start += length + (newline != NULL);
+            return 1;
+        }
+        if (reader->eof) {
+            return -1;
+        }
+        
+        memmove(reader->buffer, begin, available);
+        reader->start = 0;
+        reader->end = available;
+        if (timeout_ms >= 0) {
+            struct pollfd pfd = {reader->fd, POLLIN, 0};
+            if (poll(&pfd, 1, timeout_ms) <= 0) {
+                return 0;
+            }
+        }
+        ssize_t n = read(reader->fd, reader->buffer + reader->end,
+                         sizeof(reader->buffer) - reader->end);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            perror("read");
+        }
+        if (n <= 0) {
+            reader->eof = 1;
+        } else {
+            reader->end += n;
+        }
+    }
+}
+
+/**
+ * Fila de trabalhos (--queue): os workers são criados uma vez e recebem os
+ * trabalhos pela página (pool.c). Enquanto eles buscam, o coordinator lê e
+ * publica até POOL_SLOTS trabalhos à frente, e informa cada um assim que é
+ * concluído, com o tempo que ficou à frente da fila.
+ *
+ * @param path Arquivo de trabalhos, ou "-" para stdin
+ * @return 0 em caso de sucesso, 1 se a fila não pôde ser iniciada ou um worker morreu
+ */
+int run_queue(const char *path, const char *const custom_sets[MASK_CUSTOM_SETS],
+              int num_workers, Potfile *pot, const Topology *placement) {
+    QueueReader reader = {0};
+    reader.fd = strcmp(path, "-") == 0 ? STDIN_FILENO : open(path, O_RDONLY);
+    if (reader.fd < 0) {
+        printf("Erro: Não foi possível abrir a fila %s: %s\n", path, strerror(errno));
+        return 1;
+    }
+    
+    int shm_fd;
+    SharedState *shared = shared_state_create(&shm_fd, sizeof(PoolControl));
+    if (shared == NULL) {
+        return 1;
+    }
+    shared->pool_offset = shared->extra_offset;
+    PoolControl *pool = pool_from_shared(shared);
+    pool_init(pool, num_workers);
+    
+    // Os vencedores avisam com SIGUSR1; sem SA_RESTART, as esperas acordam na hora
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_result_signal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGUSR1, &sa, NULL);
+    unlink(RESULT_FILE);
+    
+    printf("=== Mini-Projeto 1: Quebra de Senhas Paralelo ===\n");
+    printf("Fila de trabalhos: %s\n", strcmp(path, "-") == 0 ? "stdin" : path);
+    printf("Número de workers: %d (permanentes, %d trabalhos à frente)\n", num_workers, POOL_SLOTS);
+    if (placement != NULL) {
+        topology_print(placement);
+    }
+    if (pot != NULL) {
+        printf("Potfile: %llu hashes já quebrados\n", (unsigned long long)pot->header->count);
+    }
+    printf("Iniciando workers...\n\n");
+    fflush(stdout);  // Evita que o buffer seja duplicado nos filhos
+    
+    char shm_fd_str[16];
+    snprintf(shm_fd_str, sizeof(shm_fd_str), "%d", shm_fd);
+    for (int i = 0; i < num_workers; i++) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("fork");
+            pool_shutdown(pool);
+            while (wait(NULL) > 0 || errno == EINTR) {
+                continue;
+            }
+            shared_state_destroy(shared, shm_fd);
+            return 1;
+        }
+        if (pid == 0) {
+            place_worker(placement, i);
+            char id_str[16];
+            snprintf(id_str, sizeof(id_str), "%d", i);
+            execl("./worker", "worker", "--pool", shm_fd_str, id_str, (char *)NULL);
+            perror("execl");
+            _exit(1);
+        }
+    }
+    
+    // Trabalhos publicados [reported, published); os dados de cada um ficam
+    // no slot da sua sequência
+    int job_number[POOL_SLOTS];
+    double publish_time[POOL_SLOTS];
+    int published = 0, reported = 0;
+    int jobs = 0, cracked = 0, known = 0, invalid = 0;
+    int failed = 0;
+    double start = monotonic_seconds();
+    double previous_done = start;
+    char line[1024];
+    
+    while (!reader.eof || reported < published) {
+        // Lê e publica enquanto houver slot livre; com trabalhos em andamento,
+        // a entrada só é esperada brevemente, para não atrasar os relatórios
+        while (published - reported < POOL_SLOTS) {
+            int status = queue_read_line(&reader, line, sizeof(line),
+                                         published > reported ? 10 : -1);
+            if (status <= 0) {
+                break;
+            }
+            char *text = line + strspn(line, " \t\r");
+            if (*text == '\0' || *text == '#') {
+                continue;
+            }
+            jobs++;
+            if (pool_job_prepare(pool, published, text, custom_sets) != 0) {
+                printf("[Trabalho %d] Linha inválida ignorada: %s\n", jobs, text);
+                invalid++;
+                continue;
+            }
+            
+            PoolJob *job = pool_job(pool, published);
+            uint32_t state[4];
+            char password[SHARED_PASSWORD_MAX];
+            md5_hex_to_state(job->target_hash, state);
+            if (pot != NULL && potfile_lookup(pot, state, password, sizeof(password))) {
+                printf("[Trabalho %d] %s  %s  (potfile)\n", jobs, job->target_hash, password);
+                append_result(job->target_hash, POTFILE_WORKER_ID, password);
+                known++;
+                continue;
+            }
+            job_number[published % POOL_SLOTS] = jobs;
+            publish_time[published % POOL_SLOTS] = monotonic_seconds();
+            pool_publish(pool, published);
+            published++;
+        }
+        fflush(stdout);
+        if (reported == published) {
+            continue;
+        }
+        
+        // Concluídos saem em ordem de sequência
+        int reading = !reader.eof && published - reported < POOL_SLOTS;
+        if (!pool_wait(pool, reported, reading ? 10 : 100)) {
+            // Um worker que morreu nunca sai do trabalho: a fila não andaria mais
+            int status;
+            pid_t pid = waitpid(-1, &status, WNOHANG);
+            if (pid > 0) {
+                printf("Erro: Worker (PID %d) terminou no meio da fila (código %d)\n", pid,
+                       WIFEXITED(status) ? WEXITSTATUS(status) : -1);
+                failed = 1;
+                break;
+            }
+            continue;
+        }
+        
+        PoolJob *job = pool_job(pool, reported);
+        int slot = reported % POOL_SLOTS;
+        double done = monotonic_seconds();
+        double elapsed_ms = (done - (publish_time[slot] > previous_done ? publish_time[slot] :
+                                     previous_done)) * 1000.0;
+        previous_done = done;
+        long long checked = atomic_load_explicit(&job->checked, memory_order_relaxed);
+        if (atomic_load_explicit(&job->state.found, memory_order_acquire)) {
+            int found_by = atomic_load(&job->state.winner);
+            const char *password = job->state.password;
+            printf("[Trabalho %d] %s  %s  Worker %d, %lld senhas, %.1f ms%s\n", job_number[slot],
+                   job->target_hash, password, found_by, checked, elapsed_ms,
+                   hash_matches(password, job->target_hash) ? "" : "  ✗ Hash NÃO corresponde!");
+            append_result(job->target_hash, found_by, password);
+            if (pot != NULL) {
+                uint32_t state[4];
+                md5_hex_to_state(job->target_hash, state);
+                potfile_add(pot, state, password);
+            }
+            cracked++;
+        } else {
+            printf("[Trabalho %d] %s  não encontrada (%lld senhas, %.1f ms)\n", job_number[slot],
+                   job->target_hash, checked, elapsed_ms);
+        }
+        reported++;
+    }
+    double elapsed = monotonic_seconds() - start;
+    
+    // Encerra os workers (no erro, também os que ainda buscam)
+    pool_shutdown(pool);
+    if (failed) {
+        for (int i = reported; i < published; i++) {
+            atomic_store(&pool_job(pool, i)->state.found, 1);
+        }
+    }
+    while (wait(NULL) > 0 || errno == EINTR) {
+        continue;
+    }
+    if (reader.fd != STDIN_FILENO) {
+        close(reader.fd);
+    }
+    shared_state_destroy(shared, shm_fd);
+    
+    printf("\n=== Resumo da Fila ===\n");
+    printf("Trabalhos: %d (%d quebrados, %d do potfile, %d inválidos, %d não encontrados)\n",
+           jobs, cracked, known, invalid, jobs - cracked - known - invalid - (published - reported));
+    printf("Tempo total: %.2f segundos (%.1f trabalhos/s)\n", elapsed,
+           elapsed > 0 ? jobs / elapsed : 0.0);
+    if (cracked + known > 0) {
+        printf("Resultados em %s (hash:worker:senha)\n", RESULT_FILE);
+    }
+    return failed;
 }
 
 /**
  * Função principal do coordenador
  */
 int main(int argc, char *argv[]) {
-    // TODO 1: Validar argumentos de entrada
-    // Verificar se argc == 5 (programa + 4 argumentos)
-    // Se não, imprimir mensagem de uso e sair com código 1
+    static const struct option long_options[] = {
+        {"sched", required_argument, NULL, 's'},
+        {"engine", required_argument, NULL, 'e'},
+        {"list", no_argument, NULL, 'l'},
+        {"mask", required_argument, NULL, 'm'},
+        {"wordlist", required_argument, NULL, 'w'},
+        {"rules", required_argument, NULL, 'r'},
+        {"checkpoint", required_argument, NULL, 'c'},
+        {"resume", no_argument, NULL, 'R'},
+        {"server", required_argument, NULL, 'S'},
+        {"connect", required_argument, NULL, 'C'},
+        {"status", required_argument, NULL, 'P'},
+        {"rainbow", required_argument, NULL, 'B'},
+        {"potfile", required_argument, NULL, 'O'},
+        {"no-potfile", no_argument, NULL, 'N'},
+        {"queue", required_argument, NULL, 'Q'},
+        {"prefix", required_argument, NULL, 'X'},
+        {"salt", required_argument, NULL, 'X'},
+        {"suffix", required_argument, NULL, 'Y'},
+        {"markov", required_argument, NULL, 'M'},
+        {"perf", no_argument, NULL, 'F'},
+        {"custom-charset1", required_argument, NULL, '1'},
+        {"custom-charset2", required_argument, NULL, '2'},
+        {"custom-charset3", required_argument, NULL, '3'},
+        {"custom-charset4", required_argument, NULL, '4'},
+        {NULL, 0, NULL, 0}
+    };
+    int dynamic = 0;
+    int use_threads = 0;
+    int use_list = 0;
+    const char *mask = NULL;
+    const char *wordlist_path = NULL;
+    const char *rules_path = NULL;
+    const char *checkpoint_path = CHECKPOINT_FILE;
+    int resume = 0;
+    int server_port = -1;
+    const char *connect_address = NULL;
+    int status_interval = TELEMETRY_INTERVAL;
+    const char *rainbow_path = NULL;
+    const char *potfile_path = POTFILE_FILE;
+    const char *queue_path = NULL;
+    const char *prefix = NULL;
+    const char *suffix = NULL;
+    const char *markov_path = NULL;
+    int profile = 0;
+    const char *custom_sets[MASK_CUSTOM_SETS] = {NULL};
+    int opt;
     
-    // IMPLEMENTE AQUI: verificação de argc e mensagem de erro
+    while ((opt = getopt_long(argc, argv, "s:e:lm:w:r:c:1:2:3:4:", long_options, NULL)) != -1) {
+        switch (opt) {
+            case 's':
+                if (strcmp(optarg, "dynamic") == 0) {
+                    dynamic = 1;
+                } else if (strcmp(optarg, "static") != 0) {
+                    printf("Erro: Escalonamento deve ser 'static' ou 'dynamic'\n");
+                    return 1;
+                }
+                break;
+            case 'e':
+                if (strcmp(optarg, "threads") == 0) {
+                    use_threads = 1;
+                } else if (strcmp(optarg, "processes") != 0) {
+                    printf("Erro: Motor deve ser 'processes' ou 'threads'\n");
+                    return 1;
+                }
+                break;
+            case 'l':
+                use_list = 1;
+                break;
+            case 'm':
+                mask = optarg;
+                break;
+            case 'w':
+                wordlist_path = optarg;
+                break;
+            case 'r':
+                rules_path = optarg;
+                break;
+            case 'c':
+                checkpoint_path = optarg;
+                break;
+            case 'R':
+                resume = 1;
+                break;
+            case 'S':
+                server_port = atoi(optarg);
+                if (server_port < 0 || server_port > 65535) {
+                    printf("Erro: Porta inválida: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'C':
+                connect_address = optarg;
+                break;
+            case 'B':
+                rainbow_path = optarg;
+                break;
+            case 'O':
+                potfile_path = optarg;
+                break;
+            case 'N':
+                potfile_path = NULL;
+                break;
+            case 'Q':
+                queue_path = optarg;
+                break;
+            case 'X':
+                prefix = optarg;
+                break;
+            case 'Y':
+                suffix = optarg;
+                break;
+            case 'M':
+                markov_path = optarg;
+                break;
+            case 'F':
+                profile = 1;
+                break;
+            case 'P':
+                status_interval = atoi(optarg);
+                if (status_interval < 0) {
+                    printf("Erro: Intervalo de status inválido: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case '1': case '2': case '3': case '4':
+                custom_sets[opt - '1'] = optarg;
+                break;
+            default:
+                print_usage(argv[0]);
+                return 1;
+        }
+    }
+    
+    // Nó remoto: só o número de workers; o resto vem do servidor
+    if (connect_address != NULL) {
+        if (argc - optind != 1) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        Topology topology = {0};
+        int num_workers = parse_num_workers(argv[optind], &topology);
+        if (num_workers < 1 || num_workers > MAX_WORKERS) {
+            printf("Erro: Número de workers deve estar entre 1 e %d\n", MAX_WORKERS);
+            return 1;
+        }
+        int status = run_remote_node(connect_address, num_workers,
+                                     topology.num_cpus > 0 ? &topology : NULL);
+        topology_free(&topology);
+        return status;
+    }
+    
+    // Validar argumentos de entrada (4 posicionais após as opções, 2 com --mask,
+    // --wordlist ou --rainbow, só num_workers com --queue)
+    int num_positional = queue_path != NULL ? 1 :
+                         mask != NULL || wordlist_path != NULL || rainbow_path != NULL ? 2 : 4;
+    if (argc - optind != num_positional) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (queue_path != NULL && (use_list || mask != NULL || wordlist_path != NULL ||
+                               rainbow_path != NULL || resume || server_port >= 0 || use_threads)) {
+        printf("Erro: --queue não pode ser usado com --list, --mask, --wordlist, --rainbow, "
+               "--resume, --server ou --engine threads\n");
+        return 1;
+    }
+    if (mask != NULL && wordlist_path != NULL) {
+        printf("Erro: --mask e --wordlist não podem ser usados juntos\n");
+        return 1;
+    }
+    if (rules_path != NULL && wordlist_path == NULL) {
+        printf("Erro: --rules requer --wordlist\n");
+        return 1;
+    }
+    if (rainbow_path != NULL && (mask != NULL || wordlist_path != NULL || resume || server_port >= 0)) {
+        printf("Erro: --rainbow não pode ser usado com --mask, --wordlist, --resume ou --server\n");
+        return 1;
+    }
+    if ((prefix != NULL || suffix != NULL) &&
+        (wordlist_path != NULL || rainbow_path != NULL || queue_path != NULL)) {
+        printf("Erro: --prefix e --suffix valem só para charset ou máscara (sem --wordlist, "
+               "--rainbow ou --queue)\n");
+        return 1;
+    }
+    if (markov_path != NULL &&
+        (wordlist_path != NULL || rainbow_path != NULL || queue_path != NULL)) {
+        printf("Erro: --markov vale só para charset ou máscara (sem --wordlist, --rainbow ou "
+               "--queue)\n");
+        return 1;
+    }
+    if (profile && (rainbow_path != NULL || queue_path != NULL || server_port >= 0)) {
+        printf("Erro: --perf vale só para a busca local (sem --rainbow, --queue ou --server)\n");
+        return 1;
+    }
+    if (server_port >= 0 && (use_list || wordlist_path != NULL || resume || use_threads)) {
+        printf("Erro: --server aceita apenas um hash com charset ou máscara\n");
+        return 1;
+    }
     
     // Parsing dos argumentos (após validação)
-    const char *target_hash = argv[1];
-    int password_len = atoi(argv[2]);
-    const char *charset = argv[3];
-    int num_workers = atoi(argv[4]);
-    int charset_len = strlen(charset);
+    const char *target_hash = argv[optind];
+    const char *workers_arg = argv[optind + num_positional - 1];
+    Topology topology = {0};
+    int num_workers = parse_num_workers(workers_arg, &topology);
+    const Topology *placement = topology.num_cpus > 0 ? &topology : NULL;
+    
+    // Potfile: resultados de execuções anteriores. Sem ele a busca segue
+    // normalmente, só não aproveita o que já foi quebrado
+    Potfile potfile;
+    Potfile *pot = NULL;
+    if (potfile_path != NULL) {
+        if (potfile_open(&potfile, potfile_path) == 0) {
+            pot = &potfile;
+        } else {
+            printf("Aviso: Potfile %s indisponível, seguindo sem ele\n", potfile_path);
+        }
+    }
     
-    // TODO: Adicionar validações dos parâmetros
-    // - password_len deve estar entre 1 e 10
-    // - num_workers deve estar entre 1 e MAX_WORKERS
-    // - charset não pode ser vazio
+    // Fila de trabalhos: cada linha traz o seu hash e o seu espaço de busca
+    if (queue_path != NULL) {
+        if (num_workers < 1 || num_workers > MAX_WORKERS) {
+            printf("Erro: Número de workers deve estar entre 1 e %d\n", MAX_WORKERS);
+            return 1;
+        }
+        int status = run_queue(queue_path, custom_sets, num_workers, pot, placement);
+        if (pot != NULL) {
+            potfile_close(pot);
+        }
+        return status;
+    }
+    
+    // Tabela rainbow: o espaço de busca vem da própria tabela
+    if (rainbow_path != NULL) {
+        if (num_workers < 1 || num_workers > MAX_WORKERS) {
+            printf("Erro: Número de workers deve estar entre 1 e %d\n", MAX_WORKERS);
+            return 1;
+        }
+        int status = run_rainbow_lookup(rainbow_path, target_hash, use_list, num_workers, pot);
+        if (pot != NULL) {
+            potfile_close(pot);
+        }
+        return status;
+    }
+    
+    // Espaço de busca: linhas da wordlist, ou um charset por posição (todos iguais
+    // sem --mask)
+    Wordlist wordlist = {NULL, 0};
+    Keyspace keyspace;
+    const char *charset = mask;
+    if (wordlist_path != NULL) {
+        if (wordlist_open(&wordlist, wordlist_path) != 0) {
+            return 1;
+        }
+        if (wordlist.size == 0) {
+            printf("Erro: Wordlist vazia: %s\n", wordlist_path);
+            return 1;
+        }
+        keyspace.length = 0;
+    } else if (mask != NULL) {
+        if (keyspace_init_mask(&keyspace, mask, custom_sets) != 0) {
+            return 1;
+        }
+    } else {
+        int password_len = atoi(argv[optind + 1]);
+        charset = argv[optind + 2];
+        
+        // Validações dos parâmetros
+        if (password_len < 1 || password_len > MAX_PASSWORD_LEN) {
+            printf("Erro: Tamanho da senha deve estar entre 1 e %d\n", MAX_PASSWORD_LEN);
+            return 1;
+        }
+        if (charset[0] == '\0') {
+            printf("Erro: Conjunto de caracteres não pode ser vazio\n");
+            return 1;
+        }
+        keyspace_init_charset(&keyspace, charset, password_len);
+    }
+    // Texto fixo em volta da senha (sal): os blocos inteiros do prefixo viram
+    // o midstate de onde todos os candidatos partem
+    if ((prefix != NULL || suffix != NULL) && keyspace_set_affixes(&keyspace, prefix, suffix) != 0) {
+        return 1;
+    }
+    // Ordem por probabilidade: os charsets são reordenados pelo modelo
+    MarkovModel markov;
+    if (markov_path != NULL && (markov_load(&markov, markov_path) != 0 ||
+                                markov_apply(&markov, &keyspace) != 0)) {
+        return 1;
+    }
+    // No servidor, num_workers conta só os workers locais, e pode ser 0
+    if (num_workers < (server_port >= 0 ? 0 : 1) || num_workers > MAX_WORKERS) {
+        printf("Erro: Número de workers deve estar entre 1 e %d\n", MAX_WORKERS);
+        return 1;
+    }
+    
+    // Lista de alvos: lida antes de criar a página, que precisa do tamanho do conjunto
+    uint32_t (*target_states)[4] = NULL;
+    int num_targets = 0;
+    if (use_list) {
+        if (target_list_load(target_hash, &target_states, &num_targets) != 0) {
+            return 1;
+        }
+        if (num_targets == 0) {
+            printf("Erro: Nenhum hash MD5 válido em %s\n", target_hash);
+            free(target_states);
+            return 1;
+        }
+    }
+    
+    // Regras compiladas uma vez aqui; os workers as recebem na página
+    RuleSet rules = {NULL, 0, 0};
+    if (rules_path != NULL) {
+        if (ruleset_load(&rules, rules_path) != 0) {
+            free(target_states);
+            return 1;
+        }
+        if (rules.count == 0) {
+            printf("Erro: Nenhuma regra válida em %s\n", rules_path);
+            free(target_states);
+            return 1;
+        }
+    }
+    
+    // Checkpoint anterior: os intervalos já feitos saem da fila, que passa a
+    // ser dinâmica (os intervalos restantes raramente se dividem por igual)
+    Checkpoint ckpt;
+    if (resume) {
+        if (checkpoint_load(checkpoint_path, &ckpt) != 0) {
+            printf("Erro: Não foi possível ler o checkpoint %s: %s\n", checkpoint_path,
+                   strerror(errno));
+            free(target_states);
+            ruleset_free(&rules);
+            return 1;
+        }
+        dynamic = 1;
+    }
+    // O servidor entrega a fila dinâmica pela rede; na ordem Markov, os blocos
+    // saem da fila dos mais prováveis aos menos prováveis para todos os workers
+    // (na divisão estática, só o primeiro começaria pelos mais prováveis)
+    if (server_port >= 0 || markov_path != NULL) {
+        dynamic = 1;
+    }
     
     printf("=== Mini-Projeto 1: Quebra de Senhas Paralelo ===\n");
-    printf("Hash MD5 alvo: %s\n", target_hash);
-    printf("Tamanho da senha: %d\n", password_len);
-    printf("Charset: %s (tamanho: %d)\n", charset, charset_len);
+    if (use_list) {
+        printf("Lista de hashes: %s (%d hashes)\n", target_hash, num_targets);
+    } else {
+        printf("Hash MD5 alvo: %s\n", target_hash);
+    }
+    if (wordlist_path != NULL) {
+        printf("Wordlist: %s (%zu bytes, mapeada em memória)\n", wordlist_path, wordlist.size);
+        if (rules_path != NULL) {
+            printf("Regras: %s (%d regras", rules_path, rules.count);
+            if (rules.invalid > 0) {
+                printf(", %d inválidas ignoradas", rules.invalid);
+            }
+            printf(")\n");
+        }
+    } else if (mask != NULL) {
+        printf("Tamanho da senha: %d\n", keyspace.length);
+        printf("Máscara: %s (charsets por posição:", mask);
+        for (int i = 0; i < keyspace.length; i++) {
+            printf("%s%d", i == 0 ? " " : " x ", keyspace.set_len[i]);
+        }
+        printf(")\n");
+    } else {
+        printf("Tamanho da senha: %d\n", keyspace.length);
+        printf("Charset: %s (tamanho: %d)\n", charset, keyspace.set_len[0]);
+    }
+    if (prefix != NULL) {
+        printf("Prefixo: %s (%d bytes; %d blocos MD5 pré-calculados)\n", prefix, keyspace.prefix_len,
+               keyspace.prefix_len / MD5_BLOCK_SIZE);
+    }
+    if (suffix != NULL) {
+        printf("Sufixo: %s (%d bytes)\n", suffix, keyspace.suffix_len);
+    }
+    if (markov_path != NULL) {
+        printf("Ordem: Markov, modelo %s (%llu palavras); primeiros candidatos: ", markov_path,
+               (unsigned long long)markov.header.words);
+        char password[MAX_PASSWORD_LEN + 1];
+        int shown = keyspace_size(&keyspace) < 3 ? (int)keyspace_size(&keyspace) : 3;
+        for (int i = 0; i < shown; i++) {
+            keyspace_index_to_password(&keyspace, i, password);
+            printf("%s%s", i == 0 ? "" : ", ", password);
+        }
+        printf("\n");
+    }
     printf("Número de workers: %d\n", num_workers);
+    if (placement != NULL) {
+        topology_print(placement);
+    }
+    printf("Escalonamento: %s%s\n", dynamic ? "dinâmico (fila de blocos)" : "estático",
+           resume ? " - retomando do checkpoint" : "");
+    printf("Motor: %s\n", server_port >= 0 ? "servidor de blocos (TCP)" :
+                           use_threads ? "threads" : "processos");
+    if (profile) {
+        printf("Contadores: perf_event_open em cada worker (resumo ao terminar)\n");
+    }
+    if (server_port < 0) {
+        printf("Checkpoint: %s (a cada %d s)\n", checkpoint_path, CHECKPOINT_INTERVAL);
+    }
+    if (pot != NULL) {
+        printf("Potfile: %s (%llu hashes já quebrados)\n", potfile_path,
+               (unsigned long long)pot->header->count);
+    }
     
-    // Calcular espaço de busca total
-    long long total_space = calculate_search_space(charset_len, password_len);
-    printf("Espaço de busca total: %lld combinações\n\n", total_space);
+    // Calcular espaço de busca total (produto exato das bases de cada posição,
+    // ou bytes da wordlist)
+    KeyspaceIndex total_space = wordlist_path != NULL ? (KeyspaceIndex)wordlist.size :
+                                keyspace_size(&keyspace);
+    if (total_space < 0) {
+        printf("Erro: Espaço de busca excede 2^127 combinações\n");
+        free(target_states);
+        return 1;
+    }
+    char total_str[KEYSPACE_INDEX_STR];
+    printf("Espaço de busca total: %s %s\n\n", keyspace_index_str(total_space, total_str),
+           wordlist_path != NULL ? "bytes" : "combinações");
     
-    // Remover arquivo de resultado anterior se existir
-    unlink(RESULT_FILE);
+    // Nunca há mais workers que senhas (ou bytes)
+    if (num_workers > total_space) {
+        num_workers = (int)total_space;
+    }
     
-    // Registrar tempo de início
-    time_t start_time = time(NULL);
+    // Remover arquivo de resultado anterior se existir (na lista retomada ele
+    // já tem as linhas dos hashes quebrados antes)
+    if (!(resume && use_list)) {
+        unlink(RESULT_FILE);
+    }
     
-    // TODO 2: Dividir o espaço de busca entre os workers
-    // Calcular quantas senhas cada worker deve verificar
-    // DICA: Use divisão inteira e distribua o resto entre os primeiros workers
+    // Hashes que o potfile já conhece: sem workers para eles, e sem busca
+    // nenhuma se não sobrar nada
+    int known = 0;
+    if (use_list) {
+        known = take_known_targets(pot, target_states, &num_targets);
+        if (num_targets == 0) {
+            printf("=== Resultado ===\n");
+            printf("✓ %d de %d hashes quebrados (todos no potfile; resultados em %s)\n", known,
+                   known, RESULT_FILE);
+            free(target_states);
+            potfile_close(pot);
+            return 0;
+        }
+    } else if (report_known_target(pot, target_hash)) {
+        potfile_close(pot);
+        return 0;
+    }
     
-    // IMPLEMENTE AQUI:
-    // long long passwords_per_worker = ?
-    // long long remaining = ?
+    // Página compartilhada: flag de parada e slot de resultado dos workers,
+    // seguidos do conjunto de alvos, das regras, do progresso de cada worker
+    // e dos intervalos restantes (--resume)
+    size_t targets_size = use_list ? target_set_size(num_targets) : 0;
+    targets_size = (targets_size + CACHE_LINE_SIZE - 1) & ~(size_t)(CACHE_LINE_SIZE - 1);
+    size_t rules_size = rules.count * sizeof(Rule);
+    rules_size = (rules_size + CACHE_LINE_SIZE - 1) & ~(size_t)(CACHE_LINE_SIZE - 1);
+    size_t progress_size = num_workers * sizeof(WorkerProgress);
+    size_t ranges_size = resume ? (ckpt.num_done + 1) * sizeof(IndexRange) : 0;
+    int shm_fd;
+    SharedState *shared = shared_state_create(&shm_fd, targets_size + rules_size + progress_size +
+                                                      ranges_size);
+    if (shared == NULL) {
+        return 1;
+    }
+    shared->progress_offset = shared->extra_offset + targets_size + rules_size;
+    memset(shared_state_progress(shared), 0, progress_size);
+    if (rules.count > 0) {
+        shared->rules_offset = shared->extra_offset + targets_size;
+        shared->num_rules = rules.count;
+        memcpy((char *)shared + shared->rules_offset, rules.rules, rules.count * sizeof(Rule));
+        ruleset_free(&rules);
+    }
+    
+    // Conjunto de alvos montado direto na página, já visível para os workers
+    TargetSet *targets = NULL;
+    if (use_list) {
+        shared->targets_offset = shared->extra_offset;
+        targets = target_set_from_shared(shared);
+        target_set_build(targets, target_states, num_targets);
+        free(target_states);
+        if (targets->count < num_targets) {
+            printf("Hashes repetidos ignorados: %d\n\n", num_targets - targets->count);
+        }
+    }
     
-    // Arrays para armazenar PIDs dos workers
-    pid_t workers[MAX_WORKERS];
+    // Fila de blocos: os workers reivindicam índices a partir de next_index
+    shared->dynamic = dynamic;
+    shared->num_workers = num_workers;
+    shared->profile = profile;
+    shared_state_set_queue(shared, total_space);
+    shared->keyspace = keyspace;
     
-    // TODO 3: Criar os processos workers usando fork()
-    printf("Iniciando workers...\n");
+    // Identificador do trabalho: impede retomar com outro hash ou outro espaço
+    char job_id[33];
+    checkpoint_job_id(shared, target_hash, wordlist_path, total_space, job_id);
+    if (resume) {
+        if (strcmp(ckpt.job_id, job_id) != 0 || ckpt.total != total_space) {
+            printf("Erro: O checkpoint %s é de outro trabalho (hash, espaço de busca ou regras "
+                   "diferentes)\n", checkpoint_path);
+            checkpoint_free(&ckpt);
+            shared_state_destroy(shared, shm_fd);
+            return 1;
+        }
+        shared->ranges_offset = shared->progress_offset + progress_size;
+        KeyspaceIndex remaining;
+        shared->num_ranges = checkpoint_remaining(&ckpt, (IndexRange *)((char *)shared +
+                                                                        shared->ranges_offset),
+                                                  &remaining);
+        shared_state_set_queue(shared, remaining);
+        char done_str[KEYSPACE_INDEX_STR];
+        printf("Checkpoint %s: %s de %s já verificados, %d intervalos restantes\n",
+               checkpoint_path, keyspace_index_str(total_space - remaining, done_str), total_str,
+               shared->num_ranges);
+        if (targets != NULL) {
+            int restored = checkpoint_restore_targets(&ckpt, targets);
+            printf("Hashes quebrados antes: %d\n", restored);
+            if (atomic_load(&targets->cracked) == targets->count) {
+                atomic_store(&shared->found, 1);
+            }
+        }
+        printf("\n");
+        checkpoint_free(&ckpt);
+    }
     
-    // IMPLEMENTE AQUI: Loop para criar workers
+    // Sem SA_RESTART: o aviso do vencedor interrompe o wait() na hora
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_result_signal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGUSR1, &sa, NULL);
+    
+    // Registrar tempo de início
+    time_t start_time = time(NULL);
+    
+    // Dividir o espaço de busca entre os workers
+    // O resto da divisão é distribuído entre os primeiros workers
+    // (o servidor pode não ter workers locais: num_workers == 0)
+    WorkerRange *ranges = malloc((num_workers + 1) * sizeof(WorkerRange));
+    if (ranges == NULL) {
+        perror("malloc");
+        return 1;
+    }
     for (int i = 0; i < num_workers; i++) {
-        // TODO: Calcular intervalo de senhas para este worker
-        // TODO: Converter indices para senhas de inicio e fim
-        // TODO 4: Usar fork() para criar processo filho
-        // TODO 5: No processo pai: armazenar PID
-        // TODO 6: No processo filho: usar execl() para executar worker
-        // TODO 7: Tratar erros de fork() e execl()
+        ranges[i].start_index = keyspace_partition(total_space, num_workers, i, &ranges[i].count);
     }
     
-    printf("\nTodos os workers foram iniciados. Aguardando conclusão...\n");
+    // Wordlist: cada fronteira avança até o início de uma linha, para que
+    // nenhuma linha fique dividida entre dois workers
+    if (wordlist_path != NULL) {
+        long long start = 0;
+        for (int i = 0; i < num_workers; i++) {
+            long long end = (long long)wordlist_line_start(&wordlist,
+                                                           ranges[i].start_index + ranges[i].count);
+            ranges[i].start_index = start;
+            ranges[i].count = end - start;
+            start = end;
+        }
+    }
+    
+    // Modo estático: cada worker já começa com o seu intervalo no progresso
+    if (!dynamic) {
+        WorkerProgress *progress = shared_state_progress(shared);
+        for (int i = 0; i < num_workers; i++) {
+            worker_progress_set(&progress[i], ranges[i].start_index,
+                                ranges[i].start_index + ranges[i].count);
+        }
+    }
     
-    // TODO 8: Aguardar todos os workers terminarem usando wait()
-    // IMPORTANTE: O pai deve aguardar TODOS os filhos para evitar zumbis
+    // Gravação periódica do progresso, em paralelo com qualquer um dos motores
+    // (no servidor os blocos em andamento estão nos nós, fora da página)
+    CheckpointWriter writer;
+    int writing = server_port < 0 &&
+                  checkpoint_writer_start(&writer, checkpoint_path, job_id, shared,
+                                          total_space) == 0;
+    // Relatório de progresso ao vivo (o servidor tem o seu, por nó)
+    TelemetryMonitor monitor;
+    int monitoring = server_port < 0 && status_interval > 0 && shared->total > 0 &&
+                     telemetry_start(&monitor, shared, total_space, status_interval) == 0;
+    int interrupted = 0;
+    
+    if (shared->total == 0) {
+        printf("Nada a verificar: o checkpoint cobre todo o espaço de busca\n");
+    } else if (server_port >= 0) {
+        interrupted = run_server(server_port, target_hash, num_workers, shared, start_time,
+                                 placement) != 0;
+    } else if (use_threads) {
+        // Motor de threads: o hash alvo é decodificado uma vez para todo o pool
+        SearchJob job;
+        printf("Iniciando %d threads fixadas às CPUs...\n", num_workers);
+        fflush(stdout);
+        int job_valid = 1;
+        const Keyspace *job_keyspace = wordlist_path != NULL ? NULL : &shared->keyspace;
+        if (targets != NULL) {
+            search_job_init_list(&job, targets, job_keyspace);
+        } else {
+            job_valid = search_job_init(&job, target_hash, job_keyspace) == 0;
+        }
+        if (wordlist_path != NULL) {
+            search_job_use_wordlist(&job, &wordlist);
+            search_job_use_rules(&job, rules_from_shared(shared), shared->num_rules);
+        }
+        if (!job_valid) {
+            printf("Hash alvo inválido - nenhuma senha pode corresponder\n");
+        } else if (thread_engine_run(&job, shared, num_workers, ranges, placement) < 0) {
+            interrupted = 1;
+        }
+    } else if (run_process_engine(target_hash, charset, wordlist_path, ranges, num_workers,
+                                  shared, shm_fd, start_time, placement) != 0) {
+        // Um worker que morreu depois de a senha aparecer não deixou nada por fazer
+        interrupted = !atomic_load_explicit(&shared->found, memory_order_acquire);
+    }
+    free(ranges);
+    if (monitoring) {
+        telemetry_stop(&monitor);
+    }
     
-    // IMPLEMENTE AQUI:
-    // - Loop para aguardar cada worker terminar
-    // - Usar wait() para capturar status de saída
-    // - Identificar qual worker terminou
-    // - Verificar se terminou normalmente ou com erro
-    // - Contar quantos workers terminaram
+    // Busca concluída: o checkpoint não serve mais. Se os workers não puderam
+    // ser criados ou algum morreu no meio, o progresso que houve fica gravado
+    // para o --resume
+    if (writing) {
+        checkpoint_writer_stop(&writer, interrupted);
+    }
+    if (interrupted) {
+        printf("\n=== Resultado ===\n");
+        printf("✗ Busca incompleta: parte do espaço de busca não foi verificada.\n");
+        if (writing) {
+            printf("  Progresso gravado em %s; continue com --checkpoint %s --resume\n",
+                   checkpoint_path, checkpoint_path);
+        }
+        return 1;
+    }
     
     // Registrar tempo de fim
     time_t end_time = time(NULL);
@@ -138,18 +1516,78 @@ int main(int argc, char *argv[]) {
     
     printf("\n=== Resultado ===\n");
     
-    // TODO 9: Verificar se algum worker encontrou a senha
-    // Ler o arquivo password_found.txt se existir
+    // Verificar se algum worker encontrou a senha (slot de resultado compartilhado)
+    int found = 0;
+    if (targets != NULL) {
+        // Os workers já gravaram cada resultado no arquivo, na ordem em que saíram
+        int cracked = 0;
+        for (int i = 0; i < targets->count; i++) {
+            TargetEntry *entry = target_set_entry(targets, i);
+            int found_by = atomic_load_explicit(&entry->winner, memory_order_acquire);
+            if (found_by < 0) {
+                continue;
+            }
+            char hash[33];
+            char candidate[KEYSPACE_CANDIDATE_MAX + 1];
+            md5_state_to_hex(entry->state, hash);
+            if (wordlist_path != NULL) {
+                snprintf(candidate, sizeof(candidate), "%s", entry->password);
+            } else {
+                keyspace_candidate(&keyspace, entry->password, candidate);
+            }
+            printf("  %s  %-*s  Worker %d%s\n", hash, wordlist_path != NULL ? 0 : keyspace.length,
+                   entry->password, found_by,
+                   hash_matches(candidate, hash) ? "" : "  ✗ Hash NÃO corresponde!");
+            if (pot != NULL) {
+                potfile_add(pot, entry->state, candidate);
+            }
+            cracked++;
+        }
+        found = 1;
+        printf("%s %d de %d hashes quebrados (resultados em %s)\n", cracked + known > 0 ? "✓" : "✗",
+               cracked + known, targets->count + known, RESULT_FILE);
+        if (cracked < targets->count) {
+            printf("✗ %d hashes não encontrados no espaço de busca especificado.\n",
+                   targets->count - cracked);
+        }
+    } else if (atomic_load_explicit(&shared->found, memory_order_acquire)) {
+        int found_by = atomic_load(&shared->winner);
+        const char *password = shared->password;
+        // Com prefixo ou sufixo, o hash é o da mensagem inteira
+        char candidate[KEYSPACE_CANDIDATE_MAX + 1];
+        if (wordlist_path != NULL) {
+            snprintf(candidate, sizeof(candidate), "%s", password);
+        } else {
+            keyspace_candidate(&keyspace, password, candidate);
+        }
+        save_result_file(found_by, password);
+        uint32_t state[4];
+        if (pot != NULL && md5_hex_to_state(target_hash, state) == 0) {
+            potfile_add(pot, state, candidate);
+        }
+        found = 1;
+        printf("✓ Senha encontrada!\n");
+        printf("  Senha: %s\n", password);
+        printf("  Hash: %s\n", target_hash);
+        printf("  Encontrada pelo Worker %d\n", found_by);
+        printf("  Verificação: %s\n", hash_matches(candidate, target_hash) ?
+               "✓ Hash corresponde!" : "✗ Hash NÃO corresponde!");
+    }
     
-    // IMPLEMENTE AQUI:
-    // - Abrir arquivo RESULT_FILE para leitura
-    // - Ler conteúdo do arquivo
-    // - Fazer parse do formato "worker_id:password"
-    // - Verificar o hash usando md5_string()
-    // - Exibir resultado encontrado
+    if (!found) {
+        printf("✗ Senha não encontrada no espaço de busca especificado.\n");
+        printf("  Verifique se o hash está correto e se o charset contém todos os caracteres.\n");
+    }
     
-    // Estatísticas finais (opcional)
-    // TODO: Calcular e exibir estatísticas de performance
+    // Estatísticas finais
+    printf("\n=== Estatísticas ===\n");
+    printf("Tempo total: %.2f segundos\n", elapsed_time);
     
+    shared_state_destroy(shared, shm_fd);
+    wordlist_close(&wordlist);
+    topology_free(&topology);
+    if (pot != NULL) {
+        potfile_close(pot);
+    }
     return 0;
-}
\ No newline at end of file
+}
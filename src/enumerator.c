@@ -0,0 +1,63 @@
+#include "enumerator.h"
+
+/**
+ * Fim da linha do último caractere: o charset inteiro, ou o fim do nível
+ */
+static int row_end(const Enumerator *e) {
+    const Keyspace *ks = e->keyspace;
+    int last = e->last;
+    return ks->order.enabled ? ks->order.level_end[last][e->levels[last]] : ks->set_len[last];
+}
+
+void enumerator_init(Enumerator *e, const Keyspace *keyspace, KeyspaceIndex start_index,
+                     long long count) {
+    char password[MAX_PASSWORD_LEN + 1];
+
+    e->keyspace = keyspace;
+    e->remaining = count;
+    e->last = keyspace->length - 1;
+
+    // Dígitos em base mista ou, na ordem Markov, níveis e dígitos do índice
+    keyspace_index_to_digits(keyspace, start_index, e->digits, e->levels);
+    for (int i = 0; i < keyspace->length; i++) {
+        password[i] = keyspace->sets[i][e->digits[i]];
+    }
+    e->row_end = row_end(e);
+
+    enumerator_block_init(&e->block, keyspace, password);
+    e->offset = keyspace_block_offset(keyspace);
+}
+
+void enumerator_next_level(Enumerator *e) {
+    const Keyspace *ks = e->keyspace;
+
+    keyspace_next_row(ks, e->digits, e->levels);
+    for (int i = 0; i < ks->length; i++) {
+        md5_block_set_byte(&e->block, e->offset + i, (uint8_t)ks->sets[i][e->digits[i]]);
+    }
+    e->row_end = row_end(e);
+}
+
+void enumerator_block_init(MD5Block *block, const Keyspace *keyspace, const char *password) {
+    int offset = keyspace_block_offset(keyspace);
+    int len = offset + keyspace->length + keyspace->suffix_len;
+    uint8_t *bytes = md5_block_bytes(block);
+
+    // Os blocos inteiros do prefixo já estão no midstate
+    memcpy(bytes, keyspace->prefix + keyspace->prefix_len - offset, offset);
+    memcpy(bytes + offset, password, keyspace->length);
+    memcpy(bytes + offset + keyspace->length, keyspace->suffix, keyspace->suffix_len);
+    md5_block_finish(block, len);
+    // O comprimento em bits é o da mensagem inteira, não só o do bloco
+    uint64_t bits = (uint64_t)(keyspace->prefix_len + keyspace->length + keyspace->suffix_len) << 3;
+    block->x[14] = (uint32_t)bits;
+    block->x[15] = (uint32_t)(bits >> 32);
+}
+
+void enumerator_block_password(const MD5Block *block, const Keyspace *keyspace, char *output) {
+    int offset = keyspace_block_offset(keyspace);
+    for (int i = 0; i < keyspace->length; i++) {
+        output[i] = (char)md5_block_get_byte(block, offset + i);
+    }
+    output[keyspace->length] = '\0';
+}
@@ -0,0 +1,107 @@
+#ifndef ENUMERATOR_H
+#define ENUMERATOR_H
+
+#include "hash_utils.h"
+#include "keyspace.h"
+
+/**
+ * Enumerador "odômetro" de candidatos
+ *
+ * Mantém o candidato atual como um vetor de índices (um dígito por posição, na
+ * base do charset daquela posição) e já formatado dentro de um bloco MD5.
+ * Avançar para o próximo candidato incrementa o último dígito e reescreve
+ * apenas os bytes que mudaram:
+ * na maioria das chamadas, um único byte. Não há busca do caractere no charset
+ * nem comparação de strings para detectar o fim do intervalo - o fim é um
+ * contador de 64 bits.
+ *
+ * Com prefixo ou sufixo (keyspace_set_affixes), o bloco é o último da
+ * mensagem: fim do prefixo, senha a partir de offset, sufixo, padding e o
+ * comprimento da mensagem inteira.
+ *
+ * Na ordem Markov (ks->order) a linha do último caractere termina no fim do
+ * seu nível (row_end), e o "vai um" segue keyspace_next_row().
+ */
+typedef struct {
+    MD5Block block;                  // Candidato atual, com padding e comprimento
+    int digits[MAX_PASSWORD_LEN];    // Índice no charset de cada posição
+    int row_end;                     // Fim da linha atual do último caractere
+    int last;                        // Posição do último caractere (length - 1)
+    const Keyspace *keyspace;
+    long long remaining;             // Candidatos restantes, incluindo o atual
+    int offset;                      // Posição da senha no bloco (fim do prefixo)
+    int levels[MAX_PASSWORD_LEN];    // Nível de cada posição (ordem Markov)
+} Enumerator;
+
+/**
+ * Posiciona o enumerador no índice start_index, com count candidatos a percorrer
+ * (a contagem fica em 64 bits no laço quente)
+ */
+void enumerator_init(Enumerator *e, const Keyspace *keyspace, KeyspaceIndex start_index,
+                     long long count);
+
+/**
+ * Último bloco MD5 do candidato password (fim do prefixo, senha e sufixo)
+ */
+void enumerator_block_init(MD5Block *block, const Keyspace *keyspace, const char *password);
+
+/**
+ * Reconstrói a senha guardada em um bloco (para relatar acertos), sem o
+ * prefixo nem o sufixo
+ *
+ * @param output Buffer com pelo menos keyspace->length + 1 bytes
+ */
+void enumerator_block_password(const MD5Block *block, const Keyspace *keyspace, char *output);
+
+/**
+ * Passa para o início da próxima linha na ordem Markov
+ */
+void enumerator_next_level(Enumerator *e);
+
+/**
+ * Avança para o próximo candidato
+ *
+ * @return 1 se há um próximo candidato, 0 se o intervalo acabou
+ */
+static inline int enumerator_next(Enumerator *e) {
+    if (--e->remaining <= 0) {
+        return 0;
+    }
+
+    // Caso comum: próximo caractere da mesma linha
+    int pos = e->last;
+    int digit = ++e->digits[pos];
+    if (digit != e->row_end) {
+        md5_block_set_byte(&e->block, e->offset + pos, (uint8_t)e->keyspace->sets[pos][digit]);
+        return 1;
+    }
+
+    const Keyspace *ks = e->keyspace;
+    if (ks->order.enabled) {
+        enumerator_next_level(e);
+        return 1;
+    }
+    do {
+        // Estourou: volta ao primeiro caractere e "vai um" para a esquerda
+        e->digits[pos] = 0;
+        md5_block_set_byte(&e->block, e->offset + pos, (uint8_t)ks->sets[pos][0]);
+        pos--;
+    } while (++e->digits[pos] == ks->set_len[pos]);
+    md5_block_set_byte(&e->block, e->offset + pos, (uint8_t)ks->sets[pos][e->digits[pos]]);
+    return 1;
+}
+
+/**
+ * Pula os n - 1 candidatos seguintes e avança para o n-ésimo
+ * Usado quando um núcleo especializado já testou os n valores restantes do
+ * último caractere de uma vez; n não pode passar do fim da linha atual.
+ *
+ * @return 1 se há um próximo candidato, 0 se o intervalo acabou
+ */
+static inline int enumerator_next_row(Enumerator *e, int n) {
+    e->digits[e->keyspace->length - 1] += n - 1;
+    e->remaining -= n - 1;
+    return enumerator_next(e);
+}
+
+#endif // ENUMERATOR_H
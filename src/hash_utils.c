@@ -1,4 +1,6 @@
+#include <stdatomic.h>
 #include "hash_utils.h"
+#include "md5_simd.h"
 
 // Implementação MD5 de domínio público
 // Baseada na RFC 1321
@@ -9,23 +11,6 @@ typedef struct {
     uint8_t buffer[64];
 } MD5_CTX;
 
-#define S11 7
-#define S12 12
-#define S13 17
-#define S14 22
-#define S21 5
-#define S22 9
-#define S23 14
-#define S24 20
-#define S31 4
-#define S32 11
-#define S33 16
-#define S34 23
-#define S41 6
-#define S42 10
-#define S43 15
-#define S44 21
-
 static uint8_t PADDING[64] = {
     0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
     0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
@@ -61,6 +46,7 @@ static uint8_t PADDING[64] = {
 }
 
 static void MD5Transform(uint32_t state[4], const uint8_t block[64]);
+static void MD5Compress(uint32_t state[4], const uint32_t x[16]);
 static void Encode(uint8_t *output, const uint32_t *input, size_t len);
 static void Decode(uint32_t *output, const uint8_t *input, size_t len);
 
@@ -116,9 +102,19 @@ static void MD5Final(uint8_t digest[MD5_DIGEST_LENGTH], MD5_CTX *context) {
 }
 
 static void MD5Transform(uint32_t state[4], const uint8_t block[64]) {
-    uint32_t a = state[0], b = state[1], c = state[2], d = state[3], x[16];
+    uint32_t x[16];
 
     Decode(x, block, 64);
+    MD5Compress(state, x);
+
+    memset(x, 0, sizeof(x));
+}
+
+/**
+ * Função de compressão sobre as 16 palavras já decodificadas do bloco
+ */
+static void MD5Compress(uint32_t state[4], const uint32_t x[16]) {
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
 
     FF(a, b, c, d, x[ 0], S11, 0xd76aa478);
     FF(d, a, b, c, x[ 1], S12, 0xe8c7b756);
@@ -192,8 +188,6 @@ static void MD5Transform(uint32_t state[4], const uint8_t block[64]) {
     state[1] += b;
     state[2] += c;
     state[3] += d;
-
-    memset(x, 0, sizeof(x));
 }
 
 static void Encode(uint8_t *output, const uint32_t *input, size_t len) {
@@ -241,4 +235,289 @@ void md5_string(const char *input, char output[33]) {
         sprintf(output + (i * 2), "%02x", digest[i]);
     }
     output[32] = '\0';
-}
\ No newline at end of file
+}
+
+/**
+ * Estado MD5 de uma entrada de qualquer tamanho (vários blocos)
+ */
+void md5_bytes(const char *input, size_t len, uint32_t state[4]) {
+    MD5_CTX ctx;
+    uint8_t digest[MD5_DIGEST_LENGTH];
+
+    MD5Init(&ctx);
+    MD5Update(&ctx, (const uint8_t *)input, len);
+    MD5Final(digest, &ctx);
+    Decode(state, digest, MD5_DIGEST_LENGTH);
+}
+
+/**
+ * Prepara um bloco de passo único: entrada, padding 0x80 e comprimento em bits
+ */
+int md5_block_init(MD5Block *block, const char *input, size_t len) {
+    if (len > MD5_BLOCK_MAX_INPUT) {
+        return -1;
+    }
+
+    memset(block, 0, sizeof(*block));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    // As palavras little-endian já são os bytes da entrada em ordem
+    memcpy(block->x, input, len);
+#else
+    for (size_t i = 0; i < len; i++) {
+        md5_block_set_byte(block, i, (uint8_t)input[i]);
+    }
+#endif
+    md5_block_set_byte(block, len, 0x80);
+    block->x[14] = (uint32_t)(len << 3);
+
+    return 0;
+}
+
+void md5_block_finish(MD5Block *block, size_t len) {
+    uint8_t *bytes = md5_block_bytes(block);
+    memset(bytes + len, 0, sizeof(*block) - len);
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+    // Os bytes foram escritos em ordem de memória; as palavras são little-endian
+    for (size_t i = 0; i < (len + 3) / 4; i++) {
+        block->x[i] = __builtin_bswap32(block->x[i]);
+    }
+#endif
+    md5_block_set_byte(block, len, 0x80);
+    block->x[14] = (uint32_t)(len << 3);
+}
+
+/**
+ * MD5 de um bloco preparado: uma compressão a partir do vetor inicial
+ */
+void md5_block_hash(const MD5Block *block, uint32_t state[4]) {
+    state[0] = 0x67452301;
+    state[1] = 0xefcdab89;
+    state[2] = 0x98badcfe;
+    state[3] = 0x10325476;
+    MD5Compress(state, block->x);
+}
+
+void md5_block_compress(uint32_t state[4], const MD5Block *block) {
+    MD5Compress(state, block->x);
+}
+
+/**
+ * Blocos inteiros do prefixo, sem padding: o estado fica no meio da mensagem
+ */
+void md5_midstate(const void *data, size_t num_blocks, uint32_t state[4]) {
+    state[0] = 0x67452301;
+    state[1] = 0xefcdab89;
+    state[2] = 0x98badcfe;
+    state[3] = 0x10325476;
+    for (size_t i = 0; i < num_blocks; i++) {
+        MD5Transform(state, (const uint8_t *)data + i * MD5_BLOCK_SIZE);
+    }
+}
+
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/**
+ * Decodifica um hash hexadecimal para o estado bruto (ordem de Encode())
+ */
+int md5_hex_to_state(const char *hex, uint32_t state[4]) {
+    uint8_t digest[MD5_DIGEST_LENGTH];
+    int i;
+
+    if (hex == NULL || strlen(hex) != 2 * MD5_DIGEST_LENGTH) {
+        return -1;
+    }
+
+    for (i = 0; i < MD5_DIGEST_LENGTH; i++) {
+        int hi = hex_value(hex[2 * i]);
+        int lo = hex_value(hex[2 * i + 1]);
+        if (hi < 0 || lo < 0) {
+            return -1;
+        }
+        digest[i] = (uint8_t)((hi << 4) | lo);
+    }
+
+    Decode(state, digest, MD5_DIGEST_LENGTH);
+    return 0;
+}
+
+/**
+ * Converte o estado bruto para hexadecimal sem passar por sprintf
+ */
+void md5_state_to_hex(const uint32_t state[4], char output[33]) {
+    static const char digits[] = "0123456789abcdef";
+    uint8_t digest[MD5_DIGEST_LENGTH];
+    int i;
+
+    Encode(digest, state, MD5_DIGEST_LENGTH);
+    for (i = 0; i < MD5_DIGEST_LENGTH; i++) {
+        output[2 * i] = digits[digest[i] >> 4];
+        output[2 * i + 1] = digits[digest[i] & 0x0f];
+    }
+    output[32] = '\0';
+}
+
+MD5Isa md5_isa_best(void) {
+    // Threads fixadas podem chegar aqui ao mesmo tempo; todas calculam o mesmo
+    // valor, então basta que a leitura e a escrita sejam atômicas
+    static atomic_int best = -1;
+    int cached = atomic_load_explicit(&best, memory_order_relaxed);
+
+    if (cached < 0) {
+        MD5Isa isa = MD5_ISA_SCALAR;
+#ifdef MD5_HAVE_X86_SIMD
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            isa = MD5_ISA_AVX512;
+        } else if (__builtin_cpu_supports("avx2")) {
+            isa = MD5_ISA_AVX2;
+        } else if (__builtin_cpu_supports("sse2")) {
+            isa = MD5_ISA_SSE2;
+        }
+#endif
+        cached = isa;
+        atomic_store_explicit(&best, cached, memory_order_relaxed);
+    }
+    return (MD5Isa)cached;
+}
+
+int md5_isa_supported(MD5Isa isa) {
+    return isa >= MD5_ISA_SCALAR && isa <= md5_isa_best();
+}
+
+int md5_isa_lanes(MD5Isa isa) {
+    static const int lanes[MD5_ISA_COUNT] = {1, 4, 8, 16};
+    return (isa >= 0 && isa < MD5_ISA_COUNT) ? lanes[isa] : 1;
+}
+
+const char *md5_isa_name(MD5Isa isa) {
+    static const char *names[MD5_ISA_COUNT] = {"scalar", "sse2", "avx2", "avx512"};
+    return (isa >= 0 && isa < MD5_ISA_COUNT) ? names[isa] : "?";
+}
+
+static const uint32_t md5_iv[4] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476};
+
+/**
+ * Lote a partir de um estado inicial qualquer (vetor inicial ou midstate)
+ */
+static void md5_batch_dispatch(MD5Isa isa, const uint32_t init[4], const MD5Block *blocks,
+                               size_t n, uint32_t (*states)[4]) {
+    size_t i = 0;
+
+    if (!md5_isa_supported(isa)) {
+        isa = MD5_ISA_SCALAR;
+    }
+
+#ifdef MD5_HAVE_X86_SIMD
+    size_t lanes = (size_t)md5_isa_lanes(isa);
+    for (; isa != MD5_ISA_SCALAR && i + lanes <= n; i += lanes) {
+        switch (isa) {
+            case MD5_ISA_AVX512: md5_batch_avx512(init, &blocks[i], &states[i]); break;
+            case MD5_ISA_AVX2:   md5_batch_avx2(init, &blocks[i], &states[i]); break;
+            default:             md5_batch_sse2(init, &blocks[i], &states[i]); break;
+        }
+    }
+#endif
+
+    // Restante (ou CPU sem SIMD): caminho escalar de referência
+    for (; i < n; i++) {
+        memcpy(states[i], init, sizeof(states[i]));
+        MD5Compress(states[i], blocks[i].x);
+    }
+}
+
+void md5_batch_isa(MD5Isa isa, const MD5Block *blocks, size_t n, uint32_t (*states)[4]) {
+    md5_batch_dispatch(isa, md5_iv, blocks, n, states);
+}
+
+void md5_batch_from_isa(MD5Isa isa, const uint32_t init[4], const MD5Block *blocks, size_t n,
+                        uint32_t (*states)[4]) {
+    md5_batch_dispatch(isa, init, blocks, n, states);
+}
+
+void md5_batch(const MD5Block *blocks, size_t n, uint32_t (*states)[4]) {
+    md5_batch_dispatch(md5_isa_best(), md5_iv, blocks, n, states);
+}
+
+void md5_batch_from(const uint32_t init[4], const MD5Block *blocks, size_t n,
+                    uint32_t (*states)[4]) {
+    md5_batch_dispatch(md5_isa_best(), init, blocks, n, states);
+}
+
+/*
+ * Núcleos escalares especializados por comprimento (ver MD5ScanFn)
+ * Gerados a partir de um corpo só, instanciado com len constante para cada
+ * comprimento de MD5_FOR_EACH_SCAN_LENGTH.
+ */
+#define SCAN_WORD(w, ac) ((w) == v ? xv + (uint32_t)(ac) : xs[w] + (uint32_t)(ac))
+
+#define SCAN_STEP(n, f, a, b, c, d, w, s, ac) \
+    if ((n) >= v && (n) <= stop - 4) { \
+        (a) += MD5_##f((b), (c), (d)) + SCAN_WORD(w, ac); \
+        (a) = MD5_ROTL((a), (s)); \
+        (a) += (b); \
+    }
+
+static inline __attribute__((always_inline))
+int md5_scan_scalar(const uint32_t init[4], const MD5Block *block, const uint8_t *values,
+                    int count, const uint32_t target[4], const int len) {
+    const int pos = len - 1, v = pos >> 2, shift = (pos & 3) * 8;
+    uint32_t xs[16], pre[4];
+
+    md5_scan_words(xs, block);
+    md5_steps_prefix(pre, init, xs, v);
+    const uint32_t base = xs[v] & ~((uint32_t)0xff << shift);
+    const int stop = MD5_REVERSE_STOP(v);
+    const uint32_t check = md5_steps_reverse(target, init, xs, v);
+
+    for (int k = 0; k < count; k++) {
+        uint32_t xv = base | ((uint32_t)values[k] << shift);
+        uint32_t a = pre[0], b = pre[1], c = pre[2], d = pre[3];
+
+        MD5_STEPS(SCAN_STEP)
+
+        if (MD5_STEP_REGISTER(stop, a, b, c, d) + xv == check) {
+            MD5Block candidate = *block;
+            uint32_t state[4];
+            md5_block_set_byte(&candidate, pos, values[k]);
+            memcpy(state, init, sizeof(state));
+            md5_block_compress(state, &candidate);
+            if (md5_state_equal(state, target)) {
+                return k;
+            }
+        }
+    }
+    return -1;
+}
+
+#define SCAN_LEN(L) \
+    static int md5_scan_scalar_len##L(const uint32_t init[4], const MD5Block *block, \
+                                      const uint8_t *values, int count, \
+                                      const uint32_t target[4]) { \
+        return md5_scan_scalar(init, block, values, count, target, L); \
+    }
+MD5_FOR_EACH_SCAN_LENGTH(SCAN_LEN)
+
+#define SCAN_ENTRY(L) md5_scan_scalar_len##L,
+static const MD5ScanFn md5_scan_scalar_table[MD5_BLOCK_MAX_INPUT + 1] = {
+    NULL, MD5_FOR_EACH_SCAN_LENGTH(SCAN_ENTRY)
+};
+
+MD5ScanFn md5_scan_kernel(MD5Isa isa, size_t len) {
+    if (len < 1 || len > MD5_BLOCK_MAX_INPUT || !md5_isa_supported(isa)) {
+        return NULL;
+    }
+
+    switch (isa) {
+#ifdef MD5_HAVE_X86_SIMD
+        case MD5_ISA_AVX512: return md5_scan_avx512_table[len];
+        case MD5_ISA_AVX2:   return md5_scan_avx2_table[len];
+        case MD5_ISA_SSE2:   return md5_scan_sse2_table[len];
+#endif
+        default:             return md5_scan_scalar_table[len];
+    }
+}
@@ -7,6 +7,19 @@
 #include <stdint.h>
 
 #define MD5_DIGEST_LENGTH 16
+#define MD5_BLOCK_SIZE 64       // Bytes de mensagem por compressão
+#define MD5_BLOCK_MAX_INPUT 55  // Maior entrada que cabe em um único bloco de 64 bytes
+#define MD5_BATCH_MAX 16        // Maior largura de md5_batch() (AVX-512)
+
+/**
+ * Bloco MD5 de 64 bytes já formatado: entrada, byte 0x80 de padding e
+ * comprimento em bits nas palavras finais. Guardado como 16 palavras
+ * little-endian, exatamente como MD5Transform as consome, para que o laço de
+ * quebra altere apenas os bytes da senha e chame a compressão diretamente.
+ */
+typedef struct {
+    uint32_t x[16];
+} MD5Block;
 
 /**
  * Computa o hash MD5 de uma string de entrada
@@ -21,4 +34,193 @@
  */
 void md5_string(const char *input, char output[33]);
 
+/**
+ * Prepara um bloco MD5 de passo único para uma entrada de até 55 bytes
+ *
+ * @param block Bloco a ser preenchido (padding e comprimento incluídos)
+ * @param input Bytes da entrada (não precisa terminar em '\0')
+ * @param len Comprimento da entrada em bytes
+ * @return 0 em caso de sucesso, -1 se len > MD5_BLOCK_MAX_INPUT
+ */
+int md5_block_init(MD5Block *block, const char *input, size_t len);
+
+/**
+ * Bytes da entrada vistos como buffer de trabalho, em ordem
+ * Quem escreve por aqui (ex.: o motor de regras) monta a entrada no próprio
+ * bloco e depois chama md5_block_finish() para formatá-lo.
+ */
+static inline uint8_t *md5_block_bytes(MD5Block *block) {
+    return (uint8_t *)block->x;
+}
+
+/**
+ * Completa um bloco cujos primeiros len bytes foram escritos via
+ * md5_block_bytes(): zera o resto, coloca padding e comprimento
+ *
+ * @param len Comprimento da entrada, até MD5_BLOCK_MAX_INPUT
+ */
+void md5_block_finish(MD5Block *block, size_t len);
+
+/**
+ * Altera um byte da entrada dentro de um bloco já preparado
+ * Não mexe em padding nem comprimento: serve para trocar caracteres da senha.
+ */
+static inline void md5_block_set_byte(MD5Block *block, size_t pos, uint8_t value) {
+    uint32_t shift = (uint32_t)(pos & 3) * 8;
+    block->x[pos >> 2] = (block->x[pos >> 2] & ~((uint32_t)0xff << shift)) |
+                         ((uint32_t)value << shift);
+}
+
+/**
+ * Lê um byte da entrada de um bloco preparado
+ */
+static inline uint8_t md5_block_get_byte(const MD5Block *block, size_t pos) {
+    return (uint8_t)(block->x[pos >> 2] >> ((pos & 3) * 8));
+}
+
+/**
+ * Calcula o MD5 de um bloco preparado com uma única chamada de compressão
+ *
+ * @param block Bloco preparado por md5_block_init()
+ * @param state Saída: estado bruto (4 palavras), sem conversão para hex
+ */
+void md5_block_hash(const MD5Block *block, uint32_t state[4]);
+
+/**
+ * Aplica uma compressão ao estado: o último bloco de uma mensagem cujos
+ * blocos anteriores já estão em state (ver md5_midstate())
+ */
+void md5_block_compress(uint32_t state[4], const MD5Block *block);
+
+/**
+ * Estado depois dos primeiros num_blocks blocos de 64 bytes de data (midstate)
+ * Um prefixo fixo que ocupa blocos inteiros é comprimido uma única vez, e cada
+ * candidato continua dali com uma só compressão. Com num_blocks 0, devolve o
+ * vetor inicial.
+ */
+void md5_midstate(const void *data, size_t num_blocks, uint32_t state[4]);
+
+/**
+ * Calcula o MD5 de uma entrada de qualquer tamanho, devolvendo o estado bruto
+ * Caminho lento (MD5Update com cópia): para entradas que não cabem em um bloco.
+ *
+ * @param input Bytes da entrada (não precisa terminar em '\0')
+ */
+void md5_bytes(const char *input, size_t len, uint32_t state[4]);
+
+/**
+ * Conjuntos de instruções disponíveis para md5_batch()
+ */
+typedef enum {
+    MD5_ISA_SCALAR = 0,  // 1 lane - caminho de referência
+    MD5_ISA_SSE2,        // 4 lanes
+    MD5_ISA_AVX2,        // 8 lanes
+    MD5_ISA_AVX512,      // 16 lanes
+    MD5_ISA_COUNT
+} MD5Isa;
+
+/**
+ * Retorna o conjunto mais largo suportado pela CPU (detectado uma única vez)
+ */
+MD5Isa md5_isa_best(void);
+
+/**
+ * @return 1 se a CPU atual suporta o conjunto de instruções, 0 caso contrário
+ */
+int md5_isa_supported(MD5Isa isa);
+
+/**
+ * @return Número de blocos processados juntos pelo conjunto (1, 4, 8 ou 16)
+ */
+int md5_isa_lanes(MD5Isa isa);
+
+/**
+ * @return Nome legível do conjunto ("scalar", "sse2", "avx2", "avx512")
+ */
+const char *md5_isa_name(MD5Isa isa);
+
+/**
+ * Calcula o MD5 de n blocos preparados, vários por vez em registradores vetoriais
+ * Usa o conjunto de instruções mais largo disponível; o que não completa uma
+ * largura inteira é processado pelo caminho escalar (md5_block_hash).
+ *
+ * @param blocks Blocos preparados por md5_block_init()
+ * @param n Quantidade de blocos
+ * @param states Saída: estado bruto de cada bloco, na mesma ordem
+ *
+ * Exemplo de uso:
+ *   MD5Block blocks[MD5_BATCH_MAX];
+ *   uint32_t states[MD5_BATCH_MAX][4];
+ *   md5_batch(blocks, md5_isa_lanes(md5_isa_best()), states);
+ */
+void md5_batch(const MD5Block *blocks, size_t n, uint32_t (*states)[4]);
+
+/**
+ * Igual a md5_batch(), mas cada bloco é comprimido a partir de init (o
+ * midstate de um prefixo) em vez do vetor inicial
+ */
+void md5_batch_from(const uint32_t init[4], const MD5Block *blocks, size_t n,
+                    uint32_t (*states)[4]);
+
+/**
+ * Igual a md5_batch(), mas forçando um conjunto de instruções específico
+ * (para testes e comparações). Cai no caminho escalar se não for suportado.
+ */
+void md5_batch_isa(MD5Isa isa, const MD5Block *blocks, size_t n, uint32_t (*states)[4]);
+
+/**
+ * Igual a md5_batch_from(), mas forçando um conjunto de instruções específico
+ */
+void md5_batch_from_isa(MD5Isa isa, const uint32_t init[4], const MD5Block *blocks, size_t n,
+                        uint32_t (*states)[4]);
+
+/**
+ * Núcleo especializado para um comprimento de senha fixo
+ *
+ * Recebe o último bloco de uma mensagem, já formatado, em que o caractere
+ * varrido fica na posição len - 1, e testa count valores nessa posição a
+ * partir do estado init (vetor inicial ou midstate). Retorna o índice do
+ * primeiro valor cujo MD5 é target, ou -1. A posição é constante de
+ * compilação: os passos anteriores à palavra que varia são feitos uma vez, e
+ * as palavras que não mudam no laço são tiradas dele. Do outro lado, os passos
+ * finais da rodada 4 que não usam essa palavra são desfeitos a partir de target
+ * (md5_steps_reverse em md5_steps.h): cada candidato para 4 passos antes do
+ * último uso da palavra e compara uma só palavra de 32 bits (senhas de 5 a 8
+ * bytes: 51 passos em vez de 60; de 1 a 4 bytes: 45 em vez de 61).
+ */
+typedef int (*MD5ScanFn)(const uint32_t init[4], const MD5Block *block, const uint8_t *values,
+                         int count, const uint32_t target[4]);
+
+/**
+ * Seleciona o núcleo especializado para senhas de len bytes
+ *
+ * @param isa Conjunto de instruções (MD5_ISA_SCALAR = uma senha por vez)
+ * @param len Posição do último caractere + 1, de 1 a MD5_BLOCK_MAX_INPUT (o
+ *            comprimento da senha, mais o que houver de prefixo no bloco)
+ * @return Núcleo, ou NULL se len estiver fora do intervalo ou isa não suportado
+ */
+MD5ScanFn md5_scan_kernel(MD5Isa isa, size_t len);
+
+/**
+ * Converte um hash em hexadecimal (32 caracteres) para o estado bruto
+ * Feito uma única vez por busca, para que cada candidato seja comparado
+ * com quatro comparações de inteiros em vez de sprintf + strcmp.
+ *
+ * @return 0 em caso de sucesso, -1 se a string não for um MD5 hex válido
+ */
+int md5_hex_to_state(const char *hex, uint32_t state[4]);
+
+/**
+ * Converte um estado bruto para a string hexadecimal usual (33 bytes)
+ */
+void md5_state_to_hex(const uint32_t state[4], char output[33]);
+
+/**
+ * Compara dois estados MD5 brutos
+ * @return 1 se iguais, 0 caso contrário
+ */
+static inline int md5_state_equal(const uint32_t a[4], const uint32_t b[4]) {
+    return ((a[0] ^ b[0]) | (a[1] ^ b[1]) | (a[2] ^ b[2]) | (a[3] ^ b[3])) == 0;
+}
+
 #endif // HASH_UTILS_H
\ No newline at end of file
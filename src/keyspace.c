@@ -0,0 +1,432 @@
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include "keyspace.h"
+#include "hash_utils.h"
+
+#define CHARSET_LOWER   "abcdefghijklmnopqrstuvwxyz"
+#define CHARSET_UPPER   "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+#define CHARSET_DIGITS  "0123456789"
+#define CHARSET_SYMBOLS " !\"#$%&'()*+,-./:;<=>?@[\\]^_`{|}~"
+
+/**
+ * Acrescenta caracteres a um charset, ignorando os que já estão nele
+ */
+static void set_append(char *set, int *len, const char *chars) {
+    for (; *chars != '\0'; chars++) {
+        if (memchr(set, *chars, *len) == NULL) {
+            set[(*len)++] = *chars;
+        }
+    }
+    set[*len] = '\0';
+}
+
+/**
+ * Expande uma classe "?x" (exceto ?1 a ?4) no charset
+ *
+ * @return 0 em caso de sucesso, -1 se a classe não existe
+ */
+static int set_append_class(char *set, int *len, char class) {
+    switch (class) {
+        case 'l': set_append(set, len, CHARSET_LOWER); return 0;
+        case 'u': set_append(set, len, CHARSET_UPPER); return 0;
+        case 'd': set_append(set, len, CHARSET_DIGITS); return 0;
+        case 's': set_append(set, len, CHARSET_SYMBOLS); return 0;
+        case 'a':
+            set_append(set, len, CHARSET_LOWER CHARSET_UPPER CHARSET_DIGITS CHARSET_SYMBOLS);
+            return 0;
+        case '?': set_append(set, len, "?"); return 0;
+        default: return -1;
+    }
+}
+
+int keyspace_init_charset(Keyspace *ks, const char *charset, int password_len) {
+    if (password_len < 1 || password_len > MAX_PASSWORD_LEN || charset[0] == '\0') {
+        return -1;
+    }
+
+    ks->length = password_len;
+    ks->prefix_len = 0;
+    ks->suffix_len = 0;
+    ks->order.enabled = 0;
+    for (int i = 0; i < password_len; i++) {
+        ks->set_len[i] = 0;
+        set_append(ks->sets[i], &ks->set_len[i], charset);
+    }
+    return 0;
+}
+
+int keyspace_init_mask(Keyspace *ks, const char *mask, const char *const custom[MASK_CUSTOM_SETS]) {
+    // Charsets personalizados, já com as classes expandidas
+    char custom_sets[MASK_CUSTOM_SETS][KEYSPACE_SET_MAX + 1];
+    int custom_len[MASK_CUSTOM_SETS];
+
+    for (int c = 0; c < MASK_CUSTOM_SETS; c++) {
+        custom_len[c] = 0;
+        custom_sets[c][0] = '\0';
+        for (const char *p = custom[c]; p != NULL && *p != '\0'; p++) {
+            if (*p == '?' && p[1] != '\0') {
+                if (set_append_class(custom_sets[c], &custom_len[c], *++p) != 0) {
+                    fprintf(stderr, "Erro: Classe '?%c' inválida no charset ?%d\n", *p, c + 1);
+                    return -1;
+                }
+            } else {
+                char literal[2] = {*p, '\0'};
+                set_append(custom_sets[c], &custom_len[c], literal);
+            }
+        }
+    }
+
+    ks->length = 0;
+    ks->prefix_len = 0;
+    ks->suffix_len = 0;
+    ks->order.enabled = 0;
+    for (const char *p = mask; *p != '\0'; p++) {
+        if (ks->length == MAX_PASSWORD_LEN) {
+            fprintf(stderr, "Erro: Máscara com mais de %d posições\n", MAX_PASSWORD_LEN);
+            return -1;
+        }
+
+        char *set = ks->sets[ks->length];
+        int *len = &ks->set_len[ks->length];
+        *len = 0;
+        set[0] = '\0';
+
+        if (*p != '?') {
+            char literal[2] = {*p, '\0'};
+            set_append(set, len, literal);
+        } else if (p[1] >= '1' && p[1] < '1' + MASK_CUSTOM_SETS) {
+            int c = *++p - '1';
+            if (custom_len[c] == 0) {
+                fprintf(stderr, "Erro: ?%d usado na máscara sem charset definido (-%d)\n",
+                        c + 1, c + 1);
+                return -1;
+            }
+            set_append(set, len, custom_sets[c]);
+        } else if (p[1] == '\0') {
+            fprintf(stderr, "Erro: '?' sem classe no fim da máscara (use ?? para '?')\n");
+            return -1;
+        } else if (set_append_class(set, len, p[1]) != 0) {
+            fprintf(stderr, "Erro: Classe '?%c' inválida na máscara\n", p[1]);
+            return -1;
+        } else {
+            p++;
+        }
+        ks->length++;
+    }
+
+    if (ks->length == 0) {
+        fprintf(stderr, "Erro: Máscara vazia\n");
+        return -1;
+    }
+    return 0;
+}
+
+int keyspace_set_affixes(Keyspace *ks, const char *prefix, const char *suffix) {
+    size_t prefix_len = prefix != NULL ? strlen(prefix) : 0;
+    size_t suffix_len = suffix != NULL ? strlen(suffix) : 0;
+
+    if (prefix_len > KEYSPACE_PREFIX_MAX) {
+        fprintf(stderr, "Erro: Prefixo com mais de %d bytes\n", KEYSPACE_PREFIX_MAX);
+        return -1;
+    }
+    size_t last_block = prefix_len % MD5_BLOCK_SIZE + ks->length + suffix_len;
+    if (last_block > MD5_BLOCK_MAX_INPUT) {
+        fprintf(stderr, "Erro: Fim do prefixo (%zu), senha (%d) e sufixo (%zu) somam %zu bytes; "
+                "o último bloco MD5 comporta %d\n", prefix_len % MD5_BLOCK_SIZE, ks->length,
+                suffix_len, last_block, MD5_BLOCK_MAX_INPUT);
+        return -1;
+    }
+
+    ks->prefix_len = (int)prefix_len;
+    ks->suffix_len = (int)suffix_len;
+    // Sem prefixo ou sufixo o ponteiro é NULL, e memcpy não o aceita nem com 0 bytes
+    if (prefix_len > 0) {
+        memcpy(ks->prefix, prefix, prefix_len);
+    }
+    if (suffix_len > 0) {
+        memcpy(ks->suffix, suffix, suffix_len);
+    }
+    return 0;
+}
+
+int keyspace_block_offset(const Keyspace *ks) {
+    return ks->prefix_len % MD5_BLOCK_SIZE;
+}
+
+void keyspace_candidate(const Keyspace *ks, const char *password, char *output) {
+    memcpy(output, ks->prefix, ks->prefix_len);
+    memcpy(output + ks->prefix_len, password, ks->length);
+    memcpy(output + ks->prefix_len + ks->length, ks->suffix, ks->suffix_len);
+    output[ks->prefix_len + ks->length + ks->suffix_len] = '\0';
+}
+
+KeyspaceIndex keyspace_size(const Keyspace *ks) {
+    KeyspaceIndex total = 1;
+    for (int i = 0; i < ks->length; i++) {
+        if (total > KEYSPACE_INDEX_MAX / ks->set_len[i]) {
+            return -1;
+        }
+        total *= ks->set_len[i];
+    }
+    return total;
+}
+
+KeyspaceIndex keyspace_partition(KeyspaceIndex total, int parts, int part, KeyspaceIndex *count) {
+    KeyspaceIndex per_part = total / parts;
+    int remainder = (int)(total % parts);
+
+    *count = per_part + (part < remainder ? 1 : 0);
+    return per_part * part + (part < remainder ? part : remainder);
+}
+
+const char *keyspace_index_str(KeyspaceIndex value, char buffer[KEYSPACE_INDEX_STR]) {
+    char digits[KEYSPACE_INDEX_STR];
+    int n = 0;
+    unsigned __int128 magnitude = value < 0 ? -(unsigned __int128)value : (unsigned __int128)value;
+
+    do {
+        digits[n++] = (char)('0' + (int)(magnitude % 10));
+        magnitude /= 10;
+    } while (magnitude > 0);
+
+    char *p = buffer;
+    if (value < 0) {
+        *p++ = '-';
+    }
+    while (n > 0) {
+        *p++ = digits[--n];
+    }
+    *p = '\0';
+    return buffer;
+}
+
+const char *keyspace_index_parse(const char *text, KeyspaceIndex *value) {
+    while (*text == ' ' || *text == '\t') {
+        text++;
+    }
+    if (*text < '0' || *text > '9') {
+        return NULL;
+    }
+
+    KeyspaceIndex result = 0;
+    for (; *text >= '0' && *text <= '9'; text++) {
+        int digit = *text - '0';
+        if (result > (KEYSPACE_INDEX_MAX - digit) / 10) {
+            return NULL;
+        }
+        result = result * 10 + digit;
+    }
+    *value = result;
+    return text;
+}
+
+static inline int level_start(const KeyspaceOrder *order, int pos, int level) {
+    return level == 0 ? 0 : order->level_end[pos][level - 1];
+}
+
+static inline int level_size(const KeyspaceOrder *order, int pos, int level) {
+    return order->level_end[pos][level] - level_start(order, pos, level);
+}
+
+int keyspace_order_prepare(Keyspace *ks) {
+    KeyspaceOrder *order = &ks->order;
+    if (ks->length > KEYSPACE_ORDER_MAX_LEN || keyspace_size(ks) < 0) {
+        return -1;
+    }
+    for (int i = 0; i < ks->length; i++) {
+        for (int l = 0; l < KEYSPACE_LEVELS; l++) {
+            if (level_size(order, i, l) < 0) {
+                return -1;
+            }
+        }
+        if (order->level_end[i][KEYSPACE_LEVELS - 1] != ks->set_len[i]) {
+            return -1;
+        }
+    }
+
+    // count[i][t] = soma sobre os níveis l da posição i de
+    //               (caracteres no nível l) x count[i + 1][t - l]
+    memset(order->count, 0, sizeof(order->count));
+    order->count[ks->length][0] = 1;
+    for (int i = ks->length - 1; i >= 0; i--) {
+        for (int t = 0; t <= KEYSPACE_LEVEL_SUM_MAX; t++) {
+            for (int l = 0; l < KEYSPACE_LEVELS && l <= t; l++) {
+                order->count[i][t] += level_size(order, i, l) * order->count[i + 1][t - l];
+            }
+        }
+    }
+    order->enabled = 1;
+    return 0;
+}
+
+int keyspace_level_of(const Keyspace *ks, int pos, int digit) {
+    int level = 0;
+    while (digit >= ks->order.level_end[pos][level]) {
+        level++;
+    }
+    return level;
+}
+
+int keyspace_row_length(const Keyspace *ks) {
+    int last = ks->length - 1;
+    if (!ks->order.enabled) {
+        return ks->set_len[last];
+    }
+    int rows = 0;
+    for (int l = 0; l < KEYSPACE_LEVELS; l++) {
+        rows += level_size(&ks->order, last, l) > 0;
+    }
+    return ks->set_len[last] / rows;
+}
+
+/**
+ * Primeiro candidato (na ordem Markov) das posições pos em diante com soma de
+ * níveis t: em cada posição, o menor nível que ainda deixa o resto possível
+ */
+static void first_from(const Keyspace *ks, int pos, int t, int digits[], int levels[]) {
+    const KeyspaceOrder *order = &ks->order;
+    for (int i = pos; i < ks->length; i++) {
+        int l = 0;
+        while (level_size(order, i, l) == 0 || order->count[i + 1][t - l] == 0) {
+            l++;
+        }
+        levels[i] = l;
+        digits[i] = level_start(order, i, l);
+        t -= l;
+    }
+}
+
+void keyspace_index_to_digits(const Keyspace *ks, KeyspaceIndex index, int digits[], int levels[]) {
+    if (!ks->order.enabled) {
+        // Base mista, do último dígito (menos significativo) ao primeiro; a
+        // divisão de 128 bits é uma chamada de biblioteca, então só enquanto
+        // o índice não cabe em 64
+        int i = ks->length - 1;
+        for (; i >= 0 && index > LLONG_MAX; i--) {
+            digits[i] = (int)(index % ks->set_len[i]);
+            index /= ks->set_len[i];
+            levels[i] = 0;
+        }
+        long long small = (long long)index;
+        for (; i >= 0; i--) {
+            digits[i] = (int)(small % ks->set_len[i]);
+            small /= ks->set_len[i];
+            levels[i] = 0;
+        }
+        return;
+    }
+
+    // Soma de níveis do índice, depois um nível e um caractere por posição
+    const KeyspaceOrder *order = &ks->order;
+    int t = 0;
+    while (index >= order->count[0][t]) {
+        index -= order->count[0][t++];
+    }
+    for (int i = 0; i < ks->length; i++) {
+        for (int l = 0; l < KEYSPACE_LEVELS && l <= t; l++) {
+            KeyspaceIndex rest = order->count[i + 1][t - l];
+            KeyspaceIndex block = level_size(order, i, l) * rest;
+            if (index < block) {
+                levels[i] = l;
+                digits[i] = level_start(order, i, l) + (int)(index / rest);
+                index %= rest;
+                t -= l;
+                break;
+            }
+            index -= block;
+        }
+    }
+}
+
+int keyspace_next_row(const Keyspace *ks, int digits[], int levels[]) {
+    const KeyspaceOrder *order = &ks->order;
+    int remaining[MAX_PASSWORD_LEN + 1];  // Soma de níveis das posições i em diante
+
+    remaining[0] = 0;
+    for (int i = 0; i < ks->length; i++) {
+        remaining[0] += levels[i];
+    }
+    for (int i = 1; i <= ks->length; i++) {
+        remaining[i] = remaining[i - 1] - levels[i - 1];
+    }
+
+    // O último nível é fixado pelos anteriores: o "vai um" começa na penúltima posição
+    for (int i = ks->length - 2; i >= 0; i--) {
+        if (digits[i] + 1 < order->level_end[i][levels[i]]) {
+            digits[i]++;
+            first_from(ks, i + 1, remaining[i + 1], digits, levels);
+            return 1;
+        }
+        for (int l = levels[i] + 1; l < KEYSPACE_LEVELS && l <= remaining[i]; l++) {
+            if (level_size(order, i, l) > 0 && order->count[i + 1][remaining[i] - l] > 0) {
+                levels[i] = l;
+                digits[i] = level_start(order, i, l);
+                first_from(ks, i + 1, remaining[i] - l, digits, levels);
+                return 1;
+            }
+        }
+    }
+
+    // Soma seguinte (candidatos menos prováveis)
+    for (int t = remaining[0] + 1; t <= KEYSPACE_LEVEL_SUM_MAX; t++) {
+        if (order->count[0][t] > 0) {
+            first_from(ks, 0, t, digits, levels);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void keyspace_index_to_password(const Keyspace *ks, KeyspaceIndex index, char *output) {
+    int digits[MAX_PASSWORD_LEN], levels[MAX_PASSWORD_LEN];
+
+    keyspace_index_to_digits(ks, index, digits, levels);
+    for (int i = 0; i < ks->length; i++) {
+        output[i] = ks->sets[i][digits[i]];
+    }
+    output[ks->length] = '\0';
+}
+
+KeyspaceIndex keyspace_password_to_index(const Keyspace *ks, const char *password) {
+    int digits[MAX_PASSWORD_LEN];
+    if ((int)strlen(password) != ks->length) {
+        return -1;
+    }
+    for (int i = 0; i < ks->length; i++) {
+        const char *pos = memchr(ks->sets[i], password[i], ks->set_len[i]);
+        if (pos == NULL) {
+            return -1;
+        }
+        digits[i] = (int)(pos - ks->sets[i]);
+    }
+
+    KeyspaceIndex index = 0;
+    if (!ks->order.enabled) {
+        for (int i = 0; i < ks->length; i++) {
+            index = index * ks->set_len[i] + digits[i];
+        }
+        return index;
+    }
+
+    // Inverso de keyspace_index_to_digits: somas menores, depois os níveis e
+    // caracteres anteriores em cada posição
+    const KeyspaceOrder *order = &ks->order;
+    int levels[MAX_PASSWORD_LEN];
+    int t = 0;
+    for (int i = 0; i < ks->length; i++) {
+        levels[i] = keyspace_level_of(ks, i, digits[i]);
+        t += levels[i];
+    }
+    for (int s = 0; s < t; s++) {
+        index += order->count[0][s];
+    }
+    for (int i = 0; i < ks->length; i++) {
+        for (int l = 0; l < levels[i]; l++) {
+            index += level_size(order, i, l) * order->count[i + 1][t - l];
+        }
+        index += (digits[i] - level_start(order, i, levels[i])) * order->count[i + 1][t - levels[i]];
+        t -= levels[i];
+    }
+    return index;
+}
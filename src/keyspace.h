@@ -0,0 +1,212 @@
+#ifndef KEYSPACE_H
+#define KEYSPACE_H
+
+/**
+ * Espaço de busca: conversão entre índices numéricos e senhas
+ * Compartilhado entre coordinator (divisão do trabalho) e workers (blocos
+ * de índices buscados na fila compartilhada).
+ *
+ * Cada posição da senha tem o seu próprio charset, e o índice é um número em
+ * base mista: o último caractere é o dígito menos significativo, na base do
+ * charset da sua posição. O modo clássico (um charset para todas as posições)
+ * é o caso particular em que todas as bases são iguais.
+ */
+
+#define MAX_PASSWORD_LEN 55    // Um bloco MD5 (MD5_BLOCK_MAX_INPUT), junto com prefixo e sufixo
+#define KEYSPACE_SET_MAX 256   // Caracteres distintos possíveis em uma posição
+#define MASK_CUSTOM_SETS 4     // Charsets personalizados ?1 a ?4
+#define KEYSPACE_PREFIX_MAX 256 // Prefixo fixo (sal); os blocos de 64 bytes inteiros
+                                // viram midstate
+#define KEYSPACE_SUFFIX_MAX 64
+#define KEYSPACE_CANDIDATE_MAX (KEYSPACE_PREFIX_MAX + MAX_PASSWORD_LEN + KEYSPACE_SUFFIX_MAX)
+
+#define KEYSPACE_LEVELS 8       // Níveis de probabilidade por posição (ordem Markov)
+#define KEYSPACE_ORDER_MAX_LEN 16  // Senhas mais longas só na ordem lexicográfica
+#define KEYSPACE_LEVEL_SUM_MAX (KEYSPACE_ORDER_MAX_LEN * (KEYSPACE_LEVELS - 1))
+
+/**
+ * Índice (ou quantidade de candidatos) no espaço de busca
+ *
+ * 128 bits com sinal: a partir de uns 10 caracteres os espaços passam de
+ * 2^63, e -1 continua marcando índice inválido. Espaços acima de
+ * KEYSPACE_INDEX_MAX (2^127 - 1) são recusados. Os laços quentes continuam
+ * contando em 64 bits (search_range divide intervalos maiores).
+ */
+typedef __int128 KeyspaceIndex;
+
+#define KEYSPACE_INDEX_MAX ((KeyspaceIndex)(~(unsigned __int128)0 >> 1))
+#define KEYSPACE_INDEX_STR 41   // Buffer para um índice em decimal (39 dígitos, sinal e '\0')
+
+/**
+ * Ordem de enumeração por probabilidade (--markov)
+ *
+ * Cada charset fica ordenado do caractere mais provável naquela posição ao
+ * menos provável e dividido em KEYSPACE_LEVELS trechos contíguos (níveis): o
+ * nível l reúne os caracteres cerca de 2^l vezes menos prováveis que o
+ * primeiro. A soma dos níveis de um candidato aproxima -log2 da sua
+ * probabilidade. Os índices percorrem as somas em ordem crescente; dentro de
+ * uma soma, os candidatos vêm em ordem lexicográfica de (nível, caractere) por
+ * posição. Continua sendo uma bijeção entre [0, tamanho) e o espaço inteiro.
+ *
+ * O nível do último caractere é fixado pelos anteriores, então uma linha (os
+ * valores seguidos do último caractere) é um trecho contíguo do seu charset,
+ * como na ordem lexicográfica: o enumerador e os núcleos especializados
+ * continuam valendo.
+ */
+typedef struct {
+    int enabled;                                         // 0 = ordem lexicográfica
+    short level_end[KEYSPACE_ORDER_MAX_LEN][KEYSPACE_LEVELS];  // Fim (exclusivo) de cada nível
+                                                               // em sets[i]
+    KeyspaceIndex count[KEYSPACE_ORDER_MAX_LEN + 1][KEYSPACE_LEVEL_SUM_MAX + 1];
+                                                         // Candidatos das posições i em diante
+                                                         // cuja soma de níveis é t
+} KeyspaceOrder;
+
+/**
+ * Charsets de cada posição, sem ponteiros: pode ser copiado e colocado na
+ * página compartilhada
+ */
+typedef struct {
+    int length;                                          // Comprimento da senha
+    int set_len[MAX_PASSWORD_LEN];                       // Base de cada posição
+    char sets[MAX_PASSWORD_LEN][KEYSPACE_SET_MAX + 1];   // Charset de cada posição
+    int prefix_len;                                      // Texto fixo antes da senha, ou 0
+    int suffix_len;                                      // Texto fixo depois da senha, ou 0
+    char prefix[KEYSPACE_PREFIX_MAX];
+    char suffix[KEYSPACE_SUFFIX_MAX];
+    KeyspaceOrder order;                                 // Ordem Markov, se enabled
+} Keyspace;
+
+/**
+ * Mesmo charset em todas as posições (caracteres repetidos contam uma vez)
+ *
+ * @return 0 em caso de sucesso, -1 se o comprimento ou o charset forem inválidos
+ */
+int keyspace_init_charset(Keyspace *ks, const char *charset, int password_len);
+
+/**
+ * Um charset por posição, descrito por uma máscara
+ *
+ *   ?l = a-z   ?u = A-Z   ?d = 0-9   ?s = símbolos ASCII e espaço
+ *   ?a = ?l?u?d?s         ?1 a ?4 = charsets personalizados
+ *   ?? = '?' literal      qualquer outro caractere = ele mesmo
+ *
+ * Os charsets personalizados aceitam as mesmas classes (ex.: "?l?d_").
+ *
+ * @param custom Charsets ?1 a ?4 (entradas NULL = não definido)
+ * @return 0 em caso de sucesso, -1 com mensagem em stderr se a máscara for inválida
+ */
+int keyspace_init_mask(Keyspace *ks, const char *mask, const char *const custom[MASK_CUSTOM_SETS]);
+
+/**
+ * Texto fixo em volta da parte enumerada (depois de keyspace_init_*): cada
+ * candidato hasheado é prefix + senha + suffix, como em md5(sal || senha)
+ *
+ * Os blocos de 64 bytes inteiros do prefixo são comprimidos uma vez (midstate);
+ * o resto do prefixo, a senha e o sufixo precisam caber juntos no último bloco.
+ *
+ * @param prefix Prefixo ou sal (NULL = nenhum)
+ * @param suffix Sufixo (NULL = nenhum)
+ * @return 0 em caso de sucesso, -1 com mensagem em stderr se não couber
+ */
+int keyspace_set_affixes(Keyspace *ks, const char *prefix, const char *suffix);
+
+/**
+ * Posição do primeiro caractere da senha no último bloco MD5 do candidato
+ */
+int keyspace_block_offset(const Keyspace *ks);
+
+/**
+ * Mensagem completa de um candidato (prefixo + senha + sufixo), para conferir
+ * ou guardar um resultado
+ *
+ * @param output Buffer com pelo menos KEYSPACE_CANDIDATE_MAX + 1 bytes
+ */
+void keyspace_candidate(const Keyspace *ks, const char *password, char *output);
+
+/**
+ * Ativa a ordem por probabilidade (depois de keyspace_init_*)
+ * Os charsets já devem estar ordenados e order.level_end preenchido; calcula
+ * as contagens usadas para converter índices.
+ *
+ * @return 0 em caso de sucesso, -1 se a senha passa de KEYSPACE_ORDER_MAX_LEN,
+ *         os níveis não cobrem os charsets ou o espaço passa de KEYSPACE_INDEX_MAX
+ */
+int keyspace_order_prepare(Keyspace *ks);
+
+/**
+ * Nível do caractere de índice digit no charset da posição pos
+ */
+int keyspace_level_of(const Keyspace *ks, int pos, int digit);
+
+/**
+ * Tamanho médio de uma linha: quantos valores seguidos o último caractere
+ * percorre antes de um "vai um" (o charset inteiro, ou um nível na ordem Markov)
+ */
+int keyspace_row_length(const Keyspace *ks);
+
+/**
+ * Converte um índice para os dígitos (índice no charset de cada posição) e,
+ * na ordem Markov, os níveis de cada posição
+ */
+void keyspace_index_to_digits(const Keyspace *ks, KeyspaceIndex index, int digits[], int levels[]);
+
+/**
+ * Avança os dígitos para o início da próxima linha na ordem Markov (depois do
+ * último valor da linha atual)
+ *
+ * @return 1 se há uma próxima linha, 0 se o espaço acabou
+ */
+int keyspace_next_row(const Keyspace *ks, int digits[], int levels[]);
+
+/**
+ * Calcula o tamanho total do espaço de busca (produto das bases)
+ *
+ * @return Número total de combinações, ou -1 se passar de KEYSPACE_INDEX_MAX
+ */
+KeyspaceIndex keyspace_size(const Keyspace *ks);
+
+/**
+ * Divisão estática: a parte-ésima de parts fatias contíguas de [0, total)
+ * O resto da divisão é distribuído entre as primeiras partes, então as
+ * quantidades diferem no máximo em 1.
+ *
+ * @param count Saída: quantidade de índices da parte
+ * @return Primeiro índice da parte
+ */
+KeyspaceIndex keyspace_partition(KeyspaceIndex total, int parts, int part, KeyspaceIndex *count);
+
+/**
+ * Converte um índice numérico para uma senha
+ * Usado para definir os limites de cada worker
+ *
+ * @param output Buffer com pelo menos ks->length + 1 bytes
+ */
+void keyspace_index_to_password(const Keyspace *ks, KeyspaceIndex index, char *output);
+
+/**
+ * Converte uma senha de volta para seu índice numérico (inverso de
+ * keyspace_index_to_password)
+ *
+ * @return Índice da senha, ou -1 se o comprimento não bate ou algum caractere
+ *         não pertence ao charset da sua posição
+ */
+KeyspaceIndex keyspace_password_to_index(const Keyspace *ks, const char *password);
+
+/**
+ * Escreve um índice em decimal (printf não tem formato para 128 bits)
+ *
+ * @param buffer Buffer com KEYSPACE_INDEX_STR bytes
+ * @return buffer, para usar direto num printf("%s")
+ */
+const char *keyspace_index_str(KeyspaceIndex value, char buffer[KEYSPACE_INDEX_STR]);
+
+/**
+ * Lê um índice decimal não negativo, depois de espaços opcionais
+ *
+ * @return Posição logo após o número, ou NULL se não há número ou ele passa
+ *         de KEYSPACE_INDEX_MAX
+ */
+const char *keyspace_index_parse(const char *text, KeyspaceIndex *value);
+
+#endif // KEYSPACE_H
@@ -0,0 +1,134 @@
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "markov.h"
+#include "wordlist.h"
+
+int markov_train(MarkovModel *model, const char *wordlist_path) {
+    Wordlist wordlist;
+    if (wordlist_open(&wordlist, wordlist_path) != 0) {
+        return -1;
+    }
+
+    memset(model, 0, sizeof(*model));
+    memcpy(model->header.magic, MARKOV_MAGIC, sizeof(model->header.magic));
+    model->header.header_size = sizeof(MarkovHeader);
+
+    const char *p = wordlist.data;
+    const char *end = wordlist.data + wordlist.size;
+    while (p < end) {
+        const char *newline = memchr(p, '\n', end - p);
+        size_t len = (newline != NULL ? newline : end) - p;
+        if (len > 0 && p[len - 1] == '\r') {
+            len--;  // Wordlists com fim de linha CRLF
+        }
+        if (len > 0) {
+            size_t positions = len < MARKOV_POSITIONS ? len : MARKOV_POSITIONS;
+            for (size_t i = 0; i < positions; i++) {
+                model->counts[i][(uint8_t)p[i]]++;
+            }
+            if (positions > model->header.positions) {
+                model->header.positions = (uint32_t)positions;
+            }
+            model->header.words++;
+        }
+        p = newline != NULL ? newline + 1 : end;
+    }
+    wordlist_close(&wordlist);
+
+    if (model->header.words == 0) {
+        fprintf(stderr, "Erro: Nenhuma palavra em %s\n", wordlist_path);
+        return -1;
+    }
+    return 0;
+}
+
+int markov_save(const MarkovModel *model, const char *path) {
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        perror(path);
+        return -1;
+    }
+
+    // Só as posições vistas no treino: o arquivo é o cabeçalho e uma linha por posição
+    size_t positions = model->header.positions;
+    if (fwrite(&model->header, sizeof(model->header), 1, file) != 1 ||
+        fwrite(model->counts, sizeof(model->counts[0]), positions, file) != positions ||
+        fclose(file) != 0) {
+        perror(path);
+        unlink(path);
+        return -1;
+    }
+    return 0;
+}
+
+int markov_load(MarkovModel *model, const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        perror(path);
+        return -1;
+    }
+
+    memset(model, 0, sizeof(*model));
+    MarkovHeader *header = &model->header;
+    int valid = fread(header, sizeof(*header), 1, file) == 1 &&
+                memcmp(header->magic, MARKOV_MAGIC, sizeof(header->magic)) == 0 &&
+                header->header_size == sizeof(MarkovHeader) &&
+                header->positions >= 1 && header->positions <= MARKOV_POSITIONS &&
+                fread(model->counts, sizeof(model->counts[0]), header->positions, file) ==
+                    header->positions &&
+                fgetc(file) == EOF;
+    fclose(file);
+    if (!valid) {
+        fprintf(stderr, "%s: modelo Markov inválido ou de outro formato\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+int markov_apply(const MarkovModel *model, Keyspace *ks) {
+    KeyspaceOrder *order = &ks->order;
+
+    if (ks->length > KEYSPACE_ORDER_MAX_LEN) {
+        fprintf(stderr, "Erro: A ordem Markov vale para senhas de até %d caracteres\n",
+                KEYSPACE_ORDER_MAX_LEN);
+        return -1;
+    }
+    for (int i = 0; i < ks->length; i++) {
+        const uint32_t *counts = model->counts[i < (int)model->header.positions ?
+                                               i : (int)model->header.positions - 1];
+        char *set = ks->sets[i];
+        int len = ks->set_len[i];
+
+        // Ordenação estável pela frequência (+1: caracteres nunca vistos ainda
+        // entram, no fim, na ordem original)
+        for (int j = 1; j < len; j++) {
+            char c = set[j];
+            uint64_t weight = (uint64_t)counts[(uint8_t)c] + 1;
+            int k = j;
+            for (; k > 0 && (uint64_t)counts[(uint8_t)set[k - 1]] + 1 < weight; k--) {
+                set[k] = set[k - 1];
+            }
+            set[k] = c;
+        }
+
+        // Nível l: entre 2^l e 2^(l+1) vezes menos frequente que o primeiro
+        uint64_t top = (uint64_t)counts[(uint8_t)set[0]] + 1;
+        int level = 0;
+        for (int j = 0; j < len; j++) {
+            uint64_t weight = (uint64_t)counts[(uint8_t)set[j]] + 1;
+            while (level < KEYSPACE_LEVELS - 1 && weight << (level + 1) <= top) {
+                order->level_end[i][level++] = (short)j;
+            }
+        }
+        while (level < KEYSPACE_LEVELS) {
+            order->level_end[i][level++] = (short)len;
+        }
+    }
+
+    if (keyspace_order_prepare(ks) != 0) {
+        fprintf(stderr, "Erro: Espaço de busca excede 2^127 combinações\n");
+        return -1;
+    }
+    return 0;
+}
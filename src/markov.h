@@ -0,0 +1,64 @@
+#ifndef MARKOV_H
+#define MARKOV_H
+
+#include <stdint.h>
+#include "keyspace.h"
+
+/**
+ * Modelo de frequência de caracteres por posição (--markov)
+ *
+ * Treinado numa wordlist de senhas reais (markov_train): quantas vezes cada
+ * byte aparece em cada posição. Aplicado a um espaço de busca, ordena o
+ * charset de cada posição do mais frequente ao menos frequente e o divide em
+ * níveis (KeyspaceOrder). Os índices passam a ir dos candidatos mais
+ * prováveis aos menos prováveis, e senhas escolhidas por pessoas aparecem
+ * numa fração pequena do espaço em vez de, em média, na metade dele.
+ *
+ * Arquivo: MarkovHeader seguido de positions linhas de 256 contadores de 32
+ * bits, na ordem de bytes da máquina que treinou. Posições além das do modelo
+ * usam a última linha.
+ */
+
+#define MARKOV_MAGIC "MD5MKV01"
+#define MARKOV_POSITIONS KEYSPACE_ORDER_MAX_LEN
+
+typedef struct {
+    char magic[8];
+    uint32_t header_size;       // sizeof(MarkovHeader): recusa modelos de outro formato
+    uint32_t positions;         // Linhas de contadores (1 a MARKOV_POSITIONS)
+    uint64_t words;             // Palavras usadas no treino
+} MarkovHeader;
+
+typedef struct {
+    MarkovHeader header;
+    uint32_t counts[MARKOV_POSITIONS][256];
+} MarkovModel;
+
+/**
+ * Conta os bytes de cada posição nas linhas de uma wordlist
+ * Linhas vazias são ignoradas; as mais longas contam só as primeiras posições.
+ *
+ * @return 0 em caso de sucesso, -1 com mensagem em stderr
+ */
+int markov_train(MarkovModel *model, const char *wordlist_path);
+
+/**
+ * @return 0 em caso de sucesso, -1 com mensagem em stderr
+ */
+int markov_save(const MarkovModel *model, const char *path);
+
+/**
+ * @return 0 em caso de sucesso, -1 com mensagem em stderr se o arquivo não é um modelo
+ */
+int markov_load(MarkovModel *model, const char *path);
+
+/**
+ * Reordena os charsets do espaço pelo modelo e ativa a ordem por probabilidade
+ * Depois disso os índices (e os checkpoints) só valem com o mesmo modelo.
+ *
+ * @return 0 em caso de sucesso, -1 com mensagem em stderr se a senha passa de
+ *         KEYSPACE_ORDER_MAX_LEN ou o espaço de KEYSPACE_INDEX_MAX
+ */
+int markov_apply(const MarkovModel *model, Keyspace *ks);
+
+#endif // MARKOV_H
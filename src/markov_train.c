@@ -0,0 +1,84 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "markov.h"
+
+/**
+ * TREINADOR DO MODELO MARKOV
+ *
+ * Conta a frequência de cada caractere em cada posição das senhas de uma
+ * wordlist e grava o modelo binário usado por coordinator --markov, que passa
+ * a percorrer o espaço de busca dos candidatos mais prováveis aos menos
+ * prováveis.
+ *
+ * Uso: ./markov_train <wordlist> <modelo>
+ *      ./markov_train --info <modelo>
+ */
+
+#define INFO_TOP 16  // Caracteres mais frequentes mostrados por posição
+
+static void print_usage(const char *program) {
+    printf("Uso: %s <wordlist> <modelo>\n", program);
+    printf("     %s --info <modelo>\n", program);
+    printf("Exemplo: %s senhas_vazadas.txt senhas.mkv\n", program);
+}
+
+/**
+ * Mostra os caracteres mais frequentes de cada posição
+ */
+static void print_model(const MarkovModel *model) {
+    printf("Palavras: %llu\n", (unsigned long long)model->header.words);
+    printf("Posições: %u\n", model->header.positions);
+    for (uint32_t i = 0; i < model->header.positions; i++) {
+        const uint32_t *counts = model->counts[i];
+        uint64_t total = 0;
+        int distinct = 0;
+        for (int c = 0; c < 256; c++) {
+            total += counts[c];
+            distinct += counts[c] > 0;
+        }
+
+        // Seleção dos INFO_TOP maiores, sem alterar o modelo
+        char top[INFO_TOP + 1];
+        int num_top = 0;
+        char taken[256] = {0};
+        while (num_top < INFO_TOP && num_top < distinct) {
+            int best = -1;
+            for (int c = 0; c < 256; c++) {
+                if (!taken[c] && counts[c] > 0 && (best < 0 || counts[c] > counts[best])) {
+                    best = c;
+                }
+            }
+            taken[best] = 1;
+            top[num_top++] = (best >= 0x20 && best < 0x7f) ? (char)best : '.';
+        }
+        top[num_top] = '\0';
+        printf("  Posição %u: %3d caracteres, %llu ocorrências, mais frequentes: %s\n", i,
+               distinct, (unsigned long long)total, top);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    if (argc == 3 && strcmp(argv[1], "--info") == 0) {
+        MarkovModel model;
+        if (markov_load(&model, argv[2]) != 0) {
+            return 1;
+        }
+        printf("Modelo: %s\n", argv[2]);
+        print_model(&model);
+        return 0;
+    }
+    if (argc != 3) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    static MarkovModel model;
+    if (markov_train(&model, argv[1]) != 0 || markov_save(&model, argv[2]) != 0) {
+        return 1;
+    }
+    printf("Modelo gravado em %s (%zu bytes)\n", argv[2],
+           sizeof(MarkovHeader) + model.header.positions * sizeof(model.counts[0]));
+    print_model(&model);
+    return 0;
+}
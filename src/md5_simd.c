@@ -0,0 +1,104 @@
+#include "md5_simd.h"
+
+// Núcleos MD5 multi-lane: o mesmo corpo (md5_simd_kernel.h) instanciado para
+// SSE2, AVX2 e AVX-512 com atributos target, sem exigir flags de compilação,
+// junto com as varreduras especializadas para cada comprimento de senha.
+// O despacho em tempo de execução fica em md5_batch() (hash_utils.c).
+
+#ifdef MD5_HAVE_X86_SIMD
+#include <immintrin.h>
+
+// SSE2 - 4 lanes
+#define MD5_SIMD_NAME md5_batch_sse2
+#define MD5_SIMD_SCAN_TABLE md5_scan_sse2_table
+#define MD5_SIMD_TARGET __attribute__((target("sse2")))
+#define MD5_SIMD_LANES 4
+#define VEC __m128i
+#define V_SET1(v) _mm_set1_epi32((int)(v))
+#define V_LOADU(p) _mm_loadu_si128((const __m128i *)(p))
+#define V_STOREU(p, v) _mm_storeu_si128((__m128i *)(p), (v))
+#define V_ADD(a, b) _mm_add_epi32((a), (b))
+#define V_AND(a, b) _mm_and_si128((a), (b))
+#define V_OR(a, b) _mm_or_si128((a), (b))
+#define V_XOR(a, b) _mm_xor_si128((a), (b))
+#define V_ROTL(a, n) _mm_or_si128(_mm_slli_epi32((a), (n)), _mm_srli_epi32((a), 32 - (n)))
+#define V_EQ_MASK(a, b) (unsigned)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32((a), (b))))
+#include "md5_simd_kernel.h"
+#undef MD5_SIMD_NAME
+#undef MD5_SIMD_SCAN_TABLE
+#undef MD5_SIMD_TARGET
+#undef MD5_SIMD_LANES
+#undef VEC
+#undef V_SET1
+#undef V_LOADU
+#undef V_STOREU
+#undef V_ADD
+#undef V_AND
+#undef V_OR
+#undef V_XOR
+#undef V_ROTL
+#undef V_EQ_MASK
+
+// AVX2 - 8 lanes
+#define MD5_SIMD_NAME md5_batch_avx2
+#define MD5_SIMD_SCAN_TABLE md5_scan_avx2_table
+#define MD5_SIMD_TARGET __attribute__((target("avx2")))
+#define MD5_SIMD_LANES 8
+#define VEC __m256i
+#define V_SET1(v) _mm256_set1_epi32((int)(v))
+#define V_LOADU(p) _mm256_loadu_si256((const __m256i *)(p))
+#define V_STOREU(p, v) _mm256_storeu_si256((__m256i *)(p), (v))
+#define V_ADD(a, b) _mm256_add_epi32((a), (b))
+#define V_AND(a, b) _mm256_and_si256((a), (b))
+#define V_OR(a, b) _mm256_or_si256((a), (b))
+#define V_XOR(a, b) _mm256_xor_si256((a), (b))
+#define V_ROTL(a, n) _mm256_or_si256(_mm256_slli_epi32((a), (n)), _mm256_srli_epi32((a), 32 - (n)))
+#define V_EQ_MASK(a, b) (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32((a), (b))))
+#include "md5_simd_kernel.h"
+#undef MD5_SIMD_NAME
+#undef MD5_SIMD_SCAN_TABLE
+#undef MD5_SIMD_TARGET
+#undef MD5_SIMD_LANES
+#undef VEC
+#undef V_SET1
+#undef V_LOADU
+#undef V_STOREU
+#undef V_ADD
+#undef V_AND
+#undef V_OR
+#undef V_XOR
+#undef V_ROTL
+#undef V_EQ_MASK
+
+// AVX-512F - 16 lanes, com rotação nativa
+#define MD5_SIMD_NAME md5_batch_avx512
+#define MD5_SIMD_SCAN_TABLE md5_scan_avx512_table
+#define MD5_SIMD_TARGET __attribute__((target("avx512f")))
+#define MD5_SIMD_LANES 16
+#define VEC __m512i
+#define V_SET1(v) _mm512_set1_epi32((int)(v))
+#define V_LOADU(p) _mm512_loadu_si512((const void *)(p))
+#define V_STOREU(p, v) _mm512_storeu_si512((void *)(p), (v))
+#define V_ADD(a, b) _mm512_add_epi32((a), (b))
+#define V_AND(a, b) _mm512_and_si512((a), (b))
+#define V_OR(a, b) _mm512_or_si512((a), (b))
+#define V_XOR(a, b) _mm512_xor_si512((a), (b))
+#define V_ROTL(a, n) _mm512_rol_epi32((a), (n))
+#define V_EQ_MASK(a, b) (unsigned)_mm512_cmpeq_epi32_mask((a), (b))
+#include "md5_simd_kernel.h"
+#undef MD5_SIMD_NAME
+#undef MD5_SIMD_SCAN_TABLE
+#undef MD5_SIMD_TARGET
+#undef MD5_SIMD_LANES
+#undef VEC
+#undef V_SET1
+#undef V_LOADU
+#undef V_STOREU
+#undef V_ADD
+#undef V_AND
+#undef V_OR
+#undef V_XOR
+#undef V_ROTL
+#undef V_EQ_MASK
+
+#endif // MD5_HAVE_X86_SIMD
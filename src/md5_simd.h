@@ -0,0 +1,29 @@
+#ifndef MD5_SIMD_H
+#define MD5_SIMD_H
+
+#include "hash_utils.h"
+#include "md5_steps.h"
+
+/**
+ * Núcleos MD5 vetoriais (uso interno de hash_utils.c)
+ *
+ * Cada função processa exatamente o número de blocos da sua largura e só pode
+ * ser chamada se a CPU suportar o conjunto de instruções correspondente.
+ * Use md5_batch() em hash_utils.h, que faz o despacho em tempo de execução.
+ */
+
+#if defined(__x86_64__) || defined(__i386__)
+#define MD5_HAVE_X86_SIMD 1
+
+// init: estado antes do bloco (vetor inicial ou midstate)
+void md5_batch_sse2(const uint32_t init[4], const MD5Block *blocks, uint32_t (*states)[4]);    // 4
+void md5_batch_avx2(const uint32_t init[4], const MD5Block *blocks, uint32_t (*states)[4]);    // 8
+void md5_batch_avx512(const uint32_t init[4], const MD5Block *blocks, uint32_t (*states)[4]);  // 16
+
+// Núcleos especializados por comprimento (índice = comprimento), ver md5_scan_kernel()
+extern const MD5ScanFn md5_scan_sse2_table[MD5_BLOCK_MAX_INPUT + 1];
+extern const MD5ScanFn md5_scan_avx2_table[MD5_BLOCK_MAX_INPUT + 1];
+extern const MD5ScanFn md5_scan_avx512_table[MD5_BLOCK_MAX_INPUT + 1];
+#endif
+
+#endif // MD5_SIMD_H
@@ -0,0 +1,154 @@
+/**
+ * Núcleo MD5 multi-lane - incluído por md5_simd.c uma vez para cada conjunto
+ * de instruções. Antes da inclusão devem estar definidos:
+ *
+ *   MD5_SIMD_NAME        nome da função de lote gerada
+ *   MD5_SIMD_SCAN_TABLE  nome da tabela de núcleos especializados por comprimento
+ *   MD5_SIMD_TARGET      atributo target do GCC/Clang
+ *   MD5_SIMD_LANES       número de lanes do registrador
+ *   VEC                  tipo do registrador vetorial
+ *   V_SET1, V_LOADU, V_STOREU, V_ADD, V_AND, V_OR, V_XOR, V_ROTL
+ *   V_EQ_MASK(a, b)      máscara de bits (uma por lane) das lanes iguais
+ *
+ * Cada lane executa exatamente os mesmos passos de MD5Compress() em hash_utils.c,
+ * que continua sendo a referência de correção.
+ */
+
+#define V_NOT(a) V_XOR((a), V_SET1(0xffffffff))
+
+#define VF(x, y, z) V_XOR((z), V_AND((x), V_XOR((y), (z))))
+#define VG(x, y, z) V_XOR((y), V_AND((z), V_XOR((x), (y))))
+#define VH(x, y, z) V_XOR(V_XOR((x), (y)), (z))
+#define VI(x, y, z) V_XOR((y), V_OR((x), V_NOT(z)))
+
+#define VBATCH_STEP(n, f, a, b, c, d, w, s, ac) { \
+    (a) = V_ADD((a), V_ADD(V##f((b), (c), (d)), V_ADD(x[w], V_SET1(ac)))); \
+    (a) = V_ROTL((a), (s)); \
+    (a) = V_ADD((a), (b)); \
+}
+
+MD5_SIMD_TARGET
+void MD5_SIMD_NAME(const uint32_t init[4], const MD5Block *blocks, uint32_t (*states)[4]) {
+    uint32_t lane_words[MD5_SIMD_LANES] __attribute__((aligned(64)));
+    VEC x[16], a, b, c, d;
+    int i, lane;
+
+    // Transposição: palavra i de cada bloco vai para a lane correspondente
+    for (i = 0; i < 16; i++) {
+        for (lane = 0; lane < MD5_SIMD_LANES; lane++) {
+            lane_words[lane] = blocks[lane].x[i];
+        }
+        x[i] = V_LOADU(lane_words);
+    }
+
+    a = V_SET1(init[0]);
+    b = V_SET1(init[1]);
+    c = V_SET1(init[2]);
+    d = V_SET1(init[3]);
+
+    MD5_STEPS(VBATCH_STEP)
+
+    a = V_ADD(a, V_SET1(init[0]));
+    b = V_ADD(b, V_SET1(init[1]));
+    c = V_ADD(c, V_SET1(init[2]));
+    d = V_ADD(d, V_SET1(init[3]));
+
+    // Transposição de volta: estado de 4 palavras por lane
+    V_STOREU(lane_words, a);
+    for (lane = 0; lane < MD5_SIMD_LANES; lane++) states[lane][0] = lane_words[lane];
+    V_STOREU(lane_words, b);
+    for (lane = 0; lane < MD5_SIMD_LANES; lane++) states[lane][1] = lane_words[lane];
+    V_STOREU(lane_words, c);
+    for (lane = 0; lane < MD5_SIMD_LANES; lane++) states[lane][2] = lane_words[lane];
+    V_STOREU(lane_words, d);
+    for (lane = 0; lane < MD5_SIMD_LANES; lane++) states[lane][3] = lane_words[lane];
+}
+
+/*
+ * Varredura especializada por comprimento: as lanes recebem valores
+ * consecutivos do último caractere. Só a palavra v muda entre lanes; as outras
+ * (inclusive sufixo, padding e comprimento) entram como escalares já somados à
+ * constante do passo. Os passos anteriores a v são feitos uma vez, a partir do
+ * estado inicial (vetor inicial ou midstate do prefixo), e os da rodada 4
+ * posteriores ao último uso de v são desfeitos a partir do alvo
+ * (md5_steps_reverse), uma vez por chamada.
+ */
+#define VSCAN_WORD(w, ac) \
+    ((w) == v ? V_ADD(xv, V_SET1(ac)) : V_SET1(xs[w] + (uint32_t)(ac)))
+
+#define VSCAN_STEP(n, f, a, b, c, d, w, s, ac) \
+    if ((n) >= v && (n) <= stop - 4) { \
+        (a) = V_ADD((a), V_ADD(V##f((b), (c), (d)), VSCAN_WORD(w, ac))); \
+        (a) = V_ROTL((a), (s)); \
+        (a) = V_ADD((a), (b)); \
+    }
+
+static inline __attribute__((always_inline)) MD5_SIMD_TARGET
+int MD5_PASTE(MD5_SIMD_NAME, _scan)(const uint32_t init[4], const MD5Block *block,
+                                    const uint8_t *values, int count, const uint32_t target[4],
+                                    const int len) {
+    const int pos = len - 1, v = pos >> 2, shift = (pos & 3) * 8;
+    uint32_t lane_words[MD5_SIMD_LANES] __attribute__((aligned(64)));
+    uint32_t xs[16], pre[4];
+
+    md5_scan_words(xs, block);
+    md5_steps_prefix(pre, init, xs, v);
+    const uint32_t base = xs[v] & ~((uint32_t)0xff << shift);
+    // Os passos finais saem do alvo: cada lane para no passo stop - 4
+    const int stop = MD5_REVERSE_STOP(v);
+    const VEC check = V_SET1(md5_steps_reverse(target, init, xs, v));
+
+    for (int k = 0; k < count; k += MD5_SIMD_LANES) {
+        for (int lane = 0; lane < MD5_SIMD_LANES; lane++) {
+            int idx = k + lane < count ? k + lane : count - 1;
+            lane_words[lane] = base | ((uint32_t)values[idx] << shift);
+        }
+        VEC xv = V_LOADU(lane_words);
+        VEC a = V_SET1(pre[0]), b = V_SET1(pre[1]), c = V_SET1(pre[2]), d = V_SET1(pre[3]);
+
+        MD5_STEPS(VSCAN_STEP)
+
+        unsigned mask = V_EQ_MASK(V_ADD(MD5_STEP_REGISTER(stop, a, b, c, d), xv), check);
+        if (count - k < MD5_SIMD_LANES) {
+            mask &= (1u << (count - k)) - 1;  // Lanes de preenchimento
+        }
+        while (mask != 0) {
+            // Candidato raro: confirma as quatro palavras pelo caminho escalar
+            int idx = k + __builtin_ctz(mask);
+            MD5Block candidate = *block;
+            uint32_t state[4];
+            mask &= mask - 1;
+            md5_block_set_byte(&candidate, pos, values[idx]);
+            memcpy(state, init, sizeof(state));
+            md5_block_compress(state, &candidate);
+            if (md5_state_equal(state, target)) {
+                return idx;
+            }
+        }
+    }
+    return -1;
+}
+
+#define VSCAN_LEN(L) \
+    MD5_SIMD_TARGET static int MD5_PASTE(MD5_PASTE(MD5_SIMD_NAME, _scan_len), L)( \
+        const uint32_t init[4], const MD5Block *block, const uint8_t *values, int count, \
+        const uint32_t target[4]) { \
+        return MD5_PASTE(MD5_SIMD_NAME, _scan)(init, block, values, count, target, L); \
+    }
+MD5_FOR_EACH_SCAN_LENGTH(VSCAN_LEN)
+
+#define VSCAN_ENTRY(L) MD5_PASTE(MD5_PASTE(MD5_SIMD_NAME, _scan_len), L),
+const MD5ScanFn MD5_SIMD_SCAN_TABLE[MD5_BLOCK_MAX_INPUT + 1] = {
+    NULL, MD5_FOR_EACH_SCAN_LENGTH(VSCAN_ENTRY)
+};
+
+#undef V_NOT
+#undef VF
+#undef VG
+#undef VH
+#undef VI
+#undef VBATCH_STEP
+#undef VSCAN_WORD
+#undef VSCAN_STEP
+#undef VSCAN_LEN
+#undef VSCAN_ENTRY
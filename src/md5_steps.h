@@ -0,0 +1,219 @@
+#ifndef MD5_STEPS_H
+#define MD5_STEPS_H
+
+#include "hash_utils.h"
+
+/**
+ * Tabela dos 64 passos do MD5 (RFC 1321), para os núcleos gerados por macro
+ *
+ * MD5_STEPS(STEP) expande STEP(n, f, a, b, c, d, w, s, ac) para cada passo n,
+ * onde f é a função da rodada (F, G, H ou I), a..d a ordem dos registradores,
+ * w o índice da palavra da mensagem, s a rotação e ac a constante aditiva.
+ * MD5Compress() em hash_utils.c continua escrito por extenso como referência.
+ */
+
+// Deslocamentos de rotação
+#define S11 7
+#define S12 12
+#define S13 17
+#define S14 22
+#define S21 5
+#define S22 9
+#define S23 14
+#define S24 20
+#define S31 4
+#define S32 11
+#define S33 16
+#define S34 23
+#define S41 6
+#define S42 10
+#define S43 15
+#define S44 21
+
+// Vetor inicial
+#define MD5_IV0 0x67452301
+#define MD5_IV1 0xefcdab89
+#define MD5_IV2 0x98badcfe
+#define MD5_IV3 0x10325476
+
+#define MD5_STEPS(STEP) \
+    STEP( 0, F, a, b, c, d,  0, S11, 0xd76aa478) \
+    STEP( 1, F, d, a, b, c,  1, S12, 0xe8c7b756) \
+    STEP( 2, F, c, d, a, b,  2, S13, 0x242070db) \
+    STEP( 3, F, b, c, d, a,  3, S14, 0xc1bdceee) \
+    STEP( 4, F, a, b, c, d,  4, S11, 0xf57c0faf) \
+    STEP( 5, F, d, a, b, c,  5, S12, 0x4787c62a) \
+    STEP( 6, F, c, d, a, b,  6, S13, 0xa8304613) \
+    STEP( 7, F, b, c, d, a,  7, S14, 0xfd469501) \
+    STEP( 8, F, a, b, c, d,  8, S11, 0x698098d8) \
+    STEP( 9, F, d, a, b, c,  9, S12, 0x8b44f7af) \
+    STEP(10, F, c, d, a, b, 10, S13, 0xffff5bb1) \
+    STEP(11, F, b, c, d, a, 11, S14, 0x895cd7be) \
+    STEP(12, F, a, b, c, d, 12, S11, 0x6b901122) \
+    STEP(13, F, d, a, b, c, 13, S12, 0xfd987193) \
+    STEP(14, F, c, d, a, b, 14, S13, 0xa679438e) \
+    STEP(15, F, b, c, d, a, 15, S14, 0x49b40821) \
+    STEP(16, G, a, b, c, d,  1, S21, 0xf61e2562) \
+    STEP(17, G, d, a, b, c,  6, S22, 0xc040b340) \
+    STEP(18, G, c, d, a, b, 11, S23, 0x265e5a51) \
+    STEP(19, G, b, c, d, a,  0, S24, 0xe9b6c7aa) \
+    STEP(20, G, a, b, c, d,  5, S21, 0xd62f105d) \
+    STEP(21, G, d, a, b, c, 10, S22,  0x2441453) \
+    STEP(22, G, c, d, a, b, 15, S23, 0xd8a1e681) \
+    STEP(23, G, b, c, d, a,  4, S24, 0xe7d3fbc8) \
+    STEP(24, G, a, b, c, d,  9, S21, 0x21e1cde6) \
+    STEP(25, G, d, a, b, c, 14, S22, 0xc33707d6) \
+    STEP(26, G, c, d, a, b,  3, S23, 0xf4d50d87) \
+    STEP(27, G, b, c, d, a,  8, S24, 0x455a14ed) \
+    STEP(28, G, a, b, c, d, 13, S21, 0xa9e3e905) \
+    STEP(29, G, d, a, b, c,  2, S22, 0xfcefa3f8) \
+    STEP(30, G, c, d, a, b,  7, S23, 0x676f02d9) \
+    STEP(31, G, b, c, d, a, 12, S24, 0x8d2a4c8a) \
+    STEP(32, H, a, b, c, d,  5, S31, 0xfffa3942) \
+    STEP(33, H, d, a, b, c,  8, S32, 0x8771f681) \
+    STEP(34, H, c, d, a, b, 11, S33, 0x6d9d6122) \
+    STEP(35, H, b, c, d, a, 14, S34, 0xfde5380c) \
+    STEP(36, H, a, b, c, d,  1, S31, 0xa4beea44) \
+    STEP(37, H, d, a, b, c,  4, S32, 0x4bdecfa9) \
+    STEP(38, H, c, d, a, b,  7, S33, 0xf6bb4b60) \
+    STEP(39, H, b, c, d, a, 10, S34, 0xbebfbc70) \
+    STEP(40, H, a, b, c, d, 13, S31, 0x289b7ec6) \
+    STEP(41, H, d, a, b, c,  0, S32, 0xeaa127fa) \
+    STEP(42, H, c, d, a, b,  3, S33, 0xd4ef3085) \
+    STEP(43, H, b, c, d, a,  6, S34,  0x4881d05) \
+    STEP(44, H, a, b, c, d,  9, S31, 0xd9d4d039) \
+    STEP(45, H, d, a, b, c, 12, S32, 0xe6db99e5) \
+    STEP(46, H, c, d, a, b, 15, S33, 0x1fa27cf8) \
+    STEP(47, H, b, c, d, a,  2, S34, 0xc4ac5665) \
+    STEP(48, I, a, b, c, d,  0, S41, 0xf4292244) \
+    STEP(49, I, d, a, b, c,  7, S42, 0x432aff97) \
+    STEP(50, I, c, d, a, b, 14, S43, 0xab9423a7) \
+    STEP(51, I, b, c, d, a,  5, S44, 0xfc93a039) \
+    STEP(52, I, a, b, c, d, 12, S41, 0x655b59c3) \
+    STEP(53, I, d, a, b, c,  3, S42, 0x8f0ccc92) \
+    STEP(54, I, c, d, a, b, 10, S43, 0xffeff47d) \
+    STEP(55, I, b, c, d, a,  1, S44, 0x85845dd1) \
+    STEP(56, I, a, b, c, d,  8, S41, 0x6fa87e4f) \
+    STEP(57, I, d, a, b, c, 15, S42, 0xfe2ce6e0) \
+    STEP(58, I, c, d, a, b,  6, S43, 0xa3014314) \
+    STEP(59, I, b, c, d, a, 13, S44, 0x4e0811a1) \
+    STEP(60, I, a, b, c, d,  4, S41, 0xf7537e82) \
+    STEP(61, I, d, a, b, c, 11, S42, 0xbd3af235) \
+    STEP(62, I, c, d, a, b,  2, S43, 0x2ad7d2bb) \
+    STEP(63, I, b, c, d, a,  9, S44, 0xeb86d391)
+
+// Funções das rodadas e rotação, na forma escalar usada pelos núcleos gerados
+#define MD5_F(x, y, z) ((z) ^ ((x) & ((y) ^ (z))))
+#define MD5_G(x, y, z) ((y) ^ ((z) & ((x) ^ (y))))
+#define MD5_H(x, y, z) ((x) ^ (y) ^ (z))
+#define MD5_I(x, y, z) ((y) ^ ((x) | ~(z)))
+#define MD5_ROTL(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+#define MD5_PASTE_(a, b) a##b
+#define MD5_PASTE(a, b) MD5_PASTE_(a, b)
+
+/**
+ * Palavras de mensagem de um bloco de senha, vistas por um núcleo especializado
+ * As palavras depois da do último caractere (sufixo, padding e comprimento em
+ * bits) vêm do bloco, porque com prefixo e sufixo (--prefix, --suffix) elas
+ * não são constantes de compilação. São invariantes do laço de candidatos: o
+ * compilador as carrega e soma às constantes dos passos uma vez, fora do laço.
+ */
+static inline __attribute__((always_inline))
+void md5_scan_words(uint32_t xs[16], const MD5Block *block) {
+    for (int i = 0; i < 16; i++) {
+        xs[i] = block->x[i];
+    }
+}
+
+#define MD5_PREFIX_STEP(n, f, a, b, c, d, w, s, ac) \
+    if ((n) < upto) { \
+        (a) += MD5_##f((b), (c), (d)) + xs[w] + (uint32_t)(ac); \
+        (a) = MD5_ROTL((a), (s)); \
+        (a) += (b); \
+    }
+
+/**
+ * Executa os passos [0, upto) a partir do estado inicial (vetor inicial ou
+ * midstate do prefixo)
+ * Na rodada 1 o passo n usa a palavra n, então os passos anteriores à palavra
+ * que varia no laço interno são invariantes e calculados uma única vez.
+ */
+static inline __attribute__((always_inline))
+void md5_steps_prefix(uint32_t state[4], const uint32_t init[4], const uint32_t xs[16],
+                      const int upto) {
+    uint32_t a = init[0], b = init[1], c = init[2], d = init[3];
+    MD5_STEPS(MD5_PREFIX_STEP)
+    state[0] = a;
+    state[1] = b;
+    state[2] = c;
+    state[3] = d;
+}
+
+/**
+ * Passo da rodada 4 que usa a palavra v (o passo 48 + k usa a palavra 7k mod 16)
+ */
+#define MD5_REVERSE_STOP(v) (48 + (7 * (v)) % 16)
+
+/**
+ * Registrador atualizado pelo passo n (a, d, c, b, a, ...), escolhido em
+ * tempo de compilação quando n é constante
+ */
+#define MD5_STEP_REGISTER(n, a, b, c, d) \
+    (((n) & 3) == 0 ? (a) : ((n) & 3) == 1 ? (d) : ((n) & 3) == 2 ? (c) : (b))
+
+/**
+ * Desfaz, a partir do digest alvo, os passos da rodada 4 que não dependem da
+ * palavra v (a que varia no laço interno)
+ *
+ * O alvo menos o estado inicial é o estado depois do passo 63. Cada passo só
+ * altera um registrador e usa os outros três sem alterá-los, então pode ser
+ * invertido: a = ROTR(a - b, s) - I(b, c, d) - x[w] - ac. A inversão vai do
+ * passo 63 até MD5_REVERSE_STOP(v) + 1. No passo de parada, sem x[v], sobra
+ *
+ *   reg + x[v] == valor devolvido
+ *
+ * onde reg é o registrador do passo de parada como estava depois do passo
+ * MD5_REVERSE_STOP(v) - 4. Um candidato só precisa executar até esse passo e
+ * comparar uma palavra; os raros que passam são conferidos por inteiro.
+ */
+static inline uint32_t md5_steps_reverse(const uint32_t target[4], const uint32_t init[4],
+                                         const uint32_t xs[16], const int v) {
+    static const uint32_t ac[16] = {
+        0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+        0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+    };
+    static const int rot[4] = {S41, S42, S43, S44};
+    uint32_t r[4];
+    const int stop = MD5_REVERSE_STOP(v);
+
+    for (int i = 0; i < 4; i++) {
+        r[i] = target[i] - init[i];
+    }
+    for (int n = 63; ; n--) {
+        // Passo n: registradores (A, B, C, D) = r[(4 - n) & 3], r[(5 - n) & 3], ...
+        uint32_t *a = &r[(4 - n) & 3];
+        uint32_t b = r[(5 - n) & 3], c = r[(6 - n) & 3], d = r[(7 - n) & 3];
+        uint32_t t = *a - b;
+        t = (t >> rot[n & 3]) | (t << (32 - rot[n & 3]));
+        t -= MD5_I(b, c, d) + ac[n - 48];
+        if (n == stop) {
+            return t;
+        }
+        *a = t - xs[(7 * (n - 48)) & 15];
+    }
+}
+
+/**
+ * Comprimentos com núcleo especializado: todos os que cabem em um bloco
+ * (X(n) para n de 1 a MD5_BLOCK_MAX_INPUT)
+ */
+#define MD5_FOR_EACH_SCAN_LENGTH(X) \
+    X(1) X(2) X(3) X(4) X(5) X(6) X(7) X(8) X(9) X(10) \
+    X(11) X(12) X(13) X(14) X(15) X(16) X(17) X(18) X(19) X(20) \
+    X(21) X(22) X(23) X(24) X(25) X(26) X(27) X(28) X(29) X(30) \
+    X(31) X(32) X(33) X(34) X(35) X(36) X(37) X(38) X(39) X(40) \
+    X(41) X(42) X(43) X(44) X(45) X(46) X(47) X(48) X(49) X(50) \
+    X(51) X(52) X(53) X(54) X(55)
+
+#endif // MD5_STEPS_H
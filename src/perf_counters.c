@@ -0,0 +1,157 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "perf_counters.h"
+
+// Evento de cada contador; os genéricos do kernel valem em x86 e ARM
+static const struct {
+    uint32_t type;
+    uint64_t config;
+} perf_events[PERF_NUM_EVENTS] = {
+    [PERF_CYCLES] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    [PERF_INSTRUCTIONS] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    [PERF_BRANCH_MISSES] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    [PERF_L1D_MISSES] = {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+                                             (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                             (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    [PERF_LLC_MISSES] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    [PERF_STALLED_FRONTEND] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_STALLED_CYCLES_FRONTEND},
+    [PERF_STALLED_BACKEND] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_STALLED_CYCLES_BACKEND},
+};
+
+static double clock_seconds(clockid_t clock) {
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * Um contador da thread que chama, em qualquer CPU, desligado até o ENABLE
+ * Contadores separados (sem grupo): um evento recusado não derruba os outros,
+ * e com mais eventos que contadores físicos o kernel os reveza
+ */
+static int open_event(PerfEvent event) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = perf_events[event].type;
+    attr.config = perf_events[event].config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;    // Permitido com perf_event_paranoid 2
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+}
+
+void perf_counters_start(PerfCounters *counters) {
+    counters->open_error = 0;
+    for (int i = 0; i < PERF_NUM_EVENTS; i++) {
+        counters->fds[i] = open_event((PerfEvent)i);
+        if (counters->fds[i] < 0 && counters->open_error == 0) {
+            counters->open_error = errno;
+        }
+    }
+
+    struct rusage usage;
+    getrusage(RUSAGE_THREAD, &usage);
+    counters->voluntary_start = usage.ru_nvcsw;
+    counters->involuntary_start = usage.ru_nivcsw;
+    counters->wall_start = clock_seconds(CLOCK_MONOTONIC);
+    counters->cpu_start = clock_seconds(CLOCK_THREAD_CPUTIME_ID);
+    for (int i = 0; i < PERF_NUM_EVENTS; i++) {
+        if (counters->fds[i] >= 0) {
+            ioctl(counters->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+void perf_counters_stop(PerfCounters *counters, PerfSample *sample) {
+    for (int i = 0; i < PERF_NUM_EVENTS; i++) {
+        if (counters->fds[i] >= 0) {
+            ioctl(counters->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+    sample->cpu_seconds = clock_seconds(CLOCK_THREAD_CPUTIME_ID) - counters->cpu_start;
+    sample->wall_seconds = clock_seconds(CLOCK_MONOTONIC) - counters->wall_start;
+    struct rusage usage;
+    getrusage(RUSAGE_THREAD, &usage);
+    sample->voluntary_switches = usage.ru_nvcsw - counters->voluntary_start;
+    sample->involuntary_switches = usage.ru_nivcsw - counters->involuntary_start;
+    sample->open_error = counters->open_error;
+
+    for (int i = 0; i < PERF_NUM_EVENTS; i++) {
+        sample->values[i] = -1;
+        if (counters->fds[i] < 0) {
+            continue;
+        }
+        // Valor, tempo ligado e tempo realmente contando (revezamento)
+        uint64_t data[3];
+        if (read(counters->fds[i], data, sizeof(data)) == sizeof(data) && data[2] > 0) {
+            sample->values[i] = (double)data[0] * ((double)data[1] / (double)data[2]);
+        }
+        close(counters->fds[i]);
+        counters->fds[i] = -1;
+    }
+}
+
+void perf_counters_print(FILE *out, const char *label, const PerfSample *sample,
+                         long long candidates) {
+    const double *v = sample->values;
+    double n = candidates > 0 ? (double)candidates : 1;
+    int any = 0;
+    for (int i = 0; i < PERF_NUM_EVENTS; i++) {
+        any |= v[i] >= 0;
+    }
+
+    if (!any) {
+        fprintf(out, "%s Contadores de hardware indisponíveis (%s): só relógios de software\n",
+                label, sample->open_error != 0 ? strerror(sample->open_error) : "sem leitura");
+    } else {
+        fprintf(out, "%s Contadores:", label);
+        const char *sep = " ";
+        if (v[PERF_CYCLES] >= 0) {
+            fprintf(out, "%s%.2f ciclos/senha", sep, v[PERF_CYCLES] / n);
+            sep = ", ";
+        }
+        if (v[PERF_CYCLES] > 0 && v[PERF_INSTRUCTIONS] >= 0) {
+            fprintf(out, "%sIPC %.2f", sep, v[PERF_INSTRUCTIONS] / v[PERF_CYCLES]);
+            sep = ", ";
+        }
+        if (v[PERF_BRANCH_MISSES] >= 0) {
+            fprintf(out, "%sdesvios errados %.4f/senha", sep, v[PERF_BRANCH_MISSES] / n);
+            sep = ", ";
+        }
+        if (v[PERF_L1D_MISSES] >= 0) {
+            fprintf(out, "%sfaltas L1d %.4f/senha", sep, v[PERF_L1D_MISSES] / n);
+            sep = ", ";
+        }
+        if (v[PERF_LLC_MISSES] >= 0) {
+            fprintf(out, "%sfaltas LLC %.4f/senha", sep, v[PERF_LLC_MISSES] / n);
+            sep = ", ";
+        }
+        if (v[PERF_CYCLES] > 0 && v[PERF_STALLED_FRONTEND] >= 0) {
+            fprintf(out, "%sparado no frontend %.1f%%", sep,
+                    100 * v[PERF_STALLED_FRONTEND] / v[PERF_CYCLES]);
+            sep = ", ";
+        }
+        if (v[PERF_CYCLES] > 0 && v[PERF_STALLED_BACKEND] >= 0) {
+            fprintf(out, "%sparado no backend %.1f%%", sep,
+                    100 * v[PERF_STALLED_BACKEND] / v[PERF_CYCLES]);
+        }
+        fputc('\n', out);
+    }
+
+    fprintf(out, "%s CPU: %.2f de %.2f s (%.0f%%), %.2f ns/senha, trocas de contexto: %ld "
+            "voluntárias, %ld involuntárias\n", label, sample->cpu_seconds, sample->wall_seconds,
+            sample->wall_seconds > 0 ? 100 * sample->cpu_seconds / sample->wall_seconds : 0,
+            1e9 * sample->cpu_seconds / n, sample->voluntary_switches,
+            sample->involuntary_switches);
+}
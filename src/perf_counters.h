@@ -0,0 +1,74 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <stdio.h>
+
+/**
+ * Contadores de hardware por worker (--perf)
+ *
+ * Cada worker (processo ou thread) abre com perf_event_open os contadores da
+ * própria thread, só em modo usuário: ciclos, instruções, desvios mal
+ * previstos, faltas na L1 de dados e no último nível de cache, e ciclos
+ * parados no frontend e no backend. Ao terminar, o worker mostra ciclos por
+ * senha e IPC ao lado da taxa: IPC baixo com muitos ciclos parados no
+ * backend aponta para memória, no frontend para código grande demais, e
+ * tempo de CPU bem abaixo do tempo real, para CPUs ou núcleos SMT disputados.
+ *
+ * O que o processador ou o kernel não oferece (containers, máquinas virtuais,
+ * perf_event_paranoid alto) fica de fora. Sem nenhum contador restam os
+ * relógios de software: tempo de CPU da thread e trocas de contexto.
+ */
+
+typedef enum {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_BRANCH_MISSES,
+    PERF_L1D_MISSES,
+    PERF_LLC_MISSES,
+    PERF_STALLED_FRONTEND,
+    PERF_STALLED_BACKEND,
+    PERF_NUM_EVENTS
+} PerfEvent;
+
+/**
+ * Contadores abertos por uma thread (só ela os lê)
+ */
+typedef struct {
+    int fds[PERF_NUM_EVENTS];           // -1 = indisponível
+    int open_error;                     // errno do primeiro contador recusado, ou 0
+    double cpu_start;                   // Tempo de CPU da thread na abertura
+    double wall_start;
+    long voluntary_start;               // Trocas de contexto na abertura
+    long involuntary_start;
+} PerfCounters;
+
+/**
+ * Medidas entre perf_counters_start() e perf_counters_stop()
+ */
+typedef struct {
+    double values[PERF_NUM_EVENTS];     // Corrigidos pela multiplexação; < 0 = indisponível
+    int open_error;
+    double cpu_seconds;
+    double wall_seconds;
+    long voluntary_switches;            // Esperas (E/S, travas)
+    long involuntary_switches;          // Preempções: mais threads que CPUs
+} PerfSample;
+
+/**
+ * Abre e liga os contadores da thread que chama
+ * Nunca falha: o que não abrir fica marcado como indisponível.
+ */
+void perf_counters_start(PerfCounters *counters);
+
+/**
+ * Desliga, lê e fecha os contadores
+ */
+void perf_counters_stop(PerfCounters *counters, PerfSample *sample);
+
+/**
+ * Escreve as medidas por senha verificada, em duas linhas começando por label
+ */
+void perf_counters_print(FILE *out, const char *label, const PerfSample *sample,
+                         long long candidates);
+
+#endif // PERF_COUNTERS_H
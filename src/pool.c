@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include "pool.h"
+#include "search.h"
+#include "hash_utils.h"
+
+static void futex_wait(atomic_int *word, int expected, const struct timespec *timeout) {
+    syscall(SYS_futex, (int *)word, FUTEX_WAIT, expected, timeout, NULL, 0);
+}
+
+static void futex_wake(atomic_int *word) {
+    syscall(SYS_futex, (int *)word, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+void pool_init(PoolControl *pool, int num_workers) {
+    atomic_init(&pool->published, 0);
+    atomic_init(&pool->completed, 0);
+    pool->num_workers = num_workers;
+}
+
+int pool_job_prepare(PoolControl *pool, int sequence, const char *line,
+                     const char *const custom[MASK_CUSTOM_SETS]) {
+    PoolJob *job = pool_job(pool, sequence);
+    char buffer[1024];
+    char *fields[4];
+    int num_fields = 0;
+    char *save = NULL;
+
+    snprintf(buffer, sizeof(buffer), "%s", line);
+    for (char *field = strtok_r(buffer, " \t\r\n", &save); field != NULL && num_fields < 4;
+         field = strtok_r(NULL, " \t\r\n", &save)) {
+        fields[num_fields++] = field;
+    }
+
+    uint32_t state[4];
+    if (num_fields < 2 || num_fields > 3) {
+        fprintf(stderr, "Erro: Esperado '<hash> <tamanho> <charset>' ou '<hash> <máscara>'\n");
+        return -1;
+    }
+    if (md5_hex_to_state(fields[0], state) != 0) {
+        fprintf(stderr, "Erro: Hash MD5 inválido: %s\n", fields[0]);
+        return -1;
+    }
+
+    Keyspace *keyspace = &job->state.keyspace;
+    if (num_fields == 2) {
+        if (keyspace_init_mask(keyspace, fields[1], custom) != 0) {
+            return -1;
+        }
+    } else {
+        int length = atoi(fields[1]);
+        if (length < 1 || length > MAX_PASSWORD_LEN) {
+            fprintf(stderr, "Erro: Tamanho da senha deve estar entre 1 e %d\n", MAX_PASSWORD_LEN);
+            return -1;
+        }
+        keyspace_init_charset(keyspace, fields[2], length);
+    }
+    KeyspaceIndex total = keyspace_size(keyspace);
+    if (total < 0) {
+        fprintf(stderr, "Erro: Espaço de busca excede 2^127 combinações\n");
+        return -1;
+    }
+
+    // O slot só é reescrito depois que todos os workers saíram do trabalho
+    // anterior; a publicação (release) torna tudo visível de uma vez
+    shared_state_init(&job->state);
+    job->state.dynamic = 1;
+    job->state.num_workers = pool->num_workers;
+    shared_state_set_queue(&job->state, total);
+    md5_state_to_hex(state, job->target_hash);
+    atomic_init(&job->finished, 0);
+    atomic_init(&job->checked, 0);
+    return 0;
+}
+
+void pool_publish(PoolControl *pool, int sequence) {
+    atomic_store_explicit(&pool->published, sequence + 1, memory_order_release);
+    futex_wake(&pool->published);
+}
+
+int pool_wait(PoolControl *pool, int sequence, int timeout_ms) {
+    int completed = atomic_load_explicit(&pool->completed, memory_order_acquire);
+    if (completed > sequence) {
+        return 1;
+    }
+    struct timespec timeout = {timeout_ms / 1000, (timeout_ms % 1000) * 1000000L};
+    futex_wait(&pool->completed, completed, &timeout);
+    return atomic_load_explicit(&pool->completed, memory_order_acquire) > sequence;
+}
+
+void pool_shutdown(PoolControl *pool) {
+    atomic_store_explicit(&pool->published, -1, memory_order_release);
+    futex_wake(&pool->published);
+}
+
+void pool_work(SharedState *shared, int worker_id) {
+    PoolControl *pool = pool_from_shared(shared);
+
+    for (int sequence = 0; ; sequence++) {
+        int published;
+        while ((published = atomic_load_explicit(&pool->published, memory_order_acquire)) >= 0 &&
+               published <= sequence) {
+            futex_wait(&pool->published, published, NULL);
+        }
+        if (published < 0) {
+            return;
+        }
+
+        // Trabalho novo: contexto novo (o tamanho de bloco recomeça do mínimo)
+        PoolJob *job = pool_job(pool, sequence);
+        SearchJob search;
+        SearchContext ctx;
+        if (search_job_init(&search, job->target_hash, &job->state.keyspace) == 0) {
+            search_context_init(&ctx, &search, &job->state, worker_id);
+            search_dynamic(&ctx);
+            atomic_fetch_add_explicit(&job->checked, ctx.passwords_checked, memory_order_relaxed);
+        }
+
+        // O último a sair conclui o trabalho. Os trabalhos terminam em ordem,
+        // porque cada worker os percorre em ordem
+        if (atomic_fetch_add_explicit(&job->finished, 1, memory_order_acq_rel) + 1 ==
+            pool->num_workers) {
+            atomic_fetch_add_explicit(&pool->completed, 1, memory_order_release);
+            futex_wake(&pool->completed);
+        }
+    }
+}
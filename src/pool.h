@@ -0,0 +1,103 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <stdatomic.h>
+#include "shared_state.h"
+
+/**
+ * Fila de trabalhos com pool de workers permanente (--queue)
+ *
+ * Para muitos trabalhos pequenos, criar processos, interpretar o argv e
+ * preparar o arquivo de resultado a cada hash custa mais que a própria busca.
+ * No modo fila o coordinator cria os workers uma vez (worker --pool) e
+ * publica os trabalhos na página compartilhada, em POOL_SLOTS slots
+ * circulares. Cada slot tem o seu SharedState (parada, resultado e fila de
+ * blocos do trabalho), então o laço de busca é o mesmo search_dynamic() dos
+ * outros modos.
+ *
+ * Os workers percorrem os trabalhos em ordem. Quem sai de um trabalho (fila
+ * esgotada ou senha encontrada) já entra no seguinte, sem esperar os demais
+ * nem o coordinator. Enquanto isso, o coordinator lê e prepara os próximos
+ * trabalhos nos slots livres. O último worker a sair de um trabalho o marca
+ * como concluído.
+ *
+ * As esperas usam futex nos dois contadores (published e completed), sem
+ * laço de espera ativa. O slot do trabalho n só é reaproveitado pelo
+ * trabalho n + POOL_SLOTS, depois que o trabalho n foi concluído.
+ */
+
+#define POOL_SLOTS 4            // Trabalhos publicados à frente dos workers
+
+/**
+ * Um trabalho: hash alvo e espaço de busca (charset e tamanho, ou máscara)
+ */
+typedef struct {
+    SharedState state;          // Parada, resultado e fila de blocos deste trabalho
+    char target_hash[33];
+    atomic_int finished;        // Workers que já saíram do trabalho
+    atomic_llong checked;       // Senhas verificadas por todos os workers
+} PoolJob;
+
+/**
+ * Controle da fila, na região extra da página compartilhada
+ */
+typedef struct {
+    _Alignas(CACHE_LINE_SIZE) atomic_int published;  // Trabalhos publicados; -1 = encerrar
+    _Alignas(CACHE_LINE_SIZE) atomic_int completed;  // Trabalhos concluídos por todos os workers
+    int num_workers;
+    PoolJob jobs[POOL_SLOTS];
+} PoolControl;
+
+/**
+ * Fila guardada na página compartilhada, ou NULL fora do modo fila
+ */
+static inline PoolControl *pool_from_shared(SharedState *state) {
+    return state->pool_offset ? (PoolControl *)((char *)state + state->pool_offset) : NULL;
+}
+
+/**
+ * Prepara a fila vazia (coordinator, antes de criar os workers)
+ */
+void pool_init(PoolControl *pool, int num_workers);
+
+/**
+ * Interpreta uma linha de trabalho no slot de sequence
+ *
+ *   <hash_md5> <tamanho> <charset>
+ *   <hash_md5> <máscara>
+ *
+ * @param custom Charsets ?1 a ?4 das máscaras (os da linha de comando)
+ * @return 0 em caso de sucesso, -1 com mensagem em stderr se a linha for inválida
+ */
+int pool_job_prepare(PoolControl *pool, int sequence, const char *line,
+                     const char *const custom[MASK_CUSTOM_SETS]);
+
+static inline PoolJob *pool_job(PoolControl *pool, int sequence) {
+    return &pool->jobs[sequence % POOL_SLOTS];
+}
+
+/**
+ * Libera o trabalho de sequence (já preparado) para os workers
+ */
+void pool_publish(PoolControl *pool, int sequence);
+
+/**
+ * Espera o trabalho de sequence ser concluído
+ *
+ * @param timeout_ms Espera máxima (o coordinator confere os workers entre esperas)
+ * @return 1 se o trabalho foi concluído, 0 se o tempo acabou ou um sinal chegou
+ */
+int pool_wait(PoolControl *pool, int sequence, int timeout_ms);
+
+/**
+ * Encerra os workers (depois que todos os trabalhos publicados foram concluídos,
+ * ou para abortar a fila)
+ */
+void pool_shutdown(PoolControl *pool);
+
+/**
+ * Laço do worker --pool: executa os trabalhos em ordem até o encerramento
+ */
+void pool_work(SharedState *shared, int worker_id);
+
+#endif // POOL_H
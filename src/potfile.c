@@ -0,0 +1,379 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "potfile.h"
+#include "hash_utils.h"
+
+#define POTFILE_MIN_CAPACITY 1024
+#define POTFILE_LINE_ESTIMATE 40        // Bytes por linha, para dimensionar o índice
+#define POTFILE_OFFSET_BITS 40
+#define POTFILE_OFFSET_MASK ((1ULL << POTFILE_OFFSET_BITS) - 1)
+#define POTFILE_LINE_MAX 512
+
+static inline uint64_t *index_entries(const PotfileIndexHeader *header) {
+    return (uint64_t *)(header + 1);
+}
+
+/**
+ * Tag guardada na entrada: 24 bits da palavra 1 (a palavra 0 escolhe a entrada)
+ */
+static inline uint64_t entry_tag(const uint32_t state[4]) {
+    return state[1] >> 8;
+}
+
+/**
+ * Lê a linha que começa em offset: o hash e a senha (ainda codificada)
+ *
+ * @return 0 se a linha é "hash:senha" válida, -1 caso contrário
+ */
+static int parse_line(const Potfile *pot, size_t offset, uint32_t state[4],
+                      const char **password, size_t *password_len) {
+    const char *line = pot->data + offset;
+    const char *newline = memchr(line, '\n', pot->data_size - offset);
+    if (newline == NULL || newline - line < 33 || line[32] != ':') {
+        return -1;
+    }
+
+    char hex[33];
+    memcpy(hex, line, 32);
+    hex[32] = '\0';
+    if (md5_hex_to_state(hex, state) != 0) {
+        return -1;
+    }
+    *password = line + 33;
+    *password_len = newline - *password;
+    if (*password_len > 0 && (*password)[*password_len - 1] == '\r') {
+        (*password_len)--;
+    }
+    return 0;
+}
+
+/**
+ * Insere a linha em offset no índice
+ *
+ * @return 1 se entrou, 0 se o hash já estava no índice, -1 se a tabela está cheia
+ */
+static int index_insert(Potfile *pot, const uint32_t state[4], size_t offset) {
+    PotfileIndexHeader *header = pot->header;
+    uint64_t *entries = index_entries(header);
+    uint64_t mask = header->capacity - 1;
+    uint64_t tag = entry_tag(state);
+
+    if ((header->count + 1) * 4 > header->capacity * 3 || offset >= POTFILE_OFFSET_MASK) {
+        return -1;
+    }
+    uint64_t i = state[0] & mask;
+    for (; entries[i] != 0; i = (i + 1) & mask) {
+        uint32_t other[4];
+        const char *password;
+        size_t password_len;
+        if (entries[i] >> POTFILE_OFFSET_BITS == tag &&
+            parse_line(pot, (entries[i] & POTFILE_OFFSET_MASK) - 1, other, &password,
+                       &password_len) == 0 &&
+            md5_state_equal(other, state)) {
+            return 0;
+        }
+    }
+    entries[i] = (offset + 1) | tag << POTFILE_OFFSET_BITS;
+    header->count++;
+    return 1;
+}
+
+/**
+ * Indexa as linhas completas de [from, data_size); uma linha sem '\n' no fim
+ * (escrita ainda em andamento) fica para a próxima abertura
+ *
+ * @return 0 em caso de sucesso, -1 se a tabela encheu
+ */
+static int index_lines(Potfile *pot, size_t from) {
+    const char *end = pot->data + pot->data_size;
+    const char *line = pot->data + from;
+
+    while (line < end) {
+        const char *newline = memchr(line, '\n', end - line);
+        if (newline == NULL) {
+            break;
+        }
+        uint32_t state[4];
+        const char *password;
+        size_t password_len;
+        if (parse_line(pot, line - pot->data, state, &password, &password_len) == 0 &&
+            index_insert(pot, state, line - pot->data) < 0) {
+            return -1;
+        }
+        line = newline + 1;
+    }
+    pot->header->indexed = line - pot->data;
+    return 0;
+}
+
+/**
+ * Mapeia um índice existente; recusa o de outro formato ou de outro potfile
+ *
+ * @return 0 em caso de sucesso, -1 se o índice precisa ser refeito
+ */
+static int index_map(Potfile *pot, const char *index_path, const struct stat *pot_st) {
+    int fd = open(index_path, O_RDWR | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(PotfileIndexHeader)) {
+        close(fd);
+        return -1;
+    }
+    void *map = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return -1;
+    }
+
+    const PotfileIndexHeader *header = map;
+    int valid = memcmp(header->magic, POTFILE_MAGIC, sizeof(header->magic)) == 0 &&
+                header->header_size == sizeof(PotfileIndexHeader) &&
+                header->capacity >= POTFILE_MIN_CAPACITY &&
+                (header->capacity & (header->capacity - 1)) == 0 &&
+                (size_t)st.st_size == sizeof(PotfileIndexHeader) + header->capacity * sizeof(uint64_t) &&
+                header->count < header->capacity &&
+                header->device == (uint64_t)pot_st->st_dev && header->inode == (uint64_t)pot_st->st_ino &&
+                header->indexed <= pot->data_size;
+    if (!valid) {
+        munmap(map, st.st_size);
+        return -1;
+    }
+    pot->header = map;
+    pot->index_size = st.st_size;
+    return 0;
+}
+
+/**
+ * Refaz o índice inteiro num arquivo temporário e o troca pelo atual (rename)
+ *
+ * @return 0 em caso de sucesso, -1 em erro de E/S
+ */
+static int index_rebuild(Potfile *pot, const char *index_path, const struct stat *pot_st,
+                         uint64_t capacity) {
+    char tmp_path[4096];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", index_path);
+
+    for (;; capacity *= 2) {
+        size_t size = sizeof(PotfileIndexHeader) + capacity * sizeof(uint64_t);
+        int fd = open(tmp_path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0 || ftruncate(fd, size) != 0) {
+            perror(tmp_path);
+            if (fd >= 0) {
+                close(fd);
+            }
+            return -1;
+        }
+        void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (map == MAP_FAILED) {
+            perror("mmap");
+            unlink(tmp_path);
+            return -1;
+        }
+
+        PotfileIndexHeader *old = pot->header;
+        size_t old_size = pot->index_size;
+        PotfileIndexHeader *header = map;
+        memcpy(header->magic, POTFILE_MAGIC, sizeof(header->magic));
+        header->header_size = sizeof(PotfileIndexHeader);
+        header->capacity = capacity;
+        header->device = pot_st->st_dev;
+        header->inode = pot_st->st_ino;
+        pot->header = header;
+        pot->index_size = size;
+
+        if (index_lines(pot, 0) == 0) {
+            if (rename(tmp_path, index_path) != 0) {
+                perror("rename");
+                unlink(tmp_path);
+            }
+            if (old != NULL) {
+                munmap(old, old_size);
+            }
+            return 0;
+        }
+        // Cheio (linhas mais curtas que a estimativa): dobra a tabela
+        munmap(map, size);
+        pot->header = old;
+        pot->index_size = old_size;
+    }
+}
+
+int potfile_open(Potfile *pot, const char *path) {
+    memset(pot, 0, sizeof(*pot));
+    pot->fd = open(path, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (pot->fd < 0) {
+        perror(path);
+        return -1;
+    }
+    // Outro coordinator pode estar acrescentando linhas ou atualizando o índice
+    flock(pot->fd, LOCK_EX);
+
+    struct stat st;
+    if (fstat(pot->fd, &st) < 0) {
+        perror(path);
+        potfile_close(pot);
+        return -1;
+    }
+    if (st.st_size > 0) {
+        void *map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, pot->fd, 0);
+        if (map == MAP_FAILED) {
+            perror("mmap");
+            potfile_close(pot);
+            return -1;
+        }
+        pot->data = map;
+        pot->data_size = st.st_size;
+    }
+
+    // Só as linhas acrescentadas desde a última abertura são lidas; se a
+    // tabela encher, ela é refeita com o dobro do tamanho
+    char index_path[4096];
+    snprintf(index_path, sizeof(index_path), "%s%s", path, POTFILE_INDEX_SUFFIX);
+    int status;
+    if (index_map(pot, index_path, &st) == 0) {
+        size_t from = pot->header->indexed;
+        status = index_lines(pot, from) == 0 ? 0 :
+                 index_rebuild(pot, index_path, &st, pot->header->capacity * 2);
+    } else {
+        uint64_t lines = pot->data_size / POTFILE_LINE_ESTIMATE + 1;
+        uint64_t capacity = POTFILE_MIN_CAPACITY;
+        while (capacity * 3 < lines * 4) {
+            capacity *= 2;
+        }
+        status = index_rebuild(pot, index_path, &st, capacity);
+    }
+    flock(pot->fd, LOCK_UN);
+    if (status != 0) {
+        potfile_close(pot);
+        return -1;
+    }
+
+    // Daqui em diante só consultas: acessos espalhados
+    if (pot->data != NULL) {
+        madvise((void *)pot->data, pot->data_size, MADV_RANDOM);
+    }
+    madvise(pot->header, pot->index_size, MADV_RANDOM);
+    return 0;
+}
+
+void potfile_close(Potfile *pot) {
+    if (pot->header != NULL) {
+        munmap(pot->header, pot->index_size);
+        pot->header = NULL;
+    }
+    if (pot->data != NULL) {
+        munmap((void *)pot->data, pot->data_size);
+        pot->data = NULL;
+    }
+    if (pot->fd >= 0) {
+        close(pot->fd);
+        pot->fd = -1;
+    }
+}
+
+static int hex_digit(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+/**
+ * Decodifica a senha de uma linha ($HEX[...] ou literal)
+ *
+ * @return 0 em caso de sucesso, -1 se não cabe em size bytes ou o hex é inválido
+ */
+static int decode_password(const char *text, size_t len, char *password, size_t size) {
+    if (len >= 6 && memcmp(text, "$HEX[", 5) == 0 && text[len - 1] == ']') {
+        size_t bytes = (len - 6) / 2;
+        if ((len - 6) % 2 != 0 || bytes >= size) {
+            return -1;
+        }
+        for (size_t i = 0; i < bytes; i++) {
+            int hi = hex_digit(text[5 + 2 * i]), lo = hex_digit(text[6 + 2 * i]);
+            if (hi < 0 || lo < 0) {
+                return -1;
+            }
+            password[i] = (char)(hi << 4 | lo);
+        }
+        password[bytes] = '\0';
+        return 0;
+    }
+    if (len >= size) {
+        return -1;
+    }
+    memcpy(password, text, len);
+    password[len] = '\0';
+    return 0;
+}
+
+int potfile_lookup(const Potfile *pot, const uint32_t state[4], char *password, size_t size) {
+    if (pot->header == NULL) {
+        return 0;
+    }
+    const uint64_t *entries = index_entries(pot->header);
+    uint64_t mask = pot->header->capacity - 1;
+    uint64_t tag = entry_tag(state);
+
+    for (uint64_t i = state[0] & mask; entries[i] != 0; i = (i + 1) & mask) {
+        uint64_t offset = (entries[i] & POTFILE_OFFSET_MASK) - 1;
+        uint32_t other[4];
+        const char *text;
+        size_t len;
+        // Outro processo pode ter indexado linhas além do nosso mapeamento
+        if (entries[i] >> POTFILE_OFFSET_BITS == tag && offset < pot->data_size &&
+            parse_line(pot, offset, other, &text, &len) == 0 && md5_state_equal(other, state)) {
+            return decode_password(text, len, password, size) == 0;
+        }
+    }
+    return 0;
+}
+
+int potfile_add(Potfile *pot, const uint32_t state[4], const char *password) {
+    char line[POTFILE_LINE_MAX];
+    size_t len = strlen(password);
+    int plain = strncmp(password, "$HEX[", 5) != 0;
+    for (size_t i = 0; i < len && plain; i++) {
+        plain = (unsigned char)password[i] >= 0x20;
+    }
+
+    md5_state_to_hex(state, line);
+    int n = 32;
+    line[n++] = ':';
+    if (plain && n + len + 1 < sizeof(line)) {
+        memcpy(line + n, password, len);
+        n += len;
+    } else if (n + 2 * len + 7 < sizeof(line)) {
+        n += sprintf(line + n, "$HEX[");
+        for (size_t i = 0; i < len; i++) {
+            n += sprintf(line + n, "%02x", (unsigned char)password[i]);
+        }
+        line[n++] = ']';
+    } else {
+        return -1;
+    }
+    line[n++] = '\n';
+
+    flock(pot->fd, LOCK_EX);
+    int status = write(pot->fd, line, n) == n ? 0 : -1;
+    flock(pot->fd, LOCK_UN);
+    if (status != 0) {
+        perror("potfile");
+    }
+    return status;
+}
@@ -0,0 +1,85 @@
+#ifndef POTFILE_H
+#define POTFILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Potfile: hashes quebrados em execuções anteriores
+ *
+ * O potfile é um arquivo de texto só de acréscimos, uma linha "hash:senha" por
+ * resultado (o formato do hashcat; senhas com quebra de linha ou que começam
+ * com "$HEX[" são gravadas como $HEX[...]). O coordinator o consulta antes de
+ * criar os workers e acrescenta cada senha quebrada.
+ *
+ * Ao lado fica um índice (<potfile>.idx), mapeado em memória: tabela de
+ * endereçamento aberto com sondagem linear, ocupação máxima de 75%, 8 bytes
+ * por entrada:
+ *
+ *   bits  0-39  deslocamento da linha no potfile + 1 (0 = entrada vazia)
+ *   bits 40-63  24 bits do digest (palavra 1), que descartam quase todas as
+ *               sondagens sem ler o potfile
+ *
+ * A entrada inicial sai da palavra 0 do digest. Uma consulta lê uma ou duas
+ * linhas de cache do índice e a linha do potfile, que confirma o hash inteiro:
+ * custo constante com dezenas de milhões de entradas. O índice guarda até que
+ * byte do potfile já foi indexado; ao abrir, só as linhas acrescentadas depois
+ * são lidas. Se o potfile foi trocado ou truncado, o índice é refeito.
+ */
+
+#define POTFILE_FILE "password.pot"
+#define POTFILE_INDEX_SUFFIX ".idx"
+#define POTFILE_MAGIC "MD5POTI1"
+#define POTFILE_WORKER_ID 0     // Worker dos resultados do potfile no arquivo de resultado
+
+/**
+ * Cabeçalho do índice
+ */
+typedef struct {
+    char magic[8];
+    uint32_t header_size;       // sizeof(PotfileIndexHeader): recusa índices de outro formato
+    uint32_t reserved;
+    uint64_t capacity;          // Entradas da tabela (potência de 2)
+    uint64_t count;             // Hashes distintos
+    uint64_t indexed;           // Bytes do potfile já indexados (sempre um fim de linha)
+    uint64_t device;            // Identidade do potfile indexado
+    uint64_t inode;
+} PotfileIndexHeader;
+
+/**
+ * Potfile aberto
+ */
+typedef struct {
+    int fd;                     // Potfile (O_APPEND); o flock nele protege o índice
+    const char *data;           // Potfile mapeado até header->indexed
+    size_t data_size;
+    PotfileIndexHeader *header; // Índice mapeado
+    size_t index_size;
+} Potfile;
+
+/**
+ * Abre (ou cria) o potfile e atualiza o índice com as linhas novas
+ *
+ * @return 0 em caso de sucesso, -1 com mensagem em stderr
+ */
+int potfile_open(Potfile *pot, const char *path);
+
+void potfile_close(Potfile *pot);
+
+/**
+ * Procura um digest no potfile
+ *
+ * @param password Saída: a senha, se couber em size bytes (com '\0')
+ * @return 1 se o hash já foi quebrado, 0 caso contrário
+ */
+int potfile_lookup(const Potfile *pot, const uint32_t state[4], char *password, size_t size);
+
+/**
+ * Acrescenta um resultado ao potfile (uma única escrita, sob flock)
+ * O índice só passa a conter a linha na próxima abertura.
+ *
+ * @return 0 em caso de sucesso, -1 em erro de E/S
+ */
+int potfile_add(Potfile *pot, const uint32_t state[4], const char *password);
+
+#endif // POTFILE_H
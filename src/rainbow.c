@@ -0,0 +1,502 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "rainbow.h"
+#include "hash_utils.h"
+#include "shared_state.h"
+
+#define RAINBOW_GENERATE_GROUP 64     // Cadeias geradas juntas, um lote MD5 por passo
+#define RAINBOW_PROGRESS_SECONDS 5    // Intervalo do progresso da geração
+
+/**
+ * Prepara um bloco para senhas do comprimento do espaço: o padding e a
+ * palavra de comprimento não mudam mais, só os bytes da senha
+ */
+static void block_prepare(const Keyspace *keyspace, MD5Block *block) {
+    char password[MAX_PASSWORD_LEN + 1];
+    keyspace_index_to_password(keyspace, 0, password);
+    md5_block_init(block, password, keyspace->length);
+}
+
+/**
+ * Escreve no bloco a senha de índice x (com divisões: só no início das cadeias)
+ */
+static void index_to_block(const Keyspace *keyspace, uint64_t x, MD5Block *block) {
+    for (int pos = keyspace->length - 1; pos >= 0; pos--) {
+        md5_block_set_byte(block, pos,
+                           (uint8_t)keyspace->sets[pos][x % (uint64_t)keyspace->set_len[pos]]);
+        x /= (uint64_t)keyspace->set_len[pos];
+    }
+}
+
+/**
+ * R_i: do hash de volta a um índice do espaço de busca, já escrito no bloco
+ *
+ * A posição (e o índice da tabela) é espalhada pelos 64 bits baixos do hash,
+ * que são lidos como uma fração f em [0, 1). Cada caractere sai de uma
+ * multiplicação: dígito = parte inteira de f x base, e a parte fracionária
+ * segue para a próxima posição. Sem nenhuma divisão, cada passo da cadeia
+ * custa essencialmente um MD5.
+ *
+ * @return Índice da senha escrita no bloco
+ */
+static inline uint64_t reduce_to_block(const RainbowHeader *header, const uint32_t state[4],
+                                       uint32_t position, MD5Block *block) {
+    const Keyspace *keyspace = &header->keyspace;
+    uint64_t f = ((uint64_t)state[1] << 32 | state[0]) ^
+                 (position + (uint64_t)header->table_index * header->chain_len) *
+                 0x9e3779b97f4a7c15ULL;
+    uint64_t index = 0;
+
+    for (int pos = 0; pos < keyspace->length; pos++) {
+        unsigned __int128 product = (unsigned __int128)f * (uint64_t)keyspace->set_len[pos];
+        uint32_t digit = (uint32_t)(product >> 64);
+        f = (uint64_t)product;
+        md5_block_set_byte(block, pos, (uint8_t)keyspace->sets[pos][digit]);
+        index = index * (uint64_t)keyspace->set_len[pos] + digit;
+    }
+    return index;
+}
+
+// ---------------------------------------------------------------------------
+// Geração
+
+/**
+ * Fatia de cadeias de uma thread
+ */
+typedef struct {
+    const RainbowHeader *header;
+    RainbowChain *chains;
+    long long first;
+    long long count;
+    atomic_llong *done;         // Cadeias prontas, somadas por todas as threads
+    pthread_t thread;
+} GenerateSlot;
+
+static void *generate_main(void *arg) {
+    GenerateSlot *slot = arg;
+    const RainbowHeader *header = slot->header;
+    MD5Block blocks[RAINBOW_GENERATE_GROUP];
+    uint32_t states[RAINBOW_GENERATE_GROUP][4];
+    uint64_t x[RAINBOW_GENERATE_GROUP];
+
+    for (int k = 0; k < RAINBOW_GENERATE_GROUP; k++) {
+        block_prepare(&header->keyspace, &blocks[k]);
+    }
+    for (long long c = slot->first; c < slot->first + slot->count; c += RAINBOW_GENERATE_GROUP) {
+        int n = slot->first + slot->count - c < RAINBOW_GENERATE_GROUP ?
+                (int)(slot->first + slot->count - c) : RAINBOW_GENERATE_GROUP;
+
+        // Inícios espalhados de maneira uniforme pelo espaço, todos distintos
+        for (int k = 0; k < n; k++) {
+            x[k] = (uint64_t)((unsigned __int128)(c + k) * header->space / header->num_chains);
+            slot->chains[c + k].start = x[k];
+            index_to_block(&header->keyspace, x[k], &blocks[k]);
+        }
+        for (uint32_t i = 0; i < header->chain_len; i++) {
+            md5_batch(blocks, n, states);
+            for (int k = 0; k < n; k++) {
+                x[k] = reduce_to_block(header, states[k], i, &blocks[k]);
+            }
+        }
+        for (int k = 0; k < n; k++) {
+            slot->chains[c + k].end = x[k];
+        }
+        atomic_fetch_add_explicit(slot->done, n, memory_order_relaxed);
+    }
+    return NULL;
+}
+
+static int compare_chains(const void *a, const void *b) {
+    const RainbowChain *x = a, *y = b;
+    if (x->end != y->end) {
+        return (x->end > y->end) - (x->end < y->end);
+    }
+    return (x->start > y->start) - (x->start < y->start);
+}
+
+/**
+ * Grava cabeçalho e cadeias de forma atômica (temporário + fsync + rename)
+ */
+static int write_table(const char *path, const RainbowHeader *header, const RainbowChain *chains) {
+    char tmp_path[4096];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+    FILE *file = fopen(tmp_path, "wb");
+    if (file == NULL) {
+        perror(tmp_path);
+        return -1;
+    }
+
+    if (fwrite(header, sizeof(*header), 1, file) != 1 ||
+        fwrite(chains, sizeof(RainbowChain), header->num_chains, file) != header->num_chains ||
+        fflush(file) != 0 || fsync(fileno(file)) != 0) {
+        perror(tmp_path);
+        fclose(file);
+        unlink(tmp_path);
+        return -1;
+    }
+    fclose(file);
+    if (rename(tmp_path, path) != 0) {
+        perror("rename");
+        unlink(tmp_path);
+        return -1;
+    }
+    return 0;
+}
+
+long long rainbow_generate(const char *path, const Keyspace *keyspace, long long num_chains,
+                           int chain_len, int table_index, int num_threads) {
+    RainbowHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, RAINBOW_MAGIC, sizeof(header.magic));
+    header.header_size = sizeof(header);
+    header.chain_len = (uint32_t)chain_len;
+    header.table_index = (uint32_t)table_index;
+    header.num_chains = (uint64_t)num_chains;
+    header.generated_chains = (uint64_t)num_chains;
+    header.space = (uint64_t)keyspace_size(keyspace);
+    header.keyspace = *keyspace;
+
+    RainbowChain *chains = malloc(num_chains * sizeof(RainbowChain));
+    GenerateSlot *slots = calloc(num_threads, sizeof(GenerateSlot));
+    if (chains == NULL || slots == NULL) {
+        perror("malloc");
+        free(chains);
+        free(slots);
+        return -1;
+    }
+
+    atomic_llong done;
+    atomic_init(&done, 0);
+    double start = monotonic_seconds();
+    int started = 0;
+    for (int t = 0; t < num_threads; t++) {
+        slots[t].header = &header;
+        slots[t].chains = chains;
+        slots[t].first = num_chains * t / num_threads;
+        slots[t].count = num_chains * (t + 1) / num_threads - slots[t].first;
+        slots[t].done = &done;
+        if (pthread_create(&slots[t].thread, NULL, generate_main, &slots[t]) != 0) {
+            perror("pthread_create");
+            break;
+        }
+        started++;
+    }
+
+    // Progresso enquanto as threads trabalham
+    double last_report = start;
+    const struct timespec pause = {0, 200000000};
+    while (started == num_threads && atomic_load(&done) < num_chains) {
+        nanosleep(&pause, NULL);
+        double now = monotonic_seconds();
+        if (now - last_report >= RAINBOW_PROGRESS_SECONDS) {
+            long long ready = atomic_load(&done);
+            double rate = ready * (double)chain_len / (now - start);
+            printf("  %.1f%% (%lld de %lld cadeias), %.2f M hashes/s, fim em ~%.0f s\n",
+                   100.0 * ready / num_chains, ready, num_chains, rate / 1e6,
+                   rate > 0 ? (num_chains - ready) * (double)chain_len / rate : 0);
+            fflush(stdout);
+            last_report = now;
+        }
+    }
+    for (int t = 0; t < started; t++) {
+        pthread_join(slots[t].thread, NULL);
+    }
+    free(slots);
+    if (started < num_threads) {
+        free(chains);
+        return -1;
+    }
+
+    double elapsed = monotonic_seconds() - start;
+    printf("%lld cadeias x %d = %.0f hashes em %.2f s (%.2f M hashes/s)\n", num_chains, chain_len,
+           (double)num_chains * chain_len, elapsed,
+           elapsed > 0 ? num_chains * (double)chain_len / elapsed / 1e6 : 0);
+
+    // Ordena pelo fim e fica com uma cadeia por fim
+    qsort(chains, num_chains, sizeof(RainbowChain), compare_chains);
+    long long unique = 0;
+    for (long long c = 0; c < num_chains; c++) {
+        if (unique == 0 || chains[c].end != chains[unique - 1].end) {
+            chains[unique++] = chains[c];
+        }
+    }
+    printf("Cadeias fundidas (mesmo fim) removidas: %lld\n", num_chains - unique);
+    header.num_chains = (uint64_t)unique;
+
+    int status = write_table(path, &header, chains);
+    free(chains);
+    return status == 0 ? unique : -1;
+}
+
+// ---------------------------------------------------------------------------
+// Leitura
+
+int rainbow_open(const char *path, RainbowTable *table) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        perror(path);
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        perror(path);
+        close(fd);
+        return -1;
+    }
+    if ((size_t)st.st_size < sizeof(RainbowHeader)) {
+        fprintf(stderr, "%s: não é uma tabela rainbow\n", path);
+        close(fd);
+        return -1;
+    }
+
+    void *map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        perror("mmap");
+        return -1;
+    }
+
+    const RainbowHeader *header = map;
+    int valid = memcmp(header->magic, RAINBOW_MAGIC, sizeof(header->magic)) == 0 &&
+                header->header_size == sizeof(RainbowHeader) &&
+                header->chain_len > 0 && header->space > 0 && header->space <= LLONG_MAX &&
+                header->num_chains <= header->generated_chains &&
+                header->keyspace.length >= 1 && header->keyspace.length <= MAX_PASSWORD_LEN &&
+                header->keyspace.prefix_len == 0 && header->keyspace.suffix_len == 0 &&
+                !header->keyspace.order.enabled &&
+                keyspace_size(&header->keyspace) == (KeyspaceIndex)header->space &&
+                (size_t)st.st_size == sizeof(RainbowHeader) + header->num_chains * sizeof(RainbowChain);
+    if (!valid) {
+        fprintf(stderr, "%s: tabela rainbow inválida ou de outro formato\n", path);
+        munmap(map, st.st_size);
+        return -1;
+    }
+
+    // A busca pula pelas cadeias: sem leitura antecipada
+    madvise(map, st.st_size, MADV_RANDOM);
+    table->header = header;
+    table->chains = (const RainbowChain *)(header + 1);
+    table->map_size = st.st_size;
+    return 0;
+}
+
+void rainbow_close(RainbowTable *table) {
+    if (table->header != NULL) {
+        munmap((void *)table->header, table->map_size);
+        table->header = NULL;
+    }
+}
+
+double rainbow_coverage(long long space, long long num_chains, int chain_len) {
+    double n = (double)space, m = (double)num_chains, miss = 1.0;
+
+    for (int i = 0; i < chain_len; i++) {
+        miss *= 1.0 - m / n;
+        m = n * (1.0 - exp(-m / n));
+    }
+    return 1.0 - miss;
+}
+
+// ---------------------------------------------------------------------------
+// Busca
+
+/**
+ * Trabalho compartilhado pelas threads: cada item é um hash e um grupo de
+ * RAINBOW_LOOKUP_GROUP posições consecutivas, reivindicado com um fetch-add
+ */
+typedef struct {
+    const RainbowTable *table;
+    const uint32_t (*targets)[4];
+    int count;
+    int groups;                 // Grupos de posições por hash
+    atomic_llong next_item;
+    atomic_int *found;          // Um por hash: 1 = já encontrado, itens restantes são pulados
+    RainbowResult *results;
+    atomic_llong hashes;
+    atomic_llong false_alarms;
+} LookupJob;
+
+typedef struct {
+    LookupJob *job;
+    int id;
+    pthread_t thread;
+} LookupSlot;
+
+/**
+ * Primeira cadeia com fim >= x
+ */
+static uint64_t lower_bound(const RainbowTable *table, uint64_t x) {
+    uint64_t lo = 0, hi = table->header->num_chains;
+    while (lo < hi) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        if (table->chains[mid].end < x) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**
+ * Reconstrói a cadeia desde o início até a posição p e confere o hash
+ *
+ * @param password Saída: a senha da posição p, se o hash bater
+ * @return 1 se a senha da posição p tem o hash alvo, 0 se foi um falso alarme
+ */
+static int verify_chain(const RainbowHeader *header, uint64_t start, int position,
+                        const uint32_t target[4], char *password, long long *hashes) {
+    uint64_t x = start;
+    uint32_t state[4];
+    MD5Block block;
+
+    block_prepare(&header->keyspace, &block);
+    index_to_block(&header->keyspace, start, &block);
+    for (int i = 0; i < position; i++) {
+        md5_block_hash(&block, state);
+        x = reduce_to_block(header, state, i, &block);
+    }
+    md5_block_hash(&block, state);
+    *hashes += position + 1;
+    if (!md5_state_equal(state, target)) {
+        return 0;
+    }
+    keyspace_index_to_password(&header->keyspace, (long long)x, password);
+    return 1;
+}
+
+static void *lookup_main(void *arg) {
+    LookupSlot *slot = arg;
+    LookupJob *job = slot->job;
+    const RainbowHeader *header = job->table->header;
+    const int t = (int)header->chain_len;
+    long long total_items = (long long)job->count * job->groups;
+    long long hashes = 0, false_alarms = 0;
+    MD5Block blocks[RAINBOW_LOOKUP_GROUP];
+    uint32_t states[RAINBOW_LOOKUP_GROUP][4];
+
+    for (int k = 0; k < RAINBOW_LOOKUP_GROUP; k++) {
+        block_prepare(&header->keyspace, &blocks[k]);
+    }
+    for (;;) {
+        long long item = atomic_fetch_add_explicit(&job->next_item, 1, memory_order_relaxed);
+        if (item >= total_items) {
+            break;
+        }
+        int h = (int)(item / job->groups);
+        int g = (int)(item % job->groups);
+        if (atomic_load_explicit(&job->found[h], memory_order_relaxed)) {
+            continue;
+        }
+
+        // Posições hi, hi - 1, ..., lo: as mais baratas (perto do fim) primeiro
+        const uint32_t *target = job->targets[h];
+        int hi = t - 1 - g * RAINBOW_LOOKUP_GROUP;
+        int n = hi + 1 < RAINBOW_LOOKUP_GROUP ? hi + 1 : RAINBOW_LOOKUP_GROUP;
+        uint64_t x[RAINBOW_LOOKUP_GROUP];
+        for (int k = 0; k < n; k++) {
+            x[k] = reduce_to_block(header, target, hi - k, &blocks[k]);
+        }
+
+        // Todas as posições do grupo andam juntas até o fim da cadeia. A lane k
+        // começa no passo hi - k + 1, então as que terminam primeiro são as do
+        // começo do vetor e as ativas são sempre um sufixo contíguo
+        for (int step = hi + 1, first = 0; first < n; step++) {
+            while (first < n && step - first >= t) {
+                first++;
+            }
+            if (first == n) {
+                break;
+            }
+            md5_batch(&blocks[first], n - first, &states[first]);
+            for (int k = first; k < n; k++) {
+                x[k] = reduce_to_block(header, states[k], step - k, &blocks[k]);
+            }
+            hashes += n - first;
+        }
+
+        for (int k = 0; k < n && !atomic_load_explicit(&job->found[h], memory_order_relaxed); k++) {
+            for (uint64_t c = lower_bound(job->table, x[k]);
+                 c < header->num_chains && job->table->chains[c].end == x[k]; c++) {
+                char password[MAX_PASSWORD_LEN + 1];
+                if (!verify_chain(header, job->table->chains[c].start, hi - k, target, password,
+                                  &hashes)) {
+                    false_alarms++;
+                    continue;
+                }
+                int expected = 0;
+                if (atomic_compare_exchange_strong(&job->found[h], &expected, 1)) {
+                    job->results[h].found = 1;
+                    job->results[h].worker_id = slot->id;
+                    memcpy(job->results[h].password, password, sizeof(password));
+                }
+                break;
+            }
+        }
+    }
+
+    atomic_fetch_add(&job->hashes, hashes);
+    atomic_fetch_add(&job->false_alarms, false_alarms);
+    return NULL;
+}
+
+int rainbow_lookup(const RainbowTable *table, const uint32_t (*targets)[4], int count,
+                   int num_threads, RainbowResult *results, RainbowStats *stats) {
+    LookupJob job;
+    job.table = table;
+    job.targets = targets;
+    job.count = count;
+    job.groups = (int)((table->header->chain_len + RAINBOW_LOOKUP_GROUP - 1) / RAINBOW_LOOKUP_GROUP);
+    atomic_init(&job.next_item, 0);
+    atomic_init(&job.hashes, 0);
+    atomic_init(&job.false_alarms, 0);
+    job.found = calloc(count, sizeof(atomic_int));
+    job.results = results;
+    memset(results, 0, count * sizeof(RainbowResult));
+
+    LookupSlot *slots = calloc(num_threads, sizeof(LookupSlot));
+    if (job.found == NULL || slots == NULL) {
+        perror("calloc");
+        free(job.found);
+        free(slots);
+        return -1;
+    }
+
+    int started = 0;
+    for (int i = 0; i < num_threads; i++) {
+        slots[i].job = &job;
+        slots[i].id = i;
+        if (pthread_create(&slots[i].thread, NULL, lookup_main, &slots[i]) != 0) {
+            perror("pthread_create");
+            break;
+        }
+        started++;
+    }
+    for (int i = 0; i < started; i++) {
+        pthread_join(slots[i].thread, NULL);
+    }
+
+    int found = 0;
+    for (int h = 0; h < count; h++) {
+        found += results[h].found;
+    }
+    if (stats != NULL) {
+        stats->hashes = atomic_load(&job.hashes);
+        stats->false_alarms = atomic_load(&job.false_alarms);
+    }
+    free(job.found);
+    free(slots);
+    // Threads que chegaram a começar esgotam a fila de itens sozinhas
+    return started > 0 ? found : -1;
+}
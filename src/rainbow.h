@@ -0,0 +1,115 @@
+#ifndef RAINBOW_H
+#define RAINBOW_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "keyspace.h"
+
+/**
+ * Tabelas rainbow para um espaço de busca fixo (charset e comprimento, ou máscara)
+ *
+ * Uma cadeia parte de um índice do espaço de busca e alterna MD5 e redução:
+ *
+ *   x0 = início
+ *   x(i+1) = R_i(MD5(senha(x_i)))       para i = 0 .. comprimento - 1
+ *   fim = x(comprimento)
+ *
+ * A redução R_i mistura a posição i aos 64 bits baixos do hash e leva o
+ * resultado de volta ao espaço de índices. Só o início e o fim de
+ * cada cadeia são guardados, ordenados pelo fim. Cadeias que se fundem (mesmo
+ * fim) ficam uma só.
+ *
+ * Para procurar um hash h, supõe-se que ele é a saída da posição p de alguma
+ * cadeia: aplica-se R_p, percorre-se a cadeia até o fim e busca-se o fim na
+ * tabela. Um fim encontrado é reconstruído desde o início para confirmar (ou
+ * descartar um falso alarme). As posições são tentadas da última para a
+ * primeira, distribuídas entre as threads.
+ *
+ * Arquivo: RainbowHeader seguido de num_chains RainbowChain, mapeado em memória.
+ * Os campos estão na ordem de bytes da máquina que gerou a tabela.
+ */
+
+#define RAINBOW_MAGIC "MD5RBOW1"
+#define RAINBOW_LOOKUP_GROUP 16  // Posições percorridas juntas num lote MD5
+
+typedef struct {
+    char magic[8];
+    uint32_t header_size;       // sizeof(RainbowHeader): recusa tabelas de outro formato
+    uint32_t chain_len;
+    uint32_t table_index;       // Tabelas com índices diferentes usam reduções diferentes
+    uint32_t reserved;
+    uint64_t num_chains;        // Cadeias gravadas (sem as fundidas)
+    uint64_t generated_chains;  // Cadeias geradas: é delas que vem a cobertura
+    uint64_t space;             // keyspace_size(&keyspace)
+    Keyspace keyspace;
+} RainbowHeader;
+
+typedef struct {
+    uint64_t start;
+    uint64_t end;
+} RainbowChain;
+
+/**
+ * Tabela aberta (somente leitura, mapeada)
+ */
+typedef struct {
+    const RainbowHeader *header;
+    const RainbowChain *chains; // Ordenadas pelo fim
+    size_t map_size;
+} RainbowTable;
+
+/**
+ * Resultado da busca de um hash
+ */
+typedef struct {
+    int found;                  // 1 se a senha foi encontrada
+    int worker_id;              // Thread que a encontrou
+    char password[MAX_PASSWORD_LEN + 1];
+} RainbowResult;
+
+/**
+ * Estatísticas de uma busca
+ */
+typedef struct {
+    long long hashes;           // MD5 calculados percorrendo e reconstruindo cadeias
+    long long false_alarms;     // Fins encontrados que não levavam ao hash
+} RainbowStats;
+
+/**
+ * Gera as cadeias com num_threads threads, ordena, remove as fundidas e grava
+ * o arquivo (temporário + rename)
+ *
+ * @param num_chains Cadeias a gerar (no máximo o tamanho do espaço)
+ * @return Cadeias gravadas, ou -1 em caso de erro
+ */
+long long rainbow_generate(const char *path, const Keyspace *keyspace, long long num_chains,
+                           int chain_len, int table_index, int num_threads);
+
+/**
+ * Abre e valida uma tabela
+ *
+ * @return 0 em caso de sucesso, -1 com mensagem em stderr
+ */
+int rainbow_open(const char *path, RainbowTable *table);
+
+void rainbow_close(RainbowTable *table);
+
+/**
+ * Probabilidade estimada de uma tabela conter um hash qualquer do espaço
+ * (modelo de Oechslin: cadeias que se fundem não somam cobertura)
+ *
+ * @param num_chains Cadeias geradas, antes de remover as fundidas
+ */
+double rainbow_coverage(long long space, long long num_chains, int chain_len);
+
+/**
+ * Procura count hashes na tabela com num_threads threads
+ *
+ * @param results Saída: um resultado por hash
+ * @param stats Saída opcional (NULL para ignorar)
+ * @return Quantos hashes foram encontrados, ou -1 se as threads não puderam ser criadas
+ */
+int rainbow_lookup(const RainbowTable *table, const uint32_t (*targets)[4], int count,
+                   int num_threads, RainbowResult *results, RainbowStats *stats);
+
+#endif // RAINBOW_H
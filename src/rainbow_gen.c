@@ -0,0 +1,188 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <getopt.h>
+#include "rainbow.h"
+#include "keyspace.h"
+
+/**
+ * GERADOR DE TABELAS RAINBOW
+ *
+ * Gera as cadeias de um espaço de busca fixo (charset e comprimento, ou
+ * máscara) e grava a tabela ordenada, pronta para ser mapeada pelo
+ * coordinator --rainbow. Uma busca na tabela custa cerca de
+ * comprimento_cadeia² / 2 hashes, em vez do espaço inteiro.
+ *
+ * Uso: ./rainbow_gen [opções] <tabela> <tamanho> <charset> <num_cadeias> <comprimento_cadeia>
+ *      ./rainbow_gen [opções] --mask <máscara> <tabela> <num_cadeias> <comprimento_cadeia>
+ *      ./rainbow_gen --info <tabela>
+ *
+ * Opções:
+ *   -m, --mask MÁSCARA       Um charset por posição (como no coordinator)
+ *   -1 ... -4 CHARSET        Charsets personalizados ?1 a ?4 da máscara
+ *   -i, --index N            Índice da tabela: tabelas com índices diferentes usam
+ *                            reduções diferentes e se somam (padrão: 0)
+ *   -t, --threads N|auto     Threads de geração (padrão: auto, uma por CPU online)
+ *       --info               Mostra os parâmetros e a cobertura estimada de uma tabela
+ *
+ * Regra prática: com num_cadeias x comprimento_cadeia = k x tamanho do espaço,
+ * uma tabela cobre cerca de 1 - 1/(1 + k/2)²: 75% com k = 2, 89% com k = 4.
+ * Daí em diante as cadeias se fundem cada vez mais; é melhor gerar outra tabela
+ * com --index diferente (duas tabelas de 75% cobrem cerca de 94%).
+ */
+
+static void print_usage(const char *program) {
+    printf("Uso: %s [opções] <tabela> <tamanho> <charset> <num_cadeias> <comprimento_cadeia>\n",
+           program);
+    printf("     %s [opções] --mask <máscara> <tabela> <num_cadeias> <comprimento_cadeia>\n", program);
+    printf("     %s --info <tabela>\n", program);
+    printf("Exemplo: %s tabela.rt 5 abcdefghijklmnopqrstuvwxyz 2000000 3000\n", program);
+    printf("Opções:\n");
+    printf("  -m, --mask MÁSCARA           Um charset por posição: ?l ?u ?d ?s ?a ?1-?4 ou literal\n");
+    printf("  -1 ... -4 CHARSET            Charsets personalizados ?1 a ?4 da máscara\n");
+    printf("  -i, --index N                Índice da tabela (reduções diferentes; padrão: 0)\n");
+    printf("  -t, --threads N|auto         Threads de geração (padrão: auto)\n");
+    printf("      --info                   Mostra os parâmetros de uma tabela\n");
+}
+
+/**
+ * Mostra os parâmetros de uma tabela já gerada
+ */
+static int print_info(const char *path) {
+    RainbowTable table;
+    if (rainbow_open(path, &table) != 0) {
+        return 1;
+    }
+
+    const RainbowHeader *header = table.header;
+    printf("Tabela: %s (%zu bytes)\n", path, table.map_size);
+    printf("Tamanho da senha: %d\n", header->keyspace.length);
+    for (int i = 0; i < header->keyspace.length; i++) {
+        printf("  Posição %d: %s (%d)\n", i, header->keyspace.sets[i], header->keyspace.set_len[i]);
+    }
+    printf("Espaço de busca: %llu combinações\n", (unsigned long long)header->space);
+    printf("Cadeias: %llu de comprimento %u (índice %u), de %llu geradas\n",
+           (unsigned long long)header->num_chains, header->chain_len, header->table_index,
+           (unsigned long long)header->generated_chains);
+    printf("Cobertura estimada: %.1f%%\n",
+           100 * rainbow_coverage((long long)header->space, (long long)header->generated_chains,
+                                  (int)header->chain_len));
+    printf("Custo de uma busca: ~%.0f hashes\n",
+           (double)header->chain_len * (header->chain_len + 1) / 2);
+    rainbow_close(&table);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    static const struct option long_options[] = {
+        {"mask", required_argument, NULL, 'm'},
+        {"index", required_argument, NULL, 'i'},
+        {"threads", required_argument, NULL, 't'},
+        {"info", no_argument, NULL, 'I'},
+        {"custom-charset1", required_argument, NULL, '1'},
+        {"custom-charset2", required_argument, NULL, '2'},
+        {"custom-charset3", required_argument, NULL, '3'},
+        {"custom-charset4", required_argument, NULL, '4'},
+        {NULL, 0, NULL, 0}
+    };
+    const char *mask = NULL;
+    const char *custom_sets[MASK_CUSTOM_SETS] = {NULL};
+    int table_index = 0;
+    int num_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int info = 0;
+    int opt;
+
+    while ((opt = getopt_long(argc, argv, "m:i:t:1:2:3:4:", long_options, NULL)) != -1) {
+        switch (opt) {
+            case 'm':
+                mask = optarg;
+                break;
+            case 'i':
+                table_index = atoi(optarg);
+                break;
+            case 't':
+                num_threads = strcmp(optarg, "auto") == 0 ?
+                              (int)sysconf(_SC_NPROCESSORS_ONLN) : atoi(optarg);
+                break;
+            case 'I':
+                info = 1;
+                break;
+            case '1': case '2': case '3': case '4':
+                custom_sets[opt - '1'] = optarg;
+                break;
+            default:
+                print_usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (info) {
+        if (argc - optind != 1) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        return print_info(argv[optind]);
+    }
+
+    int num_positional = mask != NULL ? 3 : 5;
+    if (argc - optind != num_positional) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    const char *path = argv[optind];
+    long long num_chains = atoll(argv[optind + num_positional - 2]);
+    int chain_len = atoi(argv[optind + num_positional - 1]);
+
+    Keyspace keyspace;
+    if (mask != NULL) {
+        if (keyspace_init_mask(&keyspace, mask, custom_sets) != 0) {
+            return 1;
+        }
+    } else {
+        int password_len = atoi(argv[optind + 1]);
+        if (password_len < 1 || password_len > MAX_PASSWORD_LEN) {
+            printf("Erro: Tamanho da senha deve estar entre 1 e %d\n", MAX_PASSWORD_LEN);
+            return 1;
+        }
+        if (keyspace_init_charset(&keyspace, argv[optind + 2], password_len) != 0) {
+            printf("Erro: Conjunto de caracteres não pode ser vazio\n");
+            return 1;
+        }
+    }
+
+    // As cadeias guardam índices de 64 bits: o limite das tabelas é 2^63
+    KeyspaceIndex full_space = keyspace_size(&keyspace);
+    if (full_space < 0 || full_space > LLONG_MAX) {
+        printf("Erro: Espaço de busca grande demais (mais de 2^63 combinações)\n");
+        return 1;
+    }
+    long long space = (long long)full_space;
+    if (num_chains < 1 || num_chains > space) {
+        printf("Erro: Número de cadeias deve estar entre 1 e %lld (tamanho do espaço)\n", space);
+        return 1;
+    }
+    if (chain_len < 1 || table_index < 0 || num_threads < 1) {
+        printf("Erro: Comprimento da cadeia, índice e threads devem ser positivos\n");
+        return 1;
+    }
+
+    printf("=== Gerador de Tabelas Rainbow ===\n");
+    printf("Tabela: %s (índice %d)\n", path, table_index);
+    printf("Tamanho da senha: %d\n", keyspace.length);
+    printf("Espaço de busca: %lld combinações\n", space);
+    printf("Cadeias: %lld de comprimento %d\n", num_chains, chain_len);
+    printf("Threads: %d\n", num_threads);
+    printf("Cobertura estimada: %.1f%%\n\n", 100 * rainbow_coverage(space, num_chains, chain_len));
+    fflush(stdout);
+
+    long long written = rainbow_generate(path, &keyspace, num_chains, chain_len, table_index,
+                                         num_threads);
+    if (written < 0) {
+        return 1;
+    }
+    printf("Tabela gravada: %lld cadeias, %zu bytes\n", written,
+           sizeof(RainbowHeader) + (size_t)written * sizeof(RainbowChain));
+    return 0;
+}
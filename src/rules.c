@@ -0,0 +1,268 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "rules.h"
+
+/**
+ * Posição no formato do hashcat: 0-9 e depois A-Z (10 a 35)
+ *
+ * @return Posição, ou -1 se o caractere não é uma posição
+ */
+static int rule_position(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'Z') return c - 'A' + 10;
+    return -1;
+}
+
+/**
+ * Quantos argumentos cada função recebe, e de que tipo
+ * ('N' = posição, 'X' = caractere), ou NULL se a função não existe
+ */
+static const char *rule_signature(char op) {
+    switch (op) {
+        case ':': case 'l': case 'u': case 'c': case 'C': case 't': case 'r':
+        case 'd': case 'f': case '{': case '}': case 'q': case '[': case ']':
+            return "";
+        case '$': case '^': case '@':
+            return "X";
+        case 'T': case 'D': case '\'': case 'z': case 'Z':
+            return "N";
+        case 'i': case 'o':
+            return "NX";
+        case 's':
+            return "XX";
+        default:
+            return NULL;
+    }
+}
+
+int rule_parse(const char *text, Rule *rule) {
+    rule->count = 0;
+
+    for (const char *p = text; *p != '\0'; ) {
+        if (*p == ' ' || *p == '\t') {
+            p++;
+            continue;
+        }
+
+        const char *signature = rule_signature(*p);
+        if (signature == NULL || rule->count == RULE_MAX_OPS) {
+            return -1;
+        }
+
+        RuleOp *op = &rule->ops[rule->count++];
+        op->op = (uint8_t)*p++;
+        op->arg1 = op->arg2 = 0;
+        for (int i = 0; signature[i] != '\0'; i++) {
+            if (*p == '\0') {
+                return -1;
+            }
+            int value = (uint8_t)*p++;
+            if (signature[i] == 'N' && (value = rule_position((char)value)) < 0) {
+                return -1;
+            }
+            if (i == 0) {
+                op->arg1 = (uint8_t)value;
+            } else {
+                op->arg2 = (uint8_t)value;
+            }
+        }
+    }
+    return 0;
+}
+
+int ruleset_load(RuleSet *set, const char *path) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        perror(path);
+        return -1;
+    }
+
+    int capacity = 0, line_number = 0;
+    char line[512];
+    set->rules = NULL;
+    set->count = 0;
+    set->invalid = 0;
+
+    while (fgets(line, sizeof(line), file) != NULL) {
+        line_number++;
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0' || line[0] == '#') {
+            continue;
+        }
+
+        if (set->count == capacity) {
+            capacity = capacity ? capacity * 2 : 64;
+            Rule *grown = realloc(set->rules, capacity * sizeof(Rule));
+            if (grown == NULL) {
+                perror("realloc");
+                ruleset_free(set);
+                fclose(file);
+                return -1;
+            }
+            set->rules = grown;
+        }
+
+        if (rule_parse(line, &set->rules[set->count]) != 0) {
+            fprintf(stderr, "%s:%d: regra inválida ignorada: %s\n", path, line_number, line);
+            set->invalid++;
+            continue;
+        }
+        set->count++;
+    }
+
+    fclose(file);
+    return 0;
+}
+
+void ruleset_free(RuleSet *set) {
+    free(set->rules);
+    set->rules = NULL;
+    set->count = 0;
+}
+
+static inline uint8_t to_lower(uint8_t c) {
+    return (c >= 'A' && c <= 'Z') ? c + 32 : c;
+}
+
+static inline uint8_t to_upper(uint8_t c) {
+    return (c >= 'a' && c <= 'z') ? c - 32 : c;
+}
+
+static inline uint8_t toggle(uint8_t c) {
+    return (c >= 'a' && c <= 'z') ? c - 32 : (c >= 'A' && c <= 'Z') ? c + 32 : c;
+}
+
+int rule_apply(const Rule *rule, const char *word, size_t len, MD5Block *block) {
+    // Os bytes do bloco são o buffer de trabalho: a palavra é copiada uma vez
+    // e cada operação a altera ali mesmo
+    uint8_t *w = md5_block_bytes(block);
+    const size_t max = MD5_BLOCK_MAX_INPUT;
+    size_t n = len;
+
+    if (n > max) {
+        return -1;
+    }
+    memcpy(w, word, n);
+
+    for (int k = 0; k < rule->count; k++) {
+        const RuleOp *op = &rule->ops[k];
+        size_t a = op->arg1, i;
+        uint8_t tmp;
+
+        switch (op->op) {
+            case ':':
+                break;
+            case 'l':
+                for (i = 0; i < n; i++) w[i] = to_lower(w[i]);
+                break;
+            case 'u':
+                for (i = 0; i < n; i++) w[i] = to_upper(w[i]);
+                break;
+            case 'c':
+                for (i = 0; i < n; i++) w[i] = i == 0 ? to_upper(w[i]) : to_lower(w[i]);
+                break;
+            case 'C':
+                for (i = 0; i < n; i++) w[i] = i == 0 ? to_lower(w[i]) : to_upper(w[i]);
+                break;
+            case 't':
+                for (i = 0; i < n; i++) w[i] = toggle(w[i]);
+                break;
+            case 'T':
+                if (a < n) w[a] = toggle(w[a]);
+                break;
+            case 'r':
+                for (i = 0; i < n / 2; i++) {
+                    tmp = w[i]; w[i] = w[n - 1 - i]; w[n - 1 - i] = tmp;
+                }
+                break;
+            case 'd':
+                if (2 * n > max) return -1;
+                memcpy(w + n, w, n);
+                n *= 2;
+                break;
+            case 'f':
+                if (2 * n > max) return -1;
+                for (i = 0; i < n; i++) w[n + i] = w[n - 1 - i];
+                n *= 2;
+                break;
+            case '{':
+                if (n > 1) {
+                    tmp = w[0]; memmove(w, w + 1, n - 1); w[n - 1] = tmp;
+                }
+                break;
+            case '}':
+                if (n > 1) {
+                    tmp = w[n - 1]; memmove(w + 1, w, n - 1); w[0] = tmp;
+                }
+                break;
+            case 'q':
+                if (2 * n > max) return -1;
+                for (i = n; i-- > 0; ) w[2 * i] = w[2 * i + 1] = w[i];
+                n *= 2;
+                break;
+            case '$':
+                if (n + 1 > max) return -1;
+                w[n++] = op->arg1;
+                break;
+            case '^':
+                if (n + 1 > max) return -1;
+                memmove(w + 1, w, n++);
+                w[0] = op->arg1;
+                break;
+            case '[':
+                if (n > 0) memmove(w, w + 1, --n);
+                break;
+            case ']':
+                if (n > 0) n--;
+                break;
+            case 'D':
+                if (a < n) {
+                    memmove(w + a, w + a + 1, n - a - 1);
+                    n--;
+                }
+                break;
+            case '\'':
+                if (a < n) n = a;
+                break;
+            case 'i':
+                if (a <= n) {
+                    if (n + 1 > max) return -1;
+                    memmove(w + a + 1, w + a, n - a);
+                    w[a] = op->arg2;
+                    n++;
+                }
+                break;
+            case 'o':
+                if (a < n) w[a] = op->arg2;
+                break;
+            case 's':
+                for (i = 0; i < n; i++) if (w[i] == op->arg1) w[i] = op->arg2;
+                break;
+            case '@': {
+                size_t out = 0;
+                for (i = 0; i < n; i++) if (w[i] != op->arg1) w[out++] = w[i];
+                n = out;
+                break;
+            }
+            case 'z':
+                if (n > 0) {
+                    if (n + a > max) return -1;
+                    memmove(w + a, w, n);
+                    memset(w, w[a], a);
+                    n += a;
+                }
+                break;
+            case 'Z':
+                if (n > 0) {
+                    if (n + a > max) return -1;
+                    memset(w + n, w[n - 1], a);
+                    n += a;
+                }
+                break;
+        }
+    }
+
+    md5_block_finish(block, n);
+    return (int)n;
+}
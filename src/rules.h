@@ -0,0 +1,84 @@
+#ifndef RULES_H
+#define RULES_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "hash_utils.h"
+#include "shared_state.h"
+
+/**
+ * Motor de regras para a wordlist (--rules), no estilo do hashcat
+ *
+ * Cada linha do arquivo de regras é compilada uma vez para um vetor fixo de
+ * operações. Na busca, cada palavra base é copiada uma única vez para o bloco
+ * MD5 do lote e as operações a alteram ali mesmo; o bloco sai pronto para o
+ * hasher, sem malloc nem strings intermediárias por candidato.
+ *
+ * Funções suportadas (N = posição 0-9 ou A-Z = 10-35, X/Y = caracteres):
+ *   :  nada          l  minúsculas     u  maiúsculas     c  Capitaliza
+ *   C  cAPITALIZA    t  inverte caixa  TN inverte caixa na posição N
+ *   r  inverte       d  duplica        f  espelha (palavra + inversa)
+ *   {  gira à esq.   }  gira à dir.    q  duplica cada caractere
+ *   $X acrescenta X  ^X antepõe X      [  apaga o 1º     ]  apaga o último
+ *   DN apaga em N    'N trunca em N    iNX insere X em N oNX troca N por X
+ *   sXY troca X por Y (todos)          @X remove todos os X
+ *   zN duplica o 1º caractere N vezes  ZN duplica o último N vezes
+ *
+ * Posições fora da palavra deixam a palavra como está; um candidato que
+ * passaria de MD5_BLOCK_MAX_INPUT bytes é descartado.
+ */
+
+#define RULE_MAX_OPS 32
+
+typedef struct {
+    uint8_t op;                 // Caractere da função
+    uint8_t arg1;
+    uint8_t arg2;
+} RuleOp;
+
+typedef struct {
+    int count;
+    RuleOp ops[RULE_MAX_OPS];
+} Rule;
+
+/**
+ * Regras compiladas de um arquivo
+ */
+typedef struct {
+    Rule *rules;
+    int count;
+    int invalid;                // Linhas com erro de sintaxe, ignoradas
+} RuleSet;
+
+/**
+ * Compila uma regra em texto
+ *
+ * @return 0 em caso de sucesso, -1 se a sintaxe for inválida
+ */
+int rule_parse(const char *text, Rule *rule);
+
+/**
+ * Lê e compila um arquivo de regras (uma por linha; '#' inicia comentário)
+ *
+ * @return 0 em caso de sucesso, -1 se o arquivo não pôde ser lido
+ */
+int ruleset_load(RuleSet *set, const char *path);
+
+void ruleset_free(RuleSet *set);
+
+/**
+ * Gera um candidato: aplica a regra à palavra direto dentro do bloco
+ *
+ * @param block Bloco de saída, pronto para md5_batch() se o retorno for >= 0
+ * @return Comprimento do candidato, ou -1 se ele foi descartado
+ */
+int rule_apply(const Rule *rule, const char *word, size_t len, MD5Block *block);
+
+/**
+ * Regras copiadas para a página compartilhada, ou NULL sem --rules
+ */
+static inline const Rule *rules_from_shared(const SharedState *state) {
+    return state->rules_offset ? (const Rule *)((const char *)state + state->rules_offset) : NULL;
+}
+
+#endif // RULES_H
@@ -0,0 +1,569 @@
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include "search.h"
+#include "keyspace.h"
+#include "enumerator.h"
+
+int check_result_exists(void) {
+    return access(RESULT_FILE, F_OK) == 0;
+}
+
+void save_result(int worker_id, const char *password) {
+    int fd = open(RESULT_FILE, O_CREAT | O_EXCL | O_WRONLY, 0644);
+    if (fd < 0) {
+        // Outro worker já gravou o resultado
+        return;
+    }
+
+    char buffer[128];
+    int len = snprintf(buffer, sizeof(buffer), "%d:%s\n", worker_id, password);
+    if (write(fd, buffer, len) != len) {
+        perror("write");
+    }
+    close(fd);
+}
+
+void append_result(const char *hash, int worker_id, const char *password) {
+    int fd = open(RESULT_FILE, O_CREAT | O_APPEND | O_WRONLY, 0644);
+    if (fd < 0) {
+        perror("open");
+        return;
+    }
+
+    char buffer[128];
+    int len = snprintf(buffer, sizeof(buffer), "%s:%d:%s\n", hash, worker_id, password);
+    if (write(fd, buffer, len) != len) {
+        perror("write");
+    }
+    close(fd);
+}
+
+void search_job_use_wordlist(SearchJob *job, const Wordlist *wordlist) {
+    job->wordlist = wordlist;
+    job->scan = NULL;
+}
+
+void search_job_use_rules(SearchJob *job, const Rule *rules, int num_rules) {
+    job->rules = num_rules > 0 ? rules : NULL;
+    job->num_rules = num_rules;
+}
+
+/**
+ * Blocos inteiros do prefixo comprimidos uma vez para todos os candidatos
+ */
+static void job_init_state(SearchJob *job, const Keyspace *keyspace) {
+    if (keyspace != NULL) {
+        md5_midstate(keyspace->prefix, keyspace->prefix_len / MD5_BLOCK_SIZE, job->init_state);
+    } else {
+        md5_midstate(NULL, 0, job->init_state);
+    }
+}
+
+void search_job_init_list(SearchJob *job, TargetSet *targets, const Keyspace *keyspace) {
+    memset(job, 0, sizeof(*job));
+    job->keyspace = keyspace;
+    job->targets = targets;
+    job_init_state(job, keyspace);
+}
+
+int search_job_init(SearchJob *job, const char *target_hash, const Keyspace *keyspace) {
+    job->targets = NULL;
+    job->keyspace = keyspace;
+    job->wordlist = NULL;
+    job->rules = NULL;
+    job->num_rules = 0;
+    job_init_state(job, keyspace);
+    // Com linhas do último caractere menores que o vetor, as lanes ficariam ociosas
+    // a cada linha: nesse caso o lote genérico, que atravessa linhas, é mais rápido
+    job->scan = NULL;
+    if (keyspace != NULL && keyspace_row_length(keyspace) >= md5_isa_lanes(md5_isa_best())) {
+        job->scan = md5_scan_kernel(md5_isa_best(),
+                                    keyspace_block_offset(keyspace) + keyspace->length);
+    }
+    return md5_hex_to_state(target_hash, job->target_state);
+}
+
+void search_context_init(SearchContext *ctx, const SearchJob *job, SharedState *shared,
+                         int worker_id) {
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->job = job;
+    ctx->shared = shared;
+    ctx->worker_id = worker_id;
+    ctx->lanes = md5_isa_lanes(md5_isa_best());
+    ctx->progress = shared != NULL && shared_state_progress(shared) != NULL ?
+                    &shared_state_progress(shared)[worker_id] : NULL;
+}
+
+/**
+ * Publica até onde o intervalo atual já foi verificado e quantas senhas o
+ * worker já testou: stores relaxed na linha de cache do próprio worker, lidas
+ * só pelo checkpoint e pela telemetria
+ */
+static inline void publish_progress(SearchContext *ctx, KeyspaceIndex next) {
+    if (ctx->progress != NULL) {
+        worker_progress_advance(ctx->progress, next);
+        atomic_store_explicit(&ctx->progress->checked, ctx->passwords_checked,
+                              memory_order_relaxed);
+    }
+}
+
+/**
+ * Verifica se outro worker já encontrou a senha: carga relaxed da flag
+ * compartilhada a cada lote, ou o arquivo de resultado periodicamente
+ */
+static int stop_requested(SearchContext *ctx) {
+    if (ctx->shared != NULL) {
+        return shared_state_stop_requested(ctx->shared);
+    }
+    if (ctx->passwords_checked >= ctx->next_check) {
+        ctx->next_check += PROGRESS_INTERVAL;
+        return check_result_exists();
+    }
+    return 0;
+}
+
+/**
+ * Reporta a senha encontrada pela memória compartilhada ou pelo arquivo
+ */
+static void report_found(SearchContext *ctx, const char *password) {
+    printf("[Worker %d] ✓✓✓ SENHA ENCONTRADA: %s\n", ctx->worker_id, password);
+    if (ctx->shared == NULL) {
+        save_result(ctx->worker_id, password);
+    } else if (shared_state_publish(ctx->shared, ctx->worker_id, password)) {
+        // Avisa o coordinator imediatamente, sem esperar o fim dos workers
+        kill(ctx->shared->coordinator_pid, SIGUSR1);
+    }
+}
+
+/**
+ * Registra um alvo da lista quebrado: a linha sai no arquivo na hora, e o
+ * último alvo quebrado para todos os workers
+ */
+static void report_target(SearchContext *ctx, int index, const char *password) {
+    TargetSet *targets = ctx->job->targets;
+    if (!target_set_publish(targets, index, ctx->worker_id, password)) {
+        return;
+    }
+
+    char hash[33];
+    md5_state_to_hex(target_set_entry(targets, index)->state, hash);
+    printf("[Worker %d] ✓ %s = %s\n", ctx->worker_id, hash, password);
+    append_result(hash, ctx->worker_id, password);
+    ctx->cracked++;
+
+    if (atomic_load(&targets->cracked) == targets->count) {
+        atomic_store_explicit(&ctx->shared->found, 1, memory_order_release);
+    }
+    kill(ctx->shared->coordinator_pid, SIGUSR1);
+}
+
+/**
+ * Busca por uma lista de alvos: cada digest do lote passa pelo filtro do
+ * conjunto, e a busca continua após cada acerto
+ */
+static SearchStatus search_range_list(SearchContext *ctx, KeyspaceIndex start_index,
+                                      long long count) {
+    const SearchJob *job = ctx->job;
+    MD5Block blocks[MD5_BATCH_MAX];
+    uint32_t computed_states[MD5_BATCH_MAX][4];
+    Enumerator e;
+    int more = count > 0;
+
+    enumerator_init(&e, job->keyspace, start_index, count);
+
+    while (more) {
+        if (stop_requested(ctx)) {
+            return SEARCH_STOPPED;
+        }
+
+        int batch_size = 0;
+        do {
+            blocks[batch_size++] = e.block;
+            more = enumerator_next(&e);
+        } while (more && batch_size < ctx->lanes);
+
+        md5_batch_from(job->init_state, blocks, batch_size, computed_states);
+        for (int i = 0; i < batch_size; i++) {
+            int index = target_set_lookup(job->targets, computed_states[i]);
+            if (index >= 0) {
+                char password[MAX_PASSWORD_LEN + 1];
+                enumerator_block_password(&blocks[i], job->keyspace, password);
+                report_target(ctx, index, password);
+            }
+        }
+        ctx->passwords_checked += batch_size;
+        start_index += batch_size;
+        publish_progress(ctx, start_index);
+    }
+
+    return SEARCH_DONE;
+}
+
+/**
+ * Varredura com o núcleo especializado: cada chamada testa o restante da linha
+ * atual, ou seja, todos os valores do último caractere de uma vez
+ */
+static SearchStatus search_range_scan(SearchContext *ctx, KeyspaceIndex start_index,
+                                      long long count) {
+    const SearchJob *job = ctx->job;
+    const Keyspace *ks = job->keyspace;
+    const int last = ks->length - 1;
+    const int last_byte = keyspace_block_offset(ks) + last;
+    Enumerator e;
+    int more = count > 0;
+
+    enumerator_init(&e, job->keyspace, start_index, count);
+
+    while (more) {
+        if (stop_requested(ctx)) {
+            return SEARCH_STOPPED;
+        }
+
+        int first = e.digits[last];
+        int n = e.row_end - first;
+        if (n > e.remaining) {
+            n = (int)e.remaining;
+        }
+
+        int hit = job->scan(job->init_state, &e.block, (const uint8_t *)ks->sets[last] + first, n,
+                            job->target_state);
+        if (hit >= 0) {
+            char password[MAX_PASSWORD_LEN + 1];
+            md5_block_set_byte(&e.block, last_byte, (uint8_t)ks->sets[last][first + hit]);
+            enumerator_block_password(&e.block, ks, password);
+            ctx->passwords_checked += hit + 1;
+            report_found(ctx, password);
+            return SEARCH_FOUND;
+        }
+        ctx->passwords_checked += n;
+        start_index += n;
+        publish_progress(ctx, start_index);
+        more = enumerator_next_row(&e, n);
+    }
+
+    return SEARCH_DONE;
+}
+
+#define MATCH_SINGLE (-2)  // Digest igual ao hash único
+
+/**
+ * Compara um digest com o alvo (ou com a lista de alvos)
+ *
+ * @return Índice do alvo da lista, MATCH_SINGLE para o hash único, ou -1
+ */
+static inline int match_candidate(const SearchJob *job, const uint32_t state[4]) {
+    if (job->targets != NULL) {
+        return target_set_lookup(job->targets, state);
+    }
+    return md5_state_equal(state, job->target_state) ? MATCH_SINGLE : -1;
+}
+
+/**
+ * Relata um candidato que bateu com match_candidate()
+ *
+ * @return 1 se a busca terminou (hash único encontrado), 0 para continuar
+ */
+static int report_match(SearchContext *ctx, int match, const char *password) {
+    if (match == MATCH_SINGLE) {
+        report_found(ctx, password);
+        return 1;
+    }
+    report_target(ctx, match, password);
+    return 0;
+}
+
+/**
+ * Compara o digest de uma linha da wordlist e relata o acerto
+ *
+ * @return 1 se a busca terminou (hash único encontrado), 0 para continuar
+ */
+static int check_candidate(SearchContext *ctx, const uint32_t state[4], const char *line,
+                           size_t len) {
+    int match = match_candidate(ctx->job, state);
+    if (match == -1) {
+        return 0;
+    }
+
+    char password[WORDLIST_LINE_MAX + 1];
+    memcpy(password, line, len);
+    password[len] = '\0';
+    return report_match(ctx, match, password);
+}
+
+/**
+ * Próxima linha da wordlist, sem o fim de linha (LF ou CRLF)
+ *
+ * @param p Início da linha; avança para o início da seguinte
+ */
+static inline const char *next_line(const char **p, const char *file_end, size_t *len) {
+    const char *line = *p;
+    const char *newline = memchr(line, '\n', file_end - line);
+    *len = (newline != NULL ? newline : file_end) - line;
+    *p = newline != NULL ? newline + 1 : file_end;
+    if (*len > 0 && line[*len - 1] == '\r') {
+        (*len)--;  // Wordlists com fim de linha CRLF
+    }
+    return line;
+}
+
+/**
+ * Busca numa wordlist: as linhas são lidas direto do mapeamento e copiadas
+ * uma única vez, para o bloco MD5 do lote
+ */
+static SearchStatus search_range_words(SearchContext *ctx, long long start, long long count) {
+    const SearchJob *job = ctx->job;
+    const char *data = job->wordlist->data;
+    const char *file_end = data + job->wordlist->size;
+    const char *limit = data + start + count;
+    MD5Block blocks[MD5_BATCH_MAX];
+    uint32_t computed_states[MD5_BATCH_MAX][4];
+    const char *lines[MD5_BATCH_MAX];
+    size_t lengths[MD5_BATCH_MAX];
+
+    // Uma linha que começou antes do intervalo pertence ao intervalo anterior
+    const char *p = data + wordlist_line_start(job->wordlist, start);
+
+    while (p < limit) {
+        if (stop_requested(ctx)) {
+            return SEARCH_STOPPED;
+        }
+
+        int batch_size = 0;
+        while (batch_size < ctx->lanes && p < limit) {
+            size_t len;
+            const char *line = next_line(&p, file_end, &len);
+
+            if (len <= MD5_BLOCK_MAX_INPUT) {
+                md5_block_init(&blocks[batch_size], line, len);
+                lines[batch_size] = line;
+                lengths[batch_size++] = len;
+            } else if (len <= WORDLIST_LINE_MAX) {
+                // Mais de um bloco: fora do lote, pelo caminho genérico
+                uint32_t state[4];
+                md5_bytes(line, len, state);
+                ctx->passwords_checked++;
+                if (check_candidate(ctx, state, line, len)) {
+                    return SEARCH_FOUND;
+                }
+            } else {
+                ctx->words_skipped++;
+            }
+        }
+
+        md5_batch(blocks, batch_size, computed_states);
+        for (int i = 0; i < batch_size; i++) {
+            if (check_candidate(ctx, computed_states[i], lines[i], lengths[i])) {
+                ctx->passwords_checked += i + 1;
+                return SEARCH_FOUND;
+            }
+        }
+        ctx->passwords_checked += batch_size;
+        publish_progress(ctx, p - data);
+    }
+
+    return SEARCH_DONE;
+}
+
+/**
+ * Hasheia um lote de candidatos gerados pelas regras
+ * A senha de um acerto é lida de volta do bloco, o único lugar onde o
+ * candidato existe.
+ *
+ * @return 1 se a busca terminou (hash único encontrado), 0 para continuar
+ */
+static int check_rule_batch(SearchContext *ctx, const MD5Block *blocks, const int *lengths,
+                            int batch_size) {
+    uint32_t computed_states[MD5_BATCH_MAX][4];
+
+    md5_batch(blocks, batch_size, computed_states);
+    for (int i = 0; i < batch_size; i++) {
+        int match = match_candidate(ctx->job, computed_states[i]);
+        if (match != -1) {
+            char password[MD5_BLOCK_MAX_INPUT + 1];
+            for (int j = 0; j < lengths[i]; j++) {
+                password[j] = (char)md5_block_get_byte(&blocks[i], j);
+            }
+            password[lengths[i]] = '\0';
+            if (report_match(ctx, match, password)) {
+                ctx->passwords_checked += i + 1;
+                return 1;
+            }
+        }
+    }
+    ctx->passwords_checked += batch_size;
+    return 0;
+}
+
+/**
+ * Busca numa wordlist com regras: cada regra gera um candidato direto no
+ * próximo bloco livre do lote, que é hasheado sempre que enche, mesmo no
+ * meio das regras de uma palavra
+ */
+static SearchStatus search_range_rules(SearchContext *ctx, long long start, long long count) {
+    const SearchJob *job = ctx->job;
+    const char *data = job->wordlist->data;
+    const char *file_end = data + job->wordlist->size;
+    const char *limit = data + start + count;
+    MD5Block blocks[MD5_BATCH_MAX];
+    int lengths[MD5_BATCH_MAX];
+    int batch_size = 0;
+
+    const char *p = data + wordlist_line_start(job->wordlist, start);
+
+    while (p < limit) {
+        size_t len;
+        const char *line = next_line(&p, file_end, &len);
+        if (len > MD5_BLOCK_MAX_INPUT) {
+            ctx->words_skipped++;
+            continue;
+        }
+
+        for (int r = 0; r < job->num_rules; r++) {
+            int n = rule_apply(&job->rules[r], line, len, &blocks[batch_size]);
+            if (n < 0) {
+                continue;
+            }
+            lengths[batch_size++] = n;
+
+            if (batch_size == ctx->lanes) {
+                if (stop_requested(ctx)) {
+                    return SEARCH_STOPPED;
+                }
+                if (check_rule_batch(ctx, blocks, lengths, batch_size)) {
+                    return SEARCH_FOUND;
+                }
+                batch_size = 0;
+                // As linhas anteriores já foram hasheadas com todas as regras
+                publish_progress(ctx, line - data);
+            }
+        }
+    }
+
+    if (batch_size > 0 && check_rule_batch(ctx, blocks, lengths, batch_size)) {
+        return SEARCH_FOUND;
+    }
+    publish_progress(ctx, p - data);
+    return SEARCH_DONE;
+}
+
+/**
+ * Lote de blocos MD5 pré-formatados, hasheados juntos pelo núcleo SIMD
+ */
+static SearchStatus search_range_batch(SearchContext *ctx, KeyspaceIndex start_index,
+                                       long long count) {
+    const SearchJob *job = ctx->job;
+    MD5Block blocks[MD5_BATCH_MAX];
+    uint32_t computed_states[MD5_BATCH_MAX][4];
+    Enumerator e;
+    int more = count > 0;
+
+    enumerator_init(&e, job->keyspace, start_index, count);
+
+    while (more) {
+        if (stop_requested(ctx)) {
+            return SEARCH_STOPPED;
+        }
+
+        // Preencher o lote: cada candidato já está formatado no bloco do enumerador
+        int batch_size = 0;
+        do {
+            blocks[batch_size++] = e.block;
+            more = enumerator_next(&e);
+        } while (more && batch_size < ctx->lanes);
+
+        // Calcular o hash MD5 de todo o lote (a partir do midstate do prefixo)
+        // e comparar com o hash alvo
+        md5_batch_from(job->init_state, blocks, batch_size, computed_states);
+        for (int i = 0; i < batch_size; i++) {
+            if (md5_state_equal(computed_states[i], job->target_state)) {
+                char password[MAX_PASSWORD_LEN + 1];
+                enumerator_block_password(&blocks[i], job->keyspace, password);
+                ctx->passwords_checked += i + 1;
+                report_found(ctx, password);
+                return SEARCH_FOUND;
+            }
+        }
+        ctx->passwords_checked += batch_size;
+        start_index += batch_size;
+        publish_progress(ctx, start_index);
+    }
+
+    return SEARCH_DONE;
+}
+
+SearchStatus search_range(SearchContext *ctx, KeyspaceIndex start_index, KeyspaceIndex count) {
+    const SearchJob *job = ctx->job;
+    if (job->rules != NULL) {
+        return search_range_rules(ctx, (long long)start_index, (long long)count);
+    }
+    if (job->wordlist != NULL) {
+        return search_range_words(ctx, (long long)start_index, (long long)count);
+    }
+
+    while (count > 0) {
+        long long piece = count < SEARCH_PIECE_MAX ? (long long)count : SEARCH_PIECE_MAX;
+        SearchStatus status = job->targets != NULL ? search_range_list(ctx, start_index, piece) :
+                              job->scan != NULL ? search_range_scan(ctx, start_index, piece) :
+                              search_range_batch(ctx, start_index, piece);
+        if (status != SEARCH_DONE) {
+            return status;
+        }
+        start_index += piece;
+        count -= piece;
+    }
+    return SEARCH_DONE;
+}
+
+/**
+ * Reivindica um bloco e o publica no progresso do worker
+ * Enquanto claiming vale 1, o checkpoint não sabe qual bloco saiu da fila e
+ * espera pela próxima rodada: assim nenhum bloco reivindicado conta como feito.
+ */
+static KeyspaceIndex claim_chunk(SearchContext *ctx, long long want, KeyspaceIndex *count) {
+    WorkerProgress *progress = ctx->progress;
+    if (progress == NULL) {
+        return shared_state_claim(ctx->shared, want, count);
+    }
+
+    atomic_store(&progress->claiming, 1);
+    atomic_thread_fence(memory_order_seq_cst);
+    KeyspaceIndex start = shared_state_claim(ctx->shared, want, count);
+    if (start >= 0) {
+        worker_progress_set(progress, start, start + *count);
+    }
+    atomic_store(&progress->claiming, 0);
+    return start;
+}
+
+/**
+ * O tamanho do próximo bloco acompanha a taxa medida deste worker, para que
+ * workers mais lentos (SMT, vizinhos barulhentos) simplesmente peguem menos.
+ */
+SearchStatus search_dynamic(SearchContext *ctx) {
+    long long chunk = SCHED_CHUNK_MIN;
+
+    while (1) {
+        KeyspaceIndex count;
+        KeyspaceIndex start = claim_chunk(ctx, chunk, &count);
+        if (start < 0) {
+            return SEARCH_DONE;
+        }
+        ctx->chunks_claimed++;
+
+        double chunk_start = monotonic_seconds();
+        SearchStatus status = search_range(ctx, start, count);
+        if (status != SEARCH_DONE) {
+            return status;
+        }
+
+        double elapsed = monotonic_seconds() - chunk_start;
+        chunk = elapsed > 0 ? (long long)((double)count / elapsed * CHUNK_TARGET_SECONDS) :
+                              chunk * 2;
+        if (chunk < SCHED_CHUNK_MIN) chunk = SCHED_CHUNK_MIN;
+        if (chunk > CHUNK_MAX) chunk = CHUNK_MAX;
+    }
+}
@@ -0,0 +1,130 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <stdint.h>
+#include "hash_utils.h"
+#include "shared_state.h"
+#include "target_set.h"
+#include "keyspace.h"
+#include "wordlist.h"
+#include "rules.h"
+
+/**
+ * Laço de busca por força bruta, compartilhado pelos dois motores de execução:
+ * o processo worker (fork + execl) e as threads do coordinator (--engine threads).
+ */
+
+#define RESULT_FILE "password_found.txt"
+#define PROGRESS_INTERVAL 100000  // Consultar o arquivo de resultado a cada N senhas
+#define CHUNK_TARGET_SECONDS 0.05 // Duração alvo de cada bloco no escalonamento dinâmico
+#define CHUNK_MAX (1LL << 32)     // Maior bloco pedido à fila dinâmica
+#define SEARCH_PIECE_MAX (1LL << 62)  // Maior trecho contado em 64 bits pelos laços internos
+
+typedef enum {
+    SEARCH_DONE = 0,  // Intervalo verificado por completo
+    SEARCH_FOUND,     // Este worker encontrou a senha
+    SEARCH_STOPPED    // Outro worker encontrou a senha
+} SearchStatus;
+
+/**
+ * Parâmetros da busca, somente leitura e compartilhados por todos os workers
+ */
+typedef struct {
+    uint32_t target_state[4];   // Hash alvo decodificado uma única vez
+    uint32_t init_state[4];     // Midstate dos blocos inteiros do prefixo, ou o vetor inicial
+    const Keyspace *keyspace;   // Charset de cada posição (NULL com wordlist)
+    const Wordlist *wordlist;   // Wordlist mapeada (--wordlist), ou NULL
+    MD5ScanFn scan;             // Núcleo especializado para o comprimento, ou NULL
+    TargetSet *targets;         // Lista de alvos (--list), ou NULL para um hash só
+    const Rule *rules;          // Regras aplicadas a cada palavra (--rules), ou NULL
+    int num_rules;
+} SearchJob;
+
+/**
+ * Estado da busca de um worker, mantido entre os intervalos verificados
+ * Alinhado à linha de cache: no motor de threads os contextos ficam lado a
+ * lado num vetor e os contadores não podem disputar a mesma linha.
+ */
+typedef struct {
+    _Alignas(CACHE_LINE_SIZE) const SearchJob *job;
+    SharedState *shared;        // NULL na execução manual do worker
+    int worker_id;
+    int lanes;                  // Largura do lote MD5 (núcleo SIMD)
+    long long passwords_checked;
+    long long next_check;       // Próxima consulta ao arquivo de resultado
+    long long chunks_claimed;
+    int cracked;                // Alvos da lista quebrados por este worker
+    WorkerProgress *progress;   // Progresso publicado para o checkpoint, ou NULL
+    long long words_skipped;    // Linhas da wordlist longas demais (WORDLIST_LINE_MAX,
+                                // ou MD5_BLOCK_MAX_INPUT com regras)
+} SearchContext;
+
+/**
+ * Prepara o hash alvo e o espaço de busca
+ *
+ * @return 0 em caso de sucesso, -1 se o hash alvo não for um MD5 hex válido
+ */
+int search_job_init(SearchJob *job, const char *target_hash, const Keyspace *keyspace);
+
+/**
+ * Prepara uma busca por todos os hashes de um conjunto de alvos (--list)
+ * Cada senha encontrada é relatada na hora e a busca segue até o espaço
+ * acabar ou todos os alvos estarem quebrados.
+ */
+void search_job_init_list(SearchJob *job, TargetSet *targets, const Keyspace *keyspace);
+
+/**
+ * Troca o espaço de busca por uma wordlist (depois de search_job_init ou
+ * search_job_init_list, com keyspace NULL)
+ * Índices e contagens passam a ser deslocamentos em bytes no arquivo: um
+ * intervalo verifica as linhas que começam dentro dele.
+ */
+void search_job_use_wordlist(SearchJob *job, const Wordlist *wordlist);
+
+/**
+ * Aplica cada regra a cada palavra da wordlist (depois de search_job_use_wordlist)
+ * Os candidatos são gerados direto nos blocos do lote; a própria palavra só
+ * é testada se o conjunto tiver a regra ':'.
+ */
+void search_job_use_rules(SearchJob *job, const Rule *rules, int num_rules);
+
+/**
+ * Prepara o contexto de um worker
+ */
+void search_context_init(SearchContext *ctx, const SearchJob *job, SharedState *shared,
+                         int worker_id);
+
+/**
+ * Verifica count senhas a partir do índice start_index, um lote por vez
+ * Intervalos acima de SEARCH_PIECE_MAX (divisão estática de senhas longas)
+ * são percorridos em trechos.
+ */
+SearchStatus search_range(SearchContext *ctx, KeyspaceIndex start_index, KeyspaceIndex count);
+
+/**
+ * Escalonamento dinâmico: reivindica blocos da fila compartilhada até ela acabar
+ */
+SearchStatus search_dynamic(SearchContext *ctx);
+
+/**
+ * Verifica se o arquivo de resultado já existe
+ * Usado para parada antecipada se outro worker já encontrou a senha
+ * (apenas na execução manual, sem a página compartilhada)
+ */
+int check_result_exists(void);
+
+/**
+ * Salva a senha encontrada no arquivo de resultado
+ * Usa O_CREAT | O_EXCL para garantir escrita atômica (apenas um worker escreve)
+ */
+void save_result(int worker_id, const char *password);
+
+/**
+ * Acrescenta uma linha "hash:worker_id:password" ao arquivo de resultado
+ * Usado no modo --list: o arquivo vira um fluxo de resultados, um por alvo
+ * quebrado. Cada linha sai num único write() com O_APPEND, então linhas de
+ * workers diferentes nunca se misturam.
+ */
+void append_result(const char *hash, int worker_id, const char *password);
+
+#endif // SEARCH_H
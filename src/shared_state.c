@@ -0,0 +1,237 @@
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "shared_state.h"
+
+/**
+ * Estado inicial: nenhum resultado, fila vazia, região extra ainda não distribuída
+ */
+static void shared_state_reset(SharedState *state, size_t size, size_t extra_offset) {
+    atomic_init(&state->found, 0);
+    atomic_init(&state->winner, -1);
+    state->password[0] = '\0';
+    state->coordinator_pid = getpid();
+    state->size = size;
+    state->extra_offset = extra_offset;
+    state->targets_offset = 0;
+    state->rules_offset = 0;
+    state->num_rules = 0;
+    state->progress_offset = 0;
+    state->ranges_offset = 0;
+    state->num_ranges = 0;
+    state->pool_offset = 0;
+    state->dynamic = 0;
+    state->num_workers = 1;
+    state->total = 0;
+    state->queue_size = 0;
+    state->queue_shift = 0;
+    atomic_init(&state->next_index, 0);
+}
+
+SharedState *shared_state_create(int *fd, size_t extra) {
+    size_t header = (sizeof(SharedState) + CACHE_LINE_SIZE - 1) & ~(size_t)(CACHE_LINE_SIZE - 1);
+    size_t size = header + extra;
+
+    char name[64];
+    snprintf(name, sizeof(name), "/quebra-senhas-%d", (int)getpid());
+
+    int shm_fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (shm_fd < 0) {
+        perror("shm_open");
+        return NULL;
+    }
+    // Só o descritor é necessário: nada fica para trás se o processo morrer
+    shm_unlink(name);
+
+    // shm_open() marca FD_CLOEXEC; os workers precisam herdar o descritor
+    if (ftruncate(shm_fd, size) < 0 || fcntl(shm_fd, F_SETFD, 0) < 0) {
+        perror("ftruncate/fcntl");
+        close(shm_fd);
+        return NULL;
+    }
+
+    SharedState *state = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
+    if (state == MAP_FAILED) {
+        perror("mmap");
+        close(shm_fd);
+        return NULL;
+    }
+
+    shared_state_reset(state, size, extra ? header : 0);
+
+    *fd = shm_fd;
+    return state;
+}
+
+SharedState *shared_state_create_private(void) {
+    size_t size = (sizeof(SharedState) + CACHE_LINE_SIZE - 1) & ~(size_t)(CACHE_LINE_SIZE - 1);
+    SharedState *state = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                              -1, 0);
+    if (state == MAP_FAILED) {
+        perror("mmap");
+        return NULL;
+    }
+
+    shared_state_reset(state, size, 0);
+    return state;
+}
+
+void shared_state_init(SharedState *state) {
+    shared_state_reset(state, sizeof(*state), 0);
+}
+
+SharedState *shared_state_attach(int fd) {
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(SharedState)) {
+        perror("fstat");
+        return NULL;
+    }
+
+    SharedState *state = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (state == MAP_FAILED) {
+        perror("mmap");
+        return NULL;
+    }
+    return state;
+}
+
+void shared_state_destroy(SharedState *state, int fd) {
+    if (state != NULL) {
+        munmap(state, state->size);
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+int shared_state_publish(SharedState *state, int worker_id, const char *password) {
+    int expected = -1;
+
+    if (!atomic_compare_exchange_strong(&state->winner, &expected, worker_id)) {
+        return 0;  // Outro worker chegou primeiro
+    }
+
+    strncpy(state->password, password, SHARED_PASSWORD_MAX - 1);
+    state->password[SHARED_PASSWORD_MAX - 1] = '\0';
+
+    // release: quem observar found == 1 com acquire enxerga a senha completa
+    atomic_store_explicit(&state->found, 1, memory_order_release);
+    return 1;
+}
+
+/**
+ * Posições da fila ocupadas por count índices (a última pode ficar incompleta)
+ */
+static long long queue_positions(const SharedState *state, KeyspaceIndex count) {
+    return (long long)((count + ((KeyspaceIndex)1 << state->queue_shift) - 1) >> state->queue_shift);
+}
+
+void shared_state_set_queue(SharedState *state, KeyspaceIndex total) {
+    state->total = total;
+    state->queue_shift = 0;
+    while ((total >> state->queue_shift) >= SHARED_QUEUE_MAX) {
+        state->queue_shift++;
+    }
+
+    if (state->ranges_offset == 0) {
+        state->queue_size = queue_positions(state, total);
+        return;
+    }
+    IndexRange *ranges = (IndexRange *)((char *)state + state->ranges_offset);
+    long long offset = 0;
+    for (int i = 0; i < state->num_ranges; i++) {
+        ranges[i].offset = offset;
+        offset += queue_positions(state, ranges[i].count);
+    }
+    state->queue_size = offset;
+}
+
+KeyspaceIndex shared_state_range_claimed(const SharedState *state, const IndexRange *range,
+                                         long long next) {
+    if (next <= range->offset) {
+        return 0;
+    }
+    KeyspaceIndex claimed = (KeyspaceIndex)(next - range->offset) << state->queue_shift;
+    return claimed < range->count ? claimed : range->count;
+}
+
+KeyspaceIndex shared_state_dispensed(const SharedState *state) {
+    long long next = atomic_load_explicit(&state->next_index, memory_order_relaxed);
+    const IndexRange *ranges = shared_state_ranges(state);
+    if (ranges == NULL) {
+        IndexRange whole = {0, state->total, 0};
+        return shared_state_range_claimed(state, &whole, next);
+    }
+
+    KeyspaceIndex dispensed = 0;
+    for (int i = 0; i < state->num_ranges && ranges[i].offset < next; i++) {
+        dispensed += shared_state_range_claimed(state, &ranges[i], next);
+    }
+    return dispensed;
+}
+
+KeyspaceIndex shared_state_claim(SharedState *state, long long want, KeyspaceIndex *count) {
+    // Leitura aproximada do que resta: só orienta o tamanho do bloco. Daqui
+    // em diante, tudo em posições da fila
+    long long left = state->queue_size - atomic_load_explicit(&state->next_index,
+                                                              memory_order_relaxed);
+    if (left <= 0) {
+        return -1;
+    }
+
+    long long guided = left / (2LL * state->num_workers);
+    long long minimum = state->queue_shift < 63 ? SCHED_CHUNK_MIN >> state->queue_shift : 0;
+    want = state->queue_shift < 63 ? want >> state->queue_shift : 0;
+    if (want > guided) {
+        want = guided > minimum ? guided : minimum;
+    }
+    if (want < 1) {
+        want = 1;
+    }
+
+    const IndexRange *ranges = shared_state_ranges(state);
+    if (ranges == NULL) {
+        long long start = atomic_fetch_add_explicit(&state->next_index, want, memory_order_relaxed);
+        if (start >= state->queue_size) {
+            return -1;
+        }
+        KeyspaceIndex first = (KeyspaceIndex)start << state->queue_shift;
+        KeyspaceIndex taken = (KeyspaceIndex)want << state->queue_shift;
+        *count = state->total - first < taken ? state->total - first : taken;
+        return first;
+    }
+
+    // Com intervalos, o bloco é cortado no fim do intervalo: o avanço da fila
+    // depende da posição, então é feito com compare-and-swap
+    long long next = atomic_load_explicit(&state->next_index, memory_order_relaxed);
+    const IndexRange *range;
+    long long take;
+    do {
+        if (next >= state->queue_size) {
+            return -1;
+        }
+        int lo = 0, hi = state->num_ranges - 1;
+        while (lo < hi) {
+            int mid = (lo + hi + 1) / 2;
+            if (ranges[mid].offset <= next) {
+                lo = mid;
+            } else {
+                hi = mid - 1;
+            }
+        }
+        range = &ranges[lo];
+        take = range->offset + queue_positions(state, range->count) - next;
+        if (take > want) {
+            take = want;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&state->next_index, &next, next + take,
+                                                    memory_order_relaxed, memory_order_relaxed));
+
+    KeyspaceIndex skipped = shared_state_range_claimed(state, range, next);
+    KeyspaceIndex taken = (KeyspaceIndex)take << state->queue_shift;
+    *count = range->count - skipped < taken ? range->count - skipped : taken;
+    return range->start + skipped;
+}
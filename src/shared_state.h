@@ -0,0 +1,256 @@
+#ifndef SHARED_STATE_H
+#define SHARED_STATE_H
+
+#include <stdatomic.h>
+#include <sys/types.h>
+#include <time.h>
+#include "keyspace.h"
+
+#define SHARED_PASSWORD_MAX 64  // Espaço da senha no slot de resultado (com '\0')
+#define SCHED_CHUNK_MIN 1024    // Menor bloco de índices entregue pela fila dinâmica
+#define SHARED_QUEUE_MAX (1LL << 62)  // Posições da fila: o contador é um atomic de 64 bits
+#define CACHE_LINE_SIZE 64
+
+/**
+ * Relógio monotônico em segundos, com resolução de nanossegundos
+ */
+static inline double monotonic_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * Intervalo de índices ainda não verificado (--resume)
+ * A fila dinâmica percorre os intervalos em sequência, como se fossem um
+ * espaço contínuo: offset é a posição do intervalo nesse espaço.
+ */
+typedef struct {
+    KeyspaceIndex start;                 // Primeiro índice real
+    KeyspaceIndex count;
+    long long offset;                    // Posições da fila antes deste intervalo
+} IndexRange;
+
+/**
+ * Índice de 128 bits publicado para outro processo: sem atomics de 16 bytes
+ * livres de trava, as metades são stores separadas, protegidas pelo contador
+ * de sequência do WorkerProgress
+ */
+typedef struct {
+    atomic_ullong lo;
+    atomic_ullong hi;
+} SharedIndex;
+
+/**
+ * Progresso de um worker, lido pelo coordinator para o checkpoint e a telemetria
+ * [start, next) já foi verificado e [next, end) está em andamento. Cada
+ * worker escreve só na sua linha de cache.
+ *
+ * start, end e next mudam juntos sob seq (seqlock): ímpar durante uma escrita,
+ * e quem lê repete se o valor mudou no meio. Para o worker são só stores.
+ */
+typedef struct {
+    _Alignas(CACHE_LINE_SIZE) atomic_uint seq;
+    atomic_int claiming;                 // 1 entre reivindicar um bloco e publicá-lo aqui
+    atomic_llong checked;                // Senhas verificadas desde o início
+    SharedIndex start;
+    SharedIndex end;
+    SharedIndex next;
+} WorkerProgress;
+
+/**
+ * Página de memória compartilhada entre o coordinator e os workers
+ *
+ * Substitui a consulta a password_found.txt no laço quente: os workers leem a
+ * flag "found" com uma carga relaxed a cada lote, e o vencedor ocupa o slot de
+ * resultado com compare-and-swap, de modo que apenas um worker escreve.
+ */
+typedef struct {
+    atomic_int found;                    // 1 quando a senha já foi encontrada
+    atomic_int winner;                   // -1 = slot livre; senão id do worker vencedor
+    char password[SHARED_PASSWORD_MAX];  // Senha do vencedor (válida quando found == 1)
+    pid_t coordinator_pid;               // Avisado com SIGUSR1 quando há resultado
+    size_t size;                         // Tamanho total do mapeamento
+    size_t extra_offset;                 // Início da região extra após a página, ou 0
+    size_t targets_offset;               // Conjunto de alvos (--list) na região extra, ou 0
+    size_t rules_offset;                 // Regras compiladas (--rules) na região extra, ou 0
+    int num_rules;
+    size_t progress_offset;              // Um WorkerProgress por worker, ou 0
+    size_t ranges_offset;                // Intervalos da fila (--resume), ou 0 = [0, total)
+    int num_ranges;
+    size_t pool_offset;                  // Fila de trabalhos (--queue) na região extra, ou 0
+    int profile;                         // 1 = contadores de hardware por worker (--perf)
+
+    // Escalonamento dinâmico: o espaço de busca vira uma fila de blocos de
+    // índices, e cada worker reivindica o próximo com um fetch-add. Acima de
+    // SHARED_QUEUE_MAX índices, cada posição da fila cobre 2^queue_shift deles
+    int dynamic;                         // 1 = workers ignoram o intervalo do argv
+    int num_workers;
+    KeyspaceIndex total;                 // Tamanho do espaço de busca (da fila, com --resume)
+    long long queue_size;                // Posições da fila (shared_state_set_queue)
+    int queue_shift;
+    Keyspace keyspace;                   // Charset de cada posição; prevalece sobre o argv
+    _Alignas(CACHE_LINE_SIZE) atomic_llong next_index;  // Próxima posição não distribuída
+                                                        // (linha própria: não disputa com "found")
+} SharedState;
+
+/**
+ * Cria a página compartilhada (coordinator)
+ * O objeto POSIX é removido do namespace logo após a criação; os workers o
+ * recebem pelo descritor herdado no execl(), passado como argumento.
+ *
+ * @param fd Saída: descritor herdável da página
+ * @param extra Bytes reservados após o SharedState (alinhados à linha de cache),
+ *              a partir de extra_offset; 0 para nenhum. Quem cria a página
+ *              distribui a região e preenche os deslocamentos (*_offset).
+ * @return Ponteiro para a página mapeada ou NULL em caso de erro
+ */
+SharedState *shared_state_create(int *fd, size_t extra);
+
+/**
+ * Página privada do processo, sem região extra (worker remoto)
+ * Mesma interface da página compartilhada: a parada e o resultado chegam e
+ * saem pela rede, mas o laço de busca não precisa saber disso.
+ *
+ * @return Ponteiro para a página ou NULL em caso de erro
+ */
+SharedState *shared_state_create_private(void);
+
+/**
+ * Estado de busca embutido em outra estrutura da página (um trabalho da
+ * fila --queue): sem região extra, resultado avisado a este processo
+ */
+void shared_state_init(SharedState *state);
+
+/**
+ * Mapeia a página recebida do coordinator (worker)
+ * O tamanho vem do próprio objeto, então a região extra também é mapeada.
+ *
+ * @param fd Descritor herdado
+ * @return Ponteiro para a página mapeada ou NULL em caso de erro
+ */
+SharedState *shared_state_attach(int fd);
+
+/**
+ * Desfaz o mapeamento (e fecha o descritor, se fd >= 0)
+ */
+void shared_state_destroy(SharedState *state, int fd);
+
+/**
+ * Tenta ocupar o slot de resultado com a senha encontrada
+ * Apenas o primeiro worker vence; os demais apenas param.
+ *
+ * @return 1 se este worker foi o vencedor, 0 caso contrário
+ */
+int shared_state_publish(SharedState *state, int worker_id, const char *password);
+
+/**
+ * Monta a fila dinâmica sobre total índices: o espaço [0, total), ou os
+ * intervalos já gravados em shared_state_ranges() (--resume), que recebem
+ * aqui os seus deslocamentos
+ */
+void shared_state_set_queue(SharedState *state, KeyspaceIndex total);
+
+/**
+ * Reivindica o próximo bloco da fila dinâmica
+ * O tamanho pedido é limitado pelo que resta dividido entre os workers
+ * (nunca abaixo de SCHED_CHUNK_MIN), para que o final da busca fique equilibrado.
+ *
+ * Com intervalos (--resume), um bloco nunca atravessa o fim de um intervalo.
+ *
+ * @param want Tamanho de bloco desejado pelo worker (adaptado à sua taxa)
+ * @param count Saída: quantidade de índices efetivamente entregues
+ * @return Primeiro índice (real) do bloco, ou -1 se a fila acabou
+ */
+KeyspaceIndex shared_state_claim(SharedState *state, long long want, KeyspaceIndex *count);
+
+/**
+ * Índices de um intervalo da fila já entregues quando a fila está na posição next
+ */
+KeyspaceIndex shared_state_range_claimed(const SharedState *state, const IndexRange *range,
+                                         long long next);
+
+/**
+ * Índices já entregues pela fila dinâmica (lido sem sincronizar: aproximado)
+ */
+KeyspaceIndex shared_state_dispensed(const SharedState *state);
+
+/**
+ * Progresso dos workers, ou NULL sem checkpoint
+ */
+static inline WorkerProgress *shared_state_progress(SharedState *state) {
+    return state->progress_offset ? (WorkerProgress *)((char *)state + state->progress_offset) : NULL;
+}
+
+static inline void shared_index_store(SharedIndex *slot, KeyspaceIndex value) {
+    atomic_store_explicit(&slot->lo, (unsigned long long)value, memory_order_relaxed);
+    atomic_store_explicit(&slot->hi, (unsigned long long)(value >> 64), memory_order_relaxed);
+}
+
+static inline KeyspaceIndex shared_index_load(const SharedIndex *slot) {
+    unsigned long long lo = atomic_load_explicit(&slot->lo, memory_order_relaxed);
+    unsigned long long hi = atomic_load_explicit(&slot->hi, memory_order_relaxed);
+    return (KeyspaceIndex)(((unsigned __int128)hi << 64) | lo);
+}
+
+/**
+ * Publica um intervalo novo (next = start); só o dono do slot escreve
+ */
+static inline void worker_progress_set(WorkerProgress *progress, KeyspaceIndex start,
+                                       KeyspaceIndex end) {
+    unsigned seq = atomic_load_explicit(&progress->seq, memory_order_relaxed);
+    atomic_store_explicit(&progress->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    shared_index_store(&progress->start, start);
+    shared_index_store(&progress->end, end);
+    shared_index_store(&progress->next, start);
+    atomic_store_explicit(&progress->seq, seq + 2, memory_order_release);
+}
+
+/**
+ * Publica até onde o intervalo atual foi verificado (no laço quente: no x86,
+ * só stores comuns)
+ */
+static inline void worker_progress_advance(WorkerProgress *progress, KeyspaceIndex next) {
+    unsigned seq = atomic_load_explicit(&progress->seq, memory_order_relaxed);
+    atomic_store_explicit(&progress->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    shared_index_store(&progress->next, next);
+    atomic_store_explicit(&progress->seq, seq + 2, memory_order_release);
+}
+
+/**
+ * Lê start, end e next de um mesmo momento
+ *
+ * @return 1 em caso de sucesso, 0 se o worker escrevia em todas as tentativas
+ */
+static inline int worker_progress_read(const WorkerProgress *progress, KeyspaceIndex *start,
+                                       KeyspaceIndex *end, KeyspaceIndex *next) {
+    for (int tries = 0; tries < 1000; tries++) {
+        unsigned seq = atomic_load_explicit(&progress->seq, memory_order_acquire);
+        *start = shared_index_load(&progress->start);
+        *end = shared_index_load(&progress->end);
+        *next = shared_index_load(&progress->next);
+        atomic_thread_fence(memory_order_acquire);
+        if (!(seq & 1) && atomic_load_explicit(&progress->seq, memory_order_relaxed) == seq) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Intervalos percorridos pela fila dinâmica, ou NULL para o espaço inteiro
+ */
+static inline const IndexRange *shared_state_ranges(const SharedState *state) {
+    return state->ranges_offset ? (const IndexRange *)((const char *)state + state->ranges_offset) : NULL;
+}
+
+/**
+ * Verificação barata de parada, feita a cada lote no laço quente
+ */
+static inline int shared_state_stop_requested(SharedState *state) {
+    return atomic_load_explicit(&state->found, memory_order_relaxed);
+}
+
+#endif // SHARED_STATE_H
@@ -0,0 +1,152 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "target_set.h"
+
+#define FILTER_BITS_PER_TARGET 16
+#define FILTER_MIN_BITS 512
+
+int target_list_load(const char *path, uint32_t (**states)[4], int *count) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        perror(path);
+        return -1;
+    }
+
+    uint32_t (*list)[4] = NULL;
+    int capacity = 0, used = 0, line_number = 0;
+    char line[512];
+
+    while (fgets(line, sizeof(line), file) != NULL) {
+        line_number++;
+        // Hash = primeiro campo da linha (até ':', espaço ou fim de linha)
+        line[strcspn(line, ": \t\r\n")] = '\0';
+        if (line[0] == '\0' || line[0] == '#') {
+            continue;
+        }
+
+        if (used == capacity) {
+            capacity = capacity ? capacity * 2 : 1024;
+            uint32_t (*grown)[4] = realloc(list, capacity * sizeof(*list));
+            if (grown == NULL) {
+                perror("realloc");
+                free(list);
+                fclose(file);
+                return -1;
+            }
+            list = grown;
+        }
+
+        if (md5_hex_to_state(line, list[used]) != 0) {
+            fprintf(stderr, "%s:%d: hash MD5 inválido ignorado: %s\n", path, line_number, line);
+            continue;
+        }
+        used++;
+    }
+
+    fclose(file);
+    *states = list;
+    *count = used;
+    return 0;
+}
+
+static uint32_t next_power_of_two(uint32_t n) {
+    uint32_t p = 1;
+    while (p < n) {
+        p <<= 1;
+    }
+    return p;
+}
+
+/**
+ * Tamanhos das três regiões, todas em múltiplos da linha de cache
+ */
+static void target_set_layout(int count, uint32_t *filter_bits, uint32_t *table_size,
+                              size_t offsets[3], size_t *total) {
+    *filter_bits = next_power_of_two((uint32_t)count * FILTER_BITS_PER_TARGET);
+    if (*filter_bits < FILTER_MIN_BITS) {
+        *filter_bits = FILTER_MIN_BITS;
+    }
+    *table_size = next_power_of_two((uint32_t)count * 2 + 1);
+
+    size_t header = (sizeof(TargetSet) + CACHE_LINE_SIZE - 1) & ~(size_t)(CACHE_LINE_SIZE - 1);
+    size_t filter = *filter_bits / 8;
+    size_t table = ((size_t)*table_size * sizeof(TargetSlot) + CACHE_LINE_SIZE - 1) &
+                   ~(size_t)(CACHE_LINE_SIZE - 1);
+
+    offsets[0] = header;
+    offsets[1] = header + filter;
+    offsets[2] = header + filter + table;
+    *total = offsets[2] + (size_t)count * sizeof(TargetEntry);
+}
+
+size_t target_set_size(int count) {
+    uint32_t filter_bits, table_size;
+    size_t offsets[3], total;
+    target_set_layout(count, &filter_bits, &table_size, offsets, &total);
+    return total;
+}
+
+void target_set_build(TargetSet *set, const uint32_t (*states)[4], int count) {
+    uint32_t filter_bits, table_size;
+    size_t offsets[3], total;
+    target_set_layout(count, &filter_bits, &table_size, offsets, &total);
+
+    set->count = 0;
+    atomic_init(&set->cracked, 0);
+    set->filter_mask = filter_bits - 1;
+    set->table_mask = table_size - 1;
+    set->filter_offset = offsets[0];
+    set->table_offset = offsets[1];
+    set->entries_offset = offsets[2];
+
+    uint64_t *filter = (uint64_t *)((char *)set + set->filter_offset);
+    TargetSlot *table = (TargetSlot *)((char *)set + set->table_offset);
+    memset(filter, 0, filter_bits / 8);
+    for (uint32_t i = 0; i < table_size; i++) {
+        table[i].key = 0;
+        table[i].index = -1;
+    }
+
+    for (int i = 0; i < count; i++) {
+        const uint32_t *state = states[i];
+        if (target_set_lookup(set, state) >= 0) {
+            continue;  // Repetido
+        }
+
+        uint32_t slot = state[0] & set->table_mask;
+        while (table[slot].index >= 0) {
+            slot = (slot + 1) & set->table_mask;
+        }
+
+        TargetEntry *entry = target_set_entry(set, set->count);
+        memcpy(entry->state, state, sizeof(entry->state));
+        atomic_init(&entry->winner, -1);
+        entry->password[0] = '\0';
+
+        table[slot].key = state[0];
+        table[slot].index = set->count++;
+
+        uint32_t bit1 = state[1] & set->filter_mask;
+        uint32_t bit2 = state[2] & set->filter_mask;
+        filter[bit1 >> 6] |= 1ULL << (bit1 & 63);
+        filter[bit2 >> 6] |= 1ULL << (bit2 & 63);
+    }
+}
+
+int target_set_publish(TargetSet *set, int index, int worker_id, const char *password) {
+    TargetEntry *entry = target_set_entry(set, index);
+    int expected = -1;
+
+    // Reserva o slot antes de escrever: outro worker com o mesmo digest
+    // (colisão dentro do espaço de busca) não sobrescreve a senha
+    if (!atomic_compare_exchange_strong(&entry->winner, &expected, -2)) {
+        return 0;
+    }
+    strncpy(entry->password, password, SHARED_PASSWORD_MAX - 1);
+    entry->password[SHARED_PASSWORD_MAX - 1] = '\0';
+    atomic_store_explicit(&entry->winner, worker_id, memory_order_release);
+
+    atomic_fetch_add(&set->cracked, 1);
+    return 1;
+}
@@ -0,0 +1,119 @@
+#ifndef TARGET_SET_H
+#define TARGET_SET_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include "hash_utils.h"
+#include "shared_state.h"
+
+/**
+ * Conjunto de hashes alvo (--list): uma única passada pelo espaço de busca
+ * verifica cada digest calculado contra todos os alvos
+ *
+ * Fica na página compartilhada, logo após o SharedState, e é montado pelo
+ * coordinator antes de criar os workers. Por isso não guarda ponteiros, só
+ * deslocamentos a partir do próprio início. A consulta custa em média um
+ * acesso ao filtro, que rejeita quase todos os digests:
+ *
+ *   filtro  - mapa de bits com 16 bits por alvo; dois bits por digest,
+ *             tirados das palavras 1 e 2 (um filtro de Bloom com k = 2)
+ *   tabela  - endereçamento aberto com sondagem linear, chave = palavra 0,
+ *             ocupação máxima de 50%; cada entrada tem 8 bytes
+ *   alvos   - estado completo de cada alvo e seu slot de resultado
+ */
+
+/**
+ * Um hash alvo e o seu resultado
+ */
+typedef struct {
+    uint32_t state[4];                   // Digest decodificado
+    atomic_int winner;                   // -1 = não quebrado, -2 = sendo gravado; senão id do worker
+    char password[SHARED_PASSWORD_MAX];  // Válida quando winner >= 0
+} TargetEntry;
+
+/**
+ * Entrada da tabela de endereçamento aberto
+ */
+typedef struct {
+    uint32_t key;                        // Palavra 0 do digest
+    int32_t index;                       // Índice em entries, ou -1 = vazia
+} TargetSlot;
+
+typedef struct {
+    int count;                           // Alvos distintos
+    atomic_int cracked;                  // Alvos já quebrados
+    uint32_t filter_mask;                // Bits do filtro - 1
+    uint32_t table_mask;                 // Entradas da tabela - 1
+    size_t filter_offset;                // Deslocamentos a partir do início do conjunto
+    size_t table_offset;
+    size_t entries_offset;
+} TargetSet;
+
+/**
+ * Lê um arquivo com um hash MD5 hexadecimal por linha
+ * Linhas vazias e iniciadas por '#' são ignoradas; o que vier após ':' ou um
+ * espaço é descartado (aceita listas "hash:qualquer coisa"). Linhas inválidas
+ * são relatadas e puladas.
+ *
+ * @param states Saída: vetor alocado com os estados (liberar com free)
+ * @param count Saída: número de hashes válidos
+ * @return 0 em caso de sucesso, -1 se o arquivo não pôde ser lido
+ */
+int target_list_load(const char *path, uint32_t (**states)[4], int *count);
+
+/**
+ * Bytes necessários para um conjunto com até count alvos
+ */
+size_t target_set_size(int count);
+
+/**
+ * Monta o conjunto no espaço já reservado (target_set_size(count) bytes)
+ * Hashes repetidos entram uma vez só.
+ */
+void target_set_build(TargetSet *set, const uint32_t (*states)[4], int count);
+
+/**
+ * Conjunto guardado na página compartilhada, ou NULL no modo de hash único
+ */
+static inline TargetSet *target_set_from_shared(SharedState *state) {
+    return state->targets_offset ? (TargetSet *)((char *)state + state->targets_offset) : NULL;
+}
+
+static inline TargetEntry *target_set_entry(const TargetSet *set, int index) {
+    return (TargetEntry *)((char *)set + set->entries_offset) + index;
+}
+
+/**
+ * Procura um digest calculado entre os alvos
+ *
+ * @return Índice do alvo, ou -1 se o digest não é de nenhum alvo
+ */
+static inline int target_set_lookup(const TargetSet *set, const uint32_t state[4]) {
+    const uint64_t *filter = (const uint64_t *)((const char *)set + set->filter_offset);
+    uint32_t bit1 = state[1] & set->filter_mask;
+    uint32_t bit2 = state[2] & set->filter_mask;
+
+    if (!((filter[bit1 >> 6] >> (bit1 & 63)) & (filter[bit2 >> 6] >> (bit2 & 63)) & 1)) {
+        return -1;
+    }
+
+    const TargetSlot *table = (const TargetSlot *)((const char *)set + set->table_offset);
+    for (uint32_t i = state[0] & set->table_mask; table[i].index >= 0;
+         i = (i + 1) & set->table_mask) {
+        if (table[i].key == state[0] &&
+            md5_state_equal(target_set_entry(set, table[i].index)->state, state)) {
+            return table[i].index;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Registra a senha de um alvo; só o primeiro worker a quebrá-lo vence
+ *
+ * @return 1 se este worker registrou o resultado, 0 se o alvo já estava quebrado
+ */
+int target_set_publish(TargetSet *set, int index, int worker_id, const char *password);
+
+#endif // TARGET_SET_H
@@ -0,0 +1,242 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <time.h>
+#include "telemetry.h"
+
+#define SECONDS_PER_YEAR (365.25 * 24 * 3600)
+
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Escreve uma duração como h:mm:ss (ou "--" se desconhecida)
+ * Acima de um século, em anos: espaços de 128 bits passam do que cabe em segundos.
+ */
+static void format_duration(FILE *out, double seconds) {
+    if (!isfinite(seconds) || seconds < 0) {
+        fputs("--", out);
+        return;
+    }
+    if (seconds >= 100 * SECONDS_PER_YEAR) {
+        fprintf(out, "%.3g anos", seconds / SECONDS_PER_YEAR);
+        return;
+    }
+    long long s = (long long)(seconds + 0.5);
+    fprintf(out, "%lld:%02lld:%02lld", s / 3600, s / 60 % 60, s % 60);
+}
+
+/**
+ * Índices do espaço de busca já cobertos
+ * Dinâmico: tudo o que saiu da fila menos o que ainda está em andamento nos
+ * workers. Estático: a soma do que cada worker percorreu do seu intervalo.
+ * O que um checkpoint já cobria (--resume) entra como feito.
+ */
+static KeyspaceIndex covered_indices(const TelemetryMonitor *monitor) {
+    SharedState *shared = monitor->shared;
+    WorkerProgress *progress = shared_state_progress(shared);
+    KeyspaceIndex covered = monitor->total - shared->total;
+
+    if (shared->dynamic) {
+        covered += shared_state_dispensed(shared);
+    }
+    for (int i = 0; i < shared->num_workers; i++) {
+        KeyspaceIndex start, end, next;
+        if (!worker_progress_read(&progress[i], &start, &end, &next)) {
+            continue;
+        }
+        if (shared->dynamic) {
+            covered -= next < end ? end - next : 0;
+        } else {
+            covered += next - start;
+        }
+    }
+
+    // As leituras não são um instantâneo: durante uma reivindicação a fila já
+    // avançou e o slot do worker ainda não
+    return covered < 0 ? 0 : covered > monitor->total ? monitor->total : covered;
+}
+
+/**
+ * Um relatório: taxas desde o relatório anterior, cobertura, ETA e lentos
+ * Montado num buffer e impresso de uma vez, para não se misturar com as
+ * mensagens do coordinator.
+ */
+static void telemetry_report(TelemetryMonitor *monitor) {
+    SharedState *shared = monitor->shared;
+    WorkerProgress *progress = shared_state_progress(shared);
+    int n = shared->num_workers;
+    double now = monotonic_seconds();
+    double elapsed = now - monitor->last;
+    double *rates = malloc(2 * n * sizeof(double));
+    char *active = malloc(n);
+    char *buffer = NULL;
+    size_t size = 0;
+    FILE *out = NULL;
+
+    if (rates == NULL || active == NULL || elapsed <= 0 ||
+        (out = open_memstream(&buffer, &size)) == NULL) {
+        free(rates);
+        free(active);
+        return;
+    }
+    double *sorted = rates + n;
+
+    // Na fila dinâmica, qualquer worker ainda pode pegar um bloco
+    int queue_left = shared->dynamic &&
+                     atomic_load_explicit(&shared->next_index, memory_order_relaxed) <
+                         shared->queue_size;
+    long long checked_total = 0;
+    double rate_total = 0, eta = 0;
+    int num_active = 0;
+
+    for (int i = 0; i < n; i++) {
+        long long checked = atomic_load_explicit(&progress[i].checked, memory_order_relaxed);
+        KeyspaceIndex start, end, next;
+        if (!worker_progress_read(&progress[i], &start, &end, &next)) {
+            next = end = monitor->last_next[i];
+        }
+
+        rates[i] = (checked - monitor->last_checked[i]) / elapsed;
+        active[i] = next < end || queue_left;
+        if (active[i]) {
+            sorted[num_active++] = rates[i];
+        }
+
+        // Estático: o fim da busca é o do worker mais atrasado
+        if (!shared->dynamic && next < end) {
+            double speed = (double)(next - monitor->last_next[i]) / elapsed;
+            double left = speed > 0 ? (double)(end - next) / speed : INFINITY;
+            eta = left > eta ? left : eta;
+        }
+
+        monitor->last_checked[i] = checked;
+        monitor->last_next[i] = next;
+        checked_total += checked;
+        rate_total += rates[i];
+    }
+
+    KeyspaceIndex covered = covered_indices(monitor);
+    if (shared->dynamic) {
+        double speed = (double)(covered - monitor->last_covered) / elapsed;
+        eta = covered >= monitor->total ? 0 :
+              speed > 0 ? (double)(monitor->total - covered) / speed : INFINITY;
+    }
+    monitor->last_covered = covered;
+    monitor->last = now;
+
+    qsort(sorted, num_active, sizeof(double), compare_doubles);
+    double median = num_active == 0 ? 0 : num_active % 2 ? sorted[num_active / 2] :
+                    (sorted[num_active / 2 - 1] + sorted[num_active / 2]) / 2;
+
+    fputs("[Status ", out);
+    format_duration(out, now - monitor->start);
+    fprintf(out, "] %.1f%% coberto, %lld senhas, %.2f M senhas/s, fim em ",
+            monitor->total > 0 ? 100.0 * (double)covered / (double)monitor->total : 100.0,
+            checked_total,
+            rate_total / 1e6);
+    format_duration(out, eta);
+    fputc('\n', out);
+
+    int stragglers = 0;
+    fputs("  Por worker (M/s):", out);
+    for (int i = 0; i < n; i++) {
+        int slow = active[i] && num_active > 1 && rates[i] < STRAGGLER_FRACTION * median;
+        stragglers += slow;
+        fprintf(out, "%s %d=%.2f%s", i > 0 && i % 8 == 0 ? "\n                   " : "",
+                i, rates[i] / 1e6, slow ? "*" : "");
+    }
+    fputc('\n', out);
+    if (stragglers > 0) {
+        fprintf(out, "  * %d worker(s) lento(s): abaixo de %.0f%% da mediana (%.2f M/s)\n",
+                stragglers, 100 * STRAGGLER_FRACTION, median / 1e6);
+    }
+
+    fclose(out);
+    fputs(buffer, stdout);
+    fflush(stdout);
+    free(buffer);
+    free(rates);
+    free(active);
+}
+
+static void *telemetry_main(void *arg) {
+    TelemetryMonitor *monitor = arg;
+
+    pthread_mutex_lock(&monitor->lock);
+    while (!monitor->stop) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += monitor->interval;
+        while (!monitor->stop &&
+               pthread_cond_timedwait(&monitor->wake, &monitor->lock, &deadline) != ETIMEDOUT) {
+        }
+        if (monitor->stop) {
+            break;
+        }
+
+        pthread_mutex_unlock(&monitor->lock);
+        telemetry_report(monitor);
+        pthread_mutex_lock(&monitor->lock);
+    }
+    pthread_mutex_unlock(&monitor->lock);
+    return NULL;
+}
+
+int telemetry_start(TelemetryMonitor *monitor, SharedState *shared, KeyspaceIndex total,
+                    int interval) {
+    WorkerProgress *progress = shared_state_progress(shared);
+    int n = shared->num_workers;
+
+    if (progress == NULL) {
+        return -1;
+    }
+    monitor->last_checked = calloc(n, sizeof(long long));
+    monitor->last_next = calloc(n, sizeof(KeyspaceIndex));
+    if (monitor->last_checked == NULL || monitor->last_next == NULL) {
+        perror("calloc");
+        free(monitor->last_checked);
+        free(monitor->last_next);
+        return -1;
+    }
+
+    monitor->stop = 0;
+    monitor->interval = interval;
+    monitor->shared = shared;
+    monitor->total = total;
+    monitor->start = monitor->last = monotonic_seconds();
+    for (int i = 0; i < n; i++) {
+        KeyspaceIndex start, end;
+        monitor->last_checked[i] = atomic_load(&progress[i].checked);
+        worker_progress_read(&progress[i], &start, &end, &monitor->last_next[i]);
+    }
+    monitor->last_covered = covered_indices(monitor);
+    pthread_mutex_init(&monitor->lock, NULL);
+    pthread_cond_init(&monitor->wake, NULL);
+
+    if (pthread_create(&monitor->thread, NULL, telemetry_main, monitor) != 0) {
+        perror("pthread_create");
+        pthread_cond_destroy(&monitor->wake);
+        pthread_mutex_destroy(&monitor->lock);
+        free(monitor->last_checked);
+        free(monitor->last_next);
+        return -1;
+    }
+    return 0;
+}
+
+void telemetry_stop(TelemetryMonitor *monitor) {
+    pthread_mutex_lock(&monitor->lock);
+    monitor->stop = 1;
+    pthread_cond_signal(&monitor->wake);
+    pthread_mutex_unlock(&monitor->lock);
+    pthread_join(monitor->thread, NULL);
+    pthread_cond_destroy(&monitor->wake);
+    pthread_mutex_destroy(&monitor->lock);
+    free(monitor->last_checked);
+    free(monitor->last_next);
+}
@@ -0,0 +1,54 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <pthread.h>
+#include "shared_state.h"
+
+/**
+ * Telemetria ao vivo do coordinator (--status)
+ *
+ * Cada worker já publica na sua linha de cache da página compartilhada quantas
+ * senhas testou e até onde foi no intervalo atual (WorkerProgress, uma store
+ * relaxed por lote). Uma thread do coordinator lê esses contadores a cada
+ * intervalo e imprime a taxa total e a de cada worker, a fração do espaço de
+ * busca coberta, o tempo estimado até o fim e os workers lentos. O laço
+ * quente não lê nada novo nem escreve fora da própria linha.
+ */
+
+#define TELEMETRY_INTERVAL 5        // Segundos entre relatórios (padrão de --status)
+#define STRAGGLER_FRACTION 0.5      // Lento: abaixo desta fração da taxa mediana
+
+/**
+ * Thread de relatórios e as leituras anteriores de cada worker
+ */
+typedef struct {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    int stop;
+    int interval;
+    SharedState *shared;
+    KeyspaceIndex total;        // Espaço de busca real (shared->total é o da fila)
+    double start;               // Início da busca (relógio monotônico)
+    double last;                // Último relatório
+    long long *last_checked;    // Senhas de cada worker no último relatório
+    KeyspaceIndex *last_next;   // Posição de cada worker no último relatório
+    KeyspaceIndex last_covered;
+} TelemetryMonitor;
+
+/**
+ * Inicia a thread que imprime o estado da busca a cada interval segundos
+ * Depende dos slots de progresso da página (shared->progress_offset).
+ *
+ * @param total Espaço de busca completo, em índices (bytes com --wordlist)
+ * @return 0 em caso de sucesso, -1 se a thread não pôde ser criada
+ */
+int telemetry_start(TelemetryMonitor *monitor, SharedState *shared, KeyspaceIndex total,
+                    int interval);
+
+/**
+ * Para a thread de relatórios
+ */
+void telemetry_stop(TelemetryMonitor *monitor);
+
+#endif // TELEMETRY_H
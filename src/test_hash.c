@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <string.h>
+#include <stdint.h>
 #include "hash_utils.h"
 
 /**
@@ -15,6 +16,443 @@ typedef struct {
     const char *expected_hash;
 } TestCase;
 
+/**
+ * Verifica cada lane de md5_batch_isa() contra o caminho escalar
+ * Usa entradas de 0 a 55 bytes e uma quantidade de blocos que não é múltipla
+ * de nenhuma largura, para exercitar também o resto escalar.
+ *
+ * @return Número de conjuntos de instruções que falharam
+ */
+int test_batch_lanes(int *tested) {
+    enum { NUM_BLOCKS = 3 * MD5_BATCH_MAX + 5 };
+    char inputs[NUM_BLOCKS][MD5_BLOCK_MAX_INPUT + 1];
+    MD5Block blocks[NUM_BLOCKS];
+    uint32_t states[NUM_BLOCKS][4];
+    uint32_t seed = 12345;
+    int failed_isas = 0;
+    
+    for (int i = 0; i < NUM_BLOCKS; i++) {
+        int len = i % (MD5_BLOCK_MAX_INPUT + 1);
+        for (int j = 0; j < len; j++) {
+            seed = seed * 1103515245 + 12345;
+            inputs[i][j] = (char)(' ' + (seed >> 16) % 95);
+        }
+        inputs[i][len] = '\0';
+        md5_block_init(&blocks[i], inputs[i], len);
+    }
+    
+    *tested = 0;
+    for (int isa = MD5_ISA_SCALAR; isa < MD5_ISA_COUNT; isa++) {
+        if (!md5_isa_supported(isa)) {
+            printf("  %-7s: não suportado pela CPU - ignorado\n", md5_isa_name(isa));
+            continue;
+        }
+        
+        memset(states, 0, sizeof(states));
+        md5_batch_isa(isa, blocks, NUM_BLOCKS, states);
+        
+        int bad_lanes = 0;
+        for (int i = 0; i < NUM_BLOCKS; i++) {
+            uint32_t reference[4];
+            char expected[33], obtained[33];
+            md5_block_hash(&blocks[i], reference);
+            md5_string(inputs[i], expected);
+            md5_state_to_hex(states[i], obtained);
+            if (!md5_state_equal(states[i], reference) || strcmp(obtained, expected) != 0) {
+                printf("  %-7s: lane %d (bloco %d, %zu bytes) divergiu: %s != %s\n",
+                       md5_isa_name(isa), i % md5_isa_lanes(isa), i,
+                       strlen(inputs[i]), obtained, expected);
+                bad_lanes++;
+            }
+        }
+        
+        printf("  %-7s (%2d lanes): %d blocos - %s\n", md5_isa_name(isa),
+               md5_isa_lanes(isa), NUM_BLOCKS, bad_lanes == 0 ? "✓ PASSOU" : "✗ FALHOU");
+        (*tested)++;
+        if (bad_lanes > 0) {
+            failed_isas++;
+        }
+    }
+    
+    return failed_isas;
+}
+
+/**
+ * Verifica os núcleos especializados por comprimento (md5_scan_kernel)
+ * Para cada comprimento de 1 a 55, planta o alvo em uma posição que varia e
+ * confere o índice devolvido; a mesma busca sem o valor certo deve dar -1.
+ * São 37 valores, que não é múltiplo de nenhuma largura de vetor.
+ *
+ * @return Número de conjuntos de instruções que falharam
+ */
+int test_scan_kernels(int *tested) {
+    enum { NUM_VALUES = 37 };
+    uint8_t values[NUM_VALUES];
+    uint32_t seed = 54321;
+    uint32_t iv[4];
+    int failed_isas = 0;
+    
+    md5_midstate(NULL, 0, iv);
+    for (int i = 0; i < NUM_VALUES; i++) {
+        values[i] = (uint8_t)('0' + i);
+    }
+    
+    *tested = 0;
+    for (int isa = MD5_ISA_SCALAR; isa < MD5_ISA_COUNT; isa++) {
+        if (!md5_isa_supported(isa)) {
+            continue;
+        }
+        
+        int bad_lengths = 0;
+        for (int len = 1; len <= MD5_BLOCK_MAX_INPUT; len++) {
+            char input[MD5_BLOCK_MAX_INPUT + 1];
+            MD5Block block;
+            uint32_t target[4];
+            int hit = (len * 7) % NUM_VALUES;
+            
+            for (int j = 0; j < len; j++) {
+                seed = seed * 1103515245 + 12345;
+                input[j] = (char)(' ' + (seed >> 16) % 95);
+            }
+            input[len - 1] = (char)values[hit];
+            input[len] = '\0';
+            md5_block_init(&block, input, len);
+            md5_block_hash(&block, target);
+            
+            // O núcleo deve ignorar o último byte do bloco
+            md5_block_set_byte(&block, len - 1, 0);
+            MD5ScanFn scan = md5_scan_kernel(isa, len);
+            int found = scan(iv, &block, values, NUM_VALUES, target);
+            int missed = scan(iv, &block, values, hit, target);
+            if (found != hit || missed != -1) {
+                printf("  %-7s: %d bytes - índice %d (esperado %d), sem o alvo %d\n",
+                       md5_isa_name(isa), len, found, hit, missed);
+                bad_lengths++;
+            }
+        }
+        
+        printf("  %-7s: comprimentos 1 a %d - %s\n", md5_isa_name(isa),
+               MD5_BLOCK_MAX_INPUT, bad_lengths == 0 ? "✓ PASSOU" : "✗ FALHOU");
+        (*tested)++;
+        if (bad_lengths > 0) {
+            failed_isas++;
+        }
+    }
+    
+    return failed_isas;
+}
+
+/**
+ * Verifica o midstate (--prefix/--suffix): prefixo de 70 bytes, cujo primeiro
+ * bloco é comprimido uma vez, senha e sufixo no último bloco, com o comprimento
+ * da mensagem inteira. md5_batch_from() e os núcleos de cada conjunto de
+ * instruções devem coincidir com o MD5 da mensagem completa.
+ *
+ * @return Número de verificações que falharam
+ */
+int test_midstate(int *tested) {
+    enum { NUM_VALUES = 37, PREFIX_LEN = 70, SUFFIX_LEN = 3 };
+    const char *suffix = "#x!";
+    char prefix[PREFIX_LEN];
+    uint8_t values[NUM_VALUES];
+    uint32_t init[4];
+    int failed = 0;
+    
+    for (int i = 0; i < PREFIX_LEN; i++) {
+        prefix[i] = (char)('a' + i % 26);
+    }
+    for (int i = 0; i < NUM_VALUES; i++) {
+        values[i] = (uint8_t)('0' + i);
+    }
+    md5_midstate(prefix, PREFIX_LEN / MD5_BLOCK_SIZE, init);
+    int offset = PREFIX_LEN % MD5_BLOCK_SIZE;
+    int max_len = MD5_BLOCK_MAX_INPUT - offset - SUFFIX_LEN;
+    
+    // Um bloco por tamanho de senha, em lote
+    MD5Block blocks[MD5_BLOCK_MAX_INPUT];
+    uint32_t states[MD5_BLOCK_MAX_INPUT][4];
+    char messages[MD5_BLOCK_MAX_INPUT][PREFIX_LEN + MD5_BLOCK_MAX_INPUT];
+    size_t sizes[MD5_BLOCK_MAX_INPUT];
+    for (int len = 1; len <= max_len; len++) {
+        char *message = messages[len - 1];
+        memcpy(message, prefix, PREFIX_LEN);
+        for (int j = 0; j < len; j++) {
+            message[PREFIX_LEN + j] = (char)values[(len + j) % NUM_VALUES];
+        }
+        memcpy(message + PREFIX_LEN + len, suffix, SUFFIX_LEN);
+        sizes[len - 1] = PREFIX_LEN + len + SUFFIX_LEN;
+        
+        MD5Block *block = &blocks[len - 1];
+        md5_block_init(block, message + PREFIX_LEN - offset, offset + len + SUFFIX_LEN);
+        block->x[14] = (uint32_t)(sizes[len - 1] << 3);
+        block->x[15] = 0;
+    }
+    md5_batch_from(init, blocks, max_len, states);
+    int bad = 0;
+    for (int i = 0; i < max_len; i++) {
+        uint32_t reference[4];
+        md5_bytes(messages[i], sizes[i], reference);
+        bad += !md5_state_equal(states[i], reference);
+    }
+    printf("  lote   : senhas de 1 a %d bytes - %s\n", max_len, bad == 0 ? "✓ PASSOU" : "✗ FALHOU");
+    *tested = 1;
+    failed += bad > 0;
+    
+    // Núcleos: o último byte da senha varia; o sufixo vem depois dele
+    for (int isa = MD5_ISA_SCALAR; isa < MD5_ISA_COUNT; isa++) {
+        if (!md5_isa_supported(isa)) {
+            continue;
+        }
+        int bad_lengths = 0;
+        for (int len = 1; len <= max_len; len++) {
+            MD5Block block = blocks[len - 1];
+            uint32_t target[4];
+            int last = offset + len - 1;
+            int hit = md5_block_get_byte(&block, last) - '0';
+            
+            md5_bytes(messages[len - 1], sizes[len - 1], target);
+            md5_block_set_byte(&block, last, 0);
+            MD5ScanFn scan = md5_scan_kernel(isa, last + 1);
+            if (scan(init, &block, values, NUM_VALUES, target) != hit ||
+                scan(init, &block, values, hit, target) != -1) {
+                bad_lengths++;
+            }
+        }
+        printf("  %-7s: senhas de 1 a %d bytes - %s\n", md5_isa_name(isa), max_len,
+               bad_lengths == 0 ? "✓ PASSOU" : "✗ FALHOU");
+        (*tested)++;
+        failed += bad_lengths > 0;
+    }
+    
+    return failed;
+}
+
+/**
+ * Gerador dos testes diferenciais (LCG: cada semente repete a mesma sequência)
+ */
+static uint32_t next_random(uint32_t *seed) {
+    *seed = *seed * 1103515245 + 12345;
+    return *seed >> 16;
+}
+
+/**
+ * Verifica as fronteiras de bloco: 55 bytes é a maior entrada de um bloco só,
+ * com 56 o comprimento já vai para um segundo bloco, e 64 enche um bloco
+ * inteiro. Confere valores conhecidos (calculados fora, com o hashlib do
+ * Python), md5_bytes() contra md5_string() de 0 a 192 bytes aleatórios, e o
+ * midstate de um bloco mais o último bloco em lote (64 a 119 bytes) em cada
+ * conjunto de instruções.
+ *
+ * @return Número de verificações que falharam
+ */
+int test_boundaries(int *tested) {
+    enum { MAX_LEN = 3 * MD5_BLOCK_SIZE, NUM_TAILS = MD5_BLOCK_MAX_INPUT + 1 };
+    static const struct {
+        int len;
+        const char *hash;
+    } known[] = {
+        {55, "0d7ae056b2f015cd7dc67494efd658f1"},
+        {56, "31fcfb5165169eb55898e7e4cf34d19a"},
+        {63, "1b30c0670c15e7da3c2ba7bce77ebe99"},
+        {64, "a2eaf6295c32adc403865fd96a2f182b"},
+        {65, "eba2cce0ca8df47e62414a736b3105a2"},
+        {119, "b05187e08da41fa3ef16bd56afaafd99"},
+        {120, "62af9b597a9f55e16ab2b897387fc052"},
+        {128, "3e8c1ccbd71838ef3df4b72e57fb9bf6"},
+    };
+    char input[MAX_LEN + 1];
+    uint32_t seed = 2718;
+    int failed = 0;
+    
+    // Alfabeto repetido, truncado em cada comprimento
+    int bad = 0;
+    for (size_t k = 0; k < sizeof(known) / sizeof(known[0]); k++) {
+        uint32_t state[4], expected[4];
+        char hash[33];
+        for (int i = 0; i < known[k].len; i++) {
+            input[i] = (char)('a' + i % 26);
+        }
+        input[known[k].len] = '\0';
+        md5_string(input, hash);
+        md5_bytes(input, known[k].len, state);
+        md5_hex_to_state(known[k].hash, expected);
+        if (strcmp(hash, known[k].hash) != 0 || !md5_state_equal(state, expected)) {
+            printf("  %d bytes: %s (esperado %s)\n", known[k].len, hash, known[k].hash);
+            bad++;
+        }
+    }
+    printf("  conhecidos: 55 a 128 bytes - %s\n", bad == 0 ? "✓ PASSOU" : "✗ FALHOU");
+    *tested = 1;
+    failed += bad > 0;
+    
+    // Cada comprimento com bytes novos (sem '\0', por causa de md5_string)
+    bad = 0;
+    for (int len = 0; len <= MAX_LEN; len++) {
+        uint32_t state[4], expected[4];
+        char hash[33];
+        for (int i = 0; i < len; i++) {
+            input[i] = (char)(1 + next_random(&seed) % 255);
+        }
+        input[len] = '\0';
+        md5_string(input, hash);
+        md5_hex_to_state(hash, expected);
+        md5_bytes(input, len, state);
+        if (!md5_state_equal(state, expected)) {
+            printf("  md5_bytes: %d bytes divergiu\n", len);
+            bad++;
+        }
+    }
+    printf("  md5_bytes: 0 a %d bytes aleatórios - %s\n", MAX_LEN, bad == 0 ? "✓ PASSOU" : "✗ FALHOU");
+    (*tested)++;
+    failed += bad > 0;
+    
+    // Mensagens de 64 + tail bytes: o primeiro bloco vira midstate e o resto,
+    // com o comprimento da mensagem inteira, vai num lote de comprimentos mistos
+    MD5Block blocks[NUM_TAILS];
+    uint32_t expected[NUM_TAILS][4];
+    uint32_t init[4];
+    md5_midstate(input, 1, init);
+    for (int tail = 0; tail < NUM_TAILS; tail++) {
+        md5_bytes(input, MD5_BLOCK_SIZE + tail, expected[tail]);
+        md5_block_init(&blocks[tail], input + MD5_BLOCK_SIZE, tail);
+        blocks[tail].x[14] = (uint32_t)((MD5_BLOCK_SIZE + tail) << 3);
+    }
+    for (int isa = MD5_ISA_SCALAR; isa < MD5_ISA_COUNT; isa++) {
+        if (!md5_isa_supported(isa)) {
+            continue;
+        }
+        uint32_t states[NUM_TAILS][4];
+        memset(states, 0, sizeof(states));
+        md5_batch_from_isa(isa, init, blocks, NUM_TAILS, states);
+        bad = 0;
+        for (int tail = 0; tail < NUM_TAILS; tail++) {
+            if (!md5_state_equal(states[tail], expected[tail])) {
+                printf("  %-7s: midstate + %d bytes divergiu\n", md5_isa_name(isa), tail);
+                bad++;
+            }
+        }
+        printf("  %-7s: midstate, %d a %d bytes - %s\n", md5_isa_name(isa), MD5_BLOCK_SIZE,
+               MD5_BLOCK_SIZE + MD5_BLOCK_MAX_INPUT, bad == 0 ? "✓ PASSOU" : "✗ FALHOU");
+        (*tested)++;
+        failed += bad > 0;
+    }
+    
+    return failed;
+}
+
+/**
+ * Compara lotes e núcleos especializados com o caminho escalar em entradas
+ * aleatórias: a cada rodada, blocos e quantidades novos, partindo do vetor
+ * inicial ou de um midstate qualquer. Nos núcleos, o alvo aparece em uma
+ * posição sorteada, não aparece, ou é o hash certo com um bit trocado em uma
+ * das quatro palavras: a rejeição antecipada compara uma palavra só, e as
+ * outras três ainda precisam ser conferidas antes de aceitar.
+ *
+ * @return Número de conjuntos de instruções que falharam
+ */
+int test_random_kernels(int *tested) {
+    enum { ROUNDS = 16, MAX_BLOCKS = 3 * MD5_BATCH_MAX + 5, MAX_VALUES = 96 };
+    int failed_isas = 0;
+    
+    *tested = 0;
+    for (int isa = MD5_ISA_SCALAR; isa < MD5_ISA_COUNT; isa++) {
+        if (!md5_isa_supported(isa)) {
+            continue;
+        }
+        
+        uint32_t seed = 31337;
+        int bad_batches = 0, bad_scans = 0;
+        for (int round = 0; round < ROUNDS; round++) {
+            // Midstate: um bloco de 64 bytes aleatórios nas rodadas ímpares
+            uint8_t prefix[MD5_BLOCK_SIZE];
+            for (int i = 0; i < MD5_BLOCK_SIZE; i++) {
+                prefix[i] = (uint8_t)next_random(&seed);
+            }
+            int prefixed = round % 2;
+            uint32_t init[4];
+            md5_midstate(prefix, prefixed, init);
+            
+            // Lote de tamanho e comprimentos sorteados
+            MD5Block blocks[MAX_BLOCKS];
+            uint32_t states[MAX_BLOCKS][4];
+            int n = 1 + (int)(next_random(&seed) % MAX_BLOCKS);
+            for (int i = 0; i < n; i++) {
+                char input[MD5_BLOCK_MAX_INPUT];
+                int len = (int)(next_random(&seed) % (MD5_BLOCK_MAX_INPUT + 1));
+                for (int j = 0; j < len; j++) {
+                    input[j] = (char)next_random(&seed);
+                }
+                md5_block_init(&blocks[i], input, len);
+                blocks[i].x[14] = (uint32_t)((prefixed * MD5_BLOCK_SIZE + len) << 3);
+            }
+            md5_batch_from_isa(isa, init, blocks, n, states);
+            for (int i = 0; i < n; i++) {
+                uint32_t reference[4] = {init[0], init[1], init[2], init[3]};
+                md5_block_compress(reference, &blocks[i]);
+                if (!md5_state_equal(states[i], reference)) {
+                    printf("  %-7s: rodada %d, lane %d de %d blocos divergiu\n",
+                           md5_isa_name(isa), round, i % md5_isa_lanes(isa), n);
+                    bad_batches++;
+                }
+            }
+            
+            // Núcleos: valores distintos sorteados (embaralhamento de 0 a 255)
+            uint8_t values[256];
+            for (int i = 0; i < 256; i++) {
+                values[i] = (uint8_t)i;
+            }
+            for (int i = 255; i > 0; i--) {
+                int j = (int)(next_random(&seed) % (i + 1));
+                uint8_t swap = values[i];
+                values[i] = values[j];
+                values[j] = swap;
+            }
+            for (int len = 1; len <= MD5_BLOCK_MAX_INPUT; len++) {
+                char input[MD5_BLOCK_MAX_INPUT];
+                MD5Block block;
+                for (int j = 0; j < len; j++) {
+                    input[j] = (char)next_random(&seed);
+                }
+                md5_block_init(&block, input, len);
+                block.x[14] = (uint32_t)((prefixed * MD5_BLOCK_SIZE + len) << 3);
+                
+                int count = 1 + (int)(next_random(&seed) % MAX_VALUES);
+                int hit = (int)(next_random(&seed) % count);
+                uint32_t target[4], absent[4];
+                for (int k = 0; k < 4; k++) {
+                    target[k] = absent[k] = init[k];
+                }
+                md5_block_set_byte(&block, len - 1, values[hit]);
+                md5_block_compress(target, &block);
+                md5_block_set_byte(&block, len - 1, values[count]);  // Fora da varredura
+                md5_block_compress(absent, &block);
+                uint32_t near[4] = {target[0], target[1], target[2], target[3]};
+                near[round % 4] ^= 1u << (next_random(&seed) % 32);
+                
+                MD5ScanFn scan = md5_scan_kernel(isa, len);
+                int found = scan(init, &block, values, count, target);
+                int missed = scan(init, &block, values, count, absent);
+                int rejected = scan(init, &block, values, count, near);
+                if (found != hit || missed != -1 || rejected != -1) {
+                    printf("  %-7s: rodada %d, %d bytes, %d valores - índice %d (esperado %d), "
+                           "ausente %d, um bit trocado na palavra %d: %d\n", md5_isa_name(isa),
+                           round, len, count, found, hit, missed, round % 4, rejected);
+                    bad_scans++;
+                }
+            }
+        }
+        
+        printf("  %-7s: %d rodadas de lotes e núcleos - %s\n", md5_isa_name(isa), ROUNDS,
+               bad_batches + bad_scans == 0 ? "✓ PASSOU" : "✗ FALHOU");
+        (*tested)++;
+        if (bad_batches + bad_scans > 0) {
+            failed_isas++;
+        }
+    }
+    
+    return failed_isas;
+}
+
 int main(int argc, char *argv[]) {
     // Se argumentos fornecidos, calcula hash da string
     if (argc > 1) {
@@ -56,7 +494,23 @@ int main(int argc, char *argv[]) {
         printf("  Esperado: %s\n", tests[i].expected_hash);
         printf("  Obtido:   %s\n", hash);
         
-        if (strcmp(hash, tests[i].expected_hash) == 0) {
+        // Caminho rápido de bloco único (entradas de até 55 bytes)
+        int fast_ok = 1;
+        size_t input_len = strlen(tests[i].input);
+        if (input_len <= MD5_BLOCK_MAX_INPUT) {
+            MD5Block block;
+            uint32_t state[4], expected_state[4];
+            char fast_hash[33];
+            md5_block_init(&block, tests[i].input, input_len);
+            md5_block_hash(&block, state);
+            md5_state_to_hex(state, fast_hash);
+            fast_ok = strcmp(fast_hash, tests[i].expected_hash) == 0 &&
+                      md5_hex_to_state(tests[i].expected_hash, expected_state) == 0 &&
+                      md5_state_equal(state, expected_state);
+            printf("  Bloco:    %s\n", fast_hash);
+        }
+        
+        if (strcmp(hash, tests[i].expected_hash) == 0 && fast_ok) {
             printf("  Status:   ✓ PASSOU\n");
             passed++;
         } else {
@@ -66,6 +520,48 @@ int main(int argc, char *argv[]) {
         printf("\n");
     }
     
+    // Cada lane de cada conjunto de instruções contra o caminho escalar
+    printf("=== Teste do MD5 em Lote (SIMD) ===\n");
+    printf("Melhor conjunto detectado: %s\n", md5_isa_name(md5_isa_best()));
+    int batch_tested;
+    int batch_failed = test_batch_lanes(&batch_tested);
+    num_tests += batch_tested;
+    passed += batch_tested - batch_failed;
+    failed += batch_failed;
+    printf("\n");
+    
+    printf("=== Teste dos Núcleos Especializados por Comprimento ===\n");
+    int scan_tested;
+    int scan_failed = test_scan_kernels(&scan_tested);
+    num_tests += scan_tested;
+    passed += scan_tested - scan_failed;
+    failed += scan_failed;
+    printf("\n");
+    
+    printf("=== Teste do Midstate (Prefixo e Sufixo) ===\n");
+    int midstate_tested;
+    int midstate_failed = test_midstate(&midstate_tested);
+    num_tests += midstate_tested;
+    passed += midstate_tested - midstate_failed;
+    failed += midstate_failed;
+    printf("\n");
+    
+    printf("=== Teste das Fronteiras de Bloco (55, 56 e 64 bytes) ===\n");
+    int boundary_tested;
+    int boundary_failed = test_boundaries(&boundary_tested);
+    num_tests += boundary_tested;
+    passed += boundary_tested - boundary_failed;
+    failed += boundary_failed;
+    printf("\n");
+    
+    printf("=== Teste Diferencial dos Núcleos (Entradas Aleatórias) ===\n");
+    int random_tested;
+    int random_failed = test_random_kernels(&random_tested);
+    num_tests += random_tested;
+    passed += random_tested - random_failed;
+    failed += random_failed;
+    printf("\n");
+    
     printf("=== Resumo dos Testes ===\n");
     printf("Total:   %d\n", num_tests);
     printf("Passou:  %d\n", passed);
@@ -0,0 +1,501 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include "hash_utils.h"
+#include "keyspace.h"
+#include "enumerator.h"
+#include "search.h"
+#include "shared_state.h"
+
+/**
+ * Testes de cobertura do espaço de busca (make check)
+ *
+ * test_hash confere os núcleos MD5 isolados; aqui entram os caminhos que
+ * decidem quais candidatos eles recebem:
+ *   - divisão estática (keyspace_partition) e fila dinâmica
+ *     (shared_state_claim), com e sem intervalos de --resume e em espaços
+ *     acima de 2^62: cada índice deve sair exatamente uma vez
+ *   - enumerador contra keyspace_index_to_password, índice a índice, em
+ *     trechos que começam e terminam em qualquer lugar (ordem lexicográfica,
+ *     máscara, prefixo e sufixo, ordem Markov)
+ *   - search_range e search_dynamic com o alvo plantado no primeiro e no
+ *     último índice de um trecho e de uma linha do último caractere, pelo
+ *     núcleo especializado e pelo lote genérico
+ *
+ * Uso: ./test_search
+ */
+
+#define QUEUE_HEAD_CLAIMS 1000  // Blocos conferidos no começo e no fim de cada intervalo
+#define QUEUE_THREADS 4
+#define QUEUE_THREAD_TOTAL 2000003
+
+static uint32_t next_random(uint32_t *seed) {
+    *seed = *seed * 1103515245 + 12345;
+    return *seed >> 16;
+}
+
+// ---------------------------------------------------------------------------
+// Divisão estática
+
+/**
+ * Para cada total e número de partes: as partes são contíguas, começam em 0,
+ * terminam em total e diferem no máximo em 1 índice
+ *
+ * @return Número de combinações que falharam
+ */
+static int test_static_partition(void) {
+    const KeyspaceIndex totals[] = {
+        0, 1, 2, 7, 1000, 1001, 65537, ((KeyspaceIndex)1 << 64) + 3, KEYSPACE_INDEX_MAX
+    };
+    int bad = 0;
+
+    for (size_t t = 0; t < sizeof(totals) / sizeof(totals[0]); t++) {
+        for (int parts = 1; parts <= 33; parts++) {
+            KeyspaceIndex next = 0, smallest = KEYSPACE_INDEX_MAX, largest = 0;
+            int ok = 1;
+            for (int part = 0; part < parts; part++) {
+                KeyspaceIndex count;
+                KeyspaceIndex start = keyspace_partition(totals[t], parts, part, &count);
+                ok &= start == next && count >= 0;
+                next = start + count;
+                smallest = count < smallest ? count : smallest;
+                largest = count > largest ? count : largest;
+            }
+            if (!ok || next != totals[t] || largest - smallest > 1) {
+                char total_str[KEYSPACE_INDEX_STR];
+                printf("  total %s em %d partes: fatias não contíguas ou desiguais\n",
+                       keyspace_index_str(totals[t], total_str), parts);
+                bad++;
+            }
+        }
+    }
+    printf("  estática: 9 totais (até 2^127 - 1) em 1 a 33 partes - %s\n",
+           bad == 0 ? "✓ PASSOU" : "✗ FALHOU");
+    return bad > 0;
+}
+
+// ---------------------------------------------------------------------------
+// Fila dinâmica
+
+/**
+ * Página de teste com espaço para intervalos de --resume logo depois do
+ * SharedState, como o coordinator monta na região extra
+ */
+static SharedState *queue_create(const IndexRange *ranges, int num_ranges, int num_workers) {
+    size_t header = (sizeof(SharedState) + CACHE_LINE_SIZE - 1) & ~(size_t)(CACHE_LINE_SIZE - 1);
+    size_t size = header + (size_t)num_ranges * sizeof(IndexRange);
+    SharedState *state = aligned_alloc(CACHE_LINE_SIZE, (size + CACHE_LINE_SIZE - 1) &
+                                                        ~(size_t)(CACHE_LINE_SIZE - 1));
+    if (state == NULL) {
+        perror("aligned_alloc");
+        exit(1);
+    }
+    shared_state_init(state);
+    state->dynamic = 1;
+    state->num_workers = num_workers;
+
+    if (num_ranges > 0) {
+        state->ranges_offset = header;
+        state->num_ranges = num_ranges;
+        memcpy((char *)state + header, ranges, num_ranges * sizeof(IndexRange));
+    }
+    return state;
+}
+
+/**
+ * Esvazia a fila numa thread só: os blocos saem na ordem da fila, então
+ * cada um deve começar onde o anterior terminou (ou no início do próximo
+ * intervalo) sem atravessar o fim do seu intervalo, e a fila só acaba
+ * depois do último índice. Vale para qualquer tamanho, sem bitmap: depois
+ * de QUEUE_HEAD_CLAIMS blocos num intervalo, a fila salta para perto do fim
+ * dele, como se outros workers tivessem levado o meio.
+ *
+ * @param want_max Maior tamanho pedido (sorteado de 1 até ele)
+ * @return 1 se a sequência de blocos está correta, 0 caso contrário
+ */
+static int drain_in_order(SharedState *state, const IndexRange *ranges, int num_ranges,
+                          long long want_max, uint32_t *seed) {
+    IndexRange whole = {0, state->total, 0};
+    const IndexRange *queued = shared_state_ranges(state) != NULL ? shared_state_ranges(state) :
+                                                                     &whole;
+    int range = 0;
+    KeyspaceIndex cursor = ranges[0].start;
+    long long claims = 0;
+
+    for (;;) {
+        long long want = 1 + (long long)(((uint64_t)next_random(seed) << 32 |
+                                          (uint64_t)next_random(seed) << 16 |
+                                          next_random(seed)) % want_max);
+        KeyspaceIndex count;
+        KeyspaceIndex start = shared_state_claim(state, want, &count);
+        if (start < 0) {
+            return range == num_ranges;
+        }
+        if (range == num_ranges || start != cursor || count <= 0 ||
+            count > ranges[range].start + ranges[range].count - cursor) {
+            return 0;
+        }
+        cursor += count;
+        if (cursor == ranges[range].start + ranges[range].count) {
+            claims = 0;
+            if (++range < num_ranges) {
+                cursor = ranges[range].start;
+            }
+        } else if (++claims == QUEUE_HEAD_CLAIMS) {
+            long long end = range + 1 < num_ranges ? queued[range + 1].offset : state->queue_size;
+            long long skip_to = end - QUEUE_HEAD_CLAIMS;
+            if (skip_to > atomic_load(&state->next_index)) {
+                atomic_store(&state->next_index, skip_to);
+                cursor = queued[range].start +
+                         ((KeyspaceIndex)(skip_to - queued[range].offset) << state->queue_shift);
+            }
+        } else if (claims > 2 * QUEUE_HEAD_CLAIMS) {
+            return 0;  // O fim do intervalo não chega
+        }
+    }
+}
+
+typedef struct {
+    SharedState *state;
+    _Atomic unsigned char *seen;
+    uint32_t seed;
+} QueueThread;
+
+static void *queue_thread(void *arg) {
+    QueueThread *t = arg;
+    KeyspaceIndex count;
+    KeyspaceIndex start;
+    while ((start = shared_state_claim(t->state, 1 + next_random(&t->seed) % 20000, &count)) >= 0) {
+        for (KeyspaceIndex i = start; i < start + count; i++) {
+            atomic_fetch_add_explicit(&t->seen[i], 1, memory_order_relaxed);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @return Número de cenários que falharam
+ */
+static int test_dynamic_queue(void) {
+    const KeyspaceIndex big = ((KeyspaceIndex)1 << 100) + 12345;
+    const KeyspaceIndex totals[] = {1, 1023, 1024, 1025, 100003, big};
+    // Intervalos de um --resume: buracos entre eles, um de um índice só, e
+    // intervalos grandes o bastante para a fila usar queue_shift
+    const IndexRange resume[] = {{5, 95, 0}, {300, 2000, 0}, {5000, 1, 0}, {9000, 11000, 0}};
+    const IndexRange resume_big[] = {
+        {7, (KeyspaceIndex)1 << 99, 0},
+        {(KeyspaceIndex)1 << 100, ((KeyspaceIndex)1 << 99) + 7, 0},
+    };
+    uint32_t seed = 4242;
+    int bad = 0;
+
+    for (size_t t = 0; t < sizeof(totals) / sizeof(totals[0]); t++) {
+        for (int workers = 1; workers <= 8; workers *= 2) {
+            IndexRange whole = {0, totals[t], 0};
+            SharedState *state = queue_create(NULL, 0, workers);
+            shared_state_set_queue(state, totals[t]);
+            if (!drain_in_order(state, &whole, 1, totals[t] == big ? CHUNK_MAX : 5000, &seed)) {
+                char total_str[KEYSPACE_INDEX_STR];
+                printf("  fila de %s índices, %d workers: blocos fora de ordem ou faltando\n",
+                       keyspace_index_str(totals[t], total_str), workers);
+                bad++;
+            }
+            free(state);
+        }
+    }
+
+    int num_resume = sizeof(resume) / sizeof(resume[0]);
+    int num_big = sizeof(resume_big) / sizeof(resume_big[0]);
+    for (int workers = 1; workers <= 8; workers *= 2) {
+        SharedState *state = queue_create(resume, num_resume, workers);
+        shared_state_set_queue(state, 95 + 2000 + 1 + 11000);
+        bad += !drain_in_order(state, resume, num_resume, 3000, &seed);
+        free(state);
+
+        state = queue_create(resume_big, num_big, workers);
+        shared_state_set_queue(state, resume_big[0].count + resume_big[1].count);
+        bad += !drain_in_order(state, resume_big, num_big, CHUNK_MAX, &seed);
+        free(state);
+    }
+    printf("  fila: 6 totais (até 2^100) e 2 conjuntos de intervalos, 1 a 8 workers - %s\n",
+           bad == 0 ? "✓ PASSOU" : "✗ FALHOU");
+
+    // Várias threads disputando a mesma fila: nenhum índice repetido ou perdido
+    SharedState *state = queue_create(NULL, 0, QUEUE_THREADS);
+    shared_state_set_queue(state, QUEUE_THREAD_TOTAL);
+    _Atomic unsigned char *seen = calloc(QUEUE_THREAD_TOTAL, sizeof(*seen));
+    QueueThread threads[QUEUE_THREADS];
+    pthread_t ids[QUEUE_THREADS];
+    for (int i = 0; i < QUEUE_THREADS; i++) {
+        threads[i] = (QueueThread){state, seen, 1000u + i};
+        pthread_create(&ids[i], NULL, queue_thread, &threads[i]);
+    }
+    for (int i = 0; i < QUEUE_THREADS; i++) {
+        pthread_join(ids[i], NULL);
+    }
+    int bad_threads = 0;
+    for (long long i = 0; i < QUEUE_THREAD_TOTAL; i++) {
+        bad_threads += seen[i] != 1;
+    }
+    printf("  fila: %d threads, %d índices - %s\n", QUEUE_THREADS, QUEUE_THREAD_TOTAL,
+           bad_threads == 0 ? "✓ PASSOU" : "✗ FALHOU");
+    free(seen);
+    free(state);
+    return (bad > 0) + (bad_threads > 0);
+}
+
+// ---------------------------------------------------------------------------
+// Espaços de busca dos testes de enumeração e de busca
+
+#define NUM_SPACES 5
+
+/**
+ * Monta o i-ésimo espaço de teste e devolve o seu nome
+ */
+static const char *test_space(Keyspace *ks, int i) {
+    static const char *const custom[MASK_CUSTOM_SETS] = {"xyz", NULL, NULL, NULL};
+    char prefix[71];
+
+    switch (i) {
+        case 0:
+            keyspace_init_charset(ks, "abcdefghijklmnopqrstuvwxyz0123456789", 3);
+            return "charset 36, 3 posições";
+        case 1:
+            keyspace_init_charset(ks, "abc", 7);
+            return "charset 3, 7 posições";
+        case 2:
+            keyspace_init_mask(ks, "?d?1-?u", custom);
+            return "máscara ?d?1-?u";
+        case 3:
+            // 70 bytes de prefixo: um bloco vira midstate, 6 ficam no último bloco
+            for (int j = 0; j < 70; j++) {
+                prefix[j] = (char)('A' + j % 26);
+            }
+            prefix[70] = '\0';
+            keyspace_init_charset(ks, "0123456789abcdef", 3);
+            keyspace_set_affixes(ks, prefix, "!x");
+            return "prefixo de 70 bytes e sufixo";
+        default:
+            // Ordem Markov com níveis de tamanhos diferentes em cada posição
+            keyspace_init_charset(ks, "abcdefghijkl", 4);
+            for (int pos = 0; pos < ks->length; pos++) {
+                for (int l = 0; l < KEYSPACE_LEVELS; l++) {
+                    int end = (l + 1) * (pos + 2);
+                    ks->order.level_end[pos][l] = (short)(end < 12 ? end : 12);
+                }
+            }
+            keyspace_order_prepare(ks);
+            return "ordem Markov, 12 x 4";
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Enumerador
+
+/**
+ * Percorre o espaço inteiro em trechos de tamanho sorteado e compara cada
+ * bloco do enumerador com o bloco montado a partir de
+ * keyspace_index_to_password; a volta por keyspace_password_to_index deve
+ * dar o mesmo índice (bijeção)
+ *
+ * @return Número de espaços que falharam
+ */
+static int test_enumerator(void) {
+    uint32_t seed = 777;
+    int failed = 0;
+
+    for (int s = 0; s < NUM_SPACES; s++) {
+        Keyspace ks;
+        const char *name = test_space(&ks, s);
+        KeyspaceIndex size = keyspace_size(&ks);
+        long long mismatches = 0, visited = 0;
+
+        for (KeyspaceIndex start = 0; start < size; ) {
+            long long count = 1 + next_random(&seed) % 300;
+            if (count > size - start) {
+                count = (long long)(size - start);
+            }
+            Enumerator e;
+            enumerator_init(&e, &ks, start, count);
+            KeyspaceIndex index = start;
+            do {
+                char password[MAX_PASSWORD_LEN + 1], enumerated[MAX_PASSWORD_LEN + 1];
+                MD5Block expected;
+                keyspace_index_to_password(&ks, index, password);
+                enumerator_block_init(&expected, &ks, password);
+                enumerator_block_password(&e.block, &ks, enumerated);
+                if (memcmp(&expected, &e.block, sizeof(expected)) != 0 ||
+                    strcmp(password, enumerated) != 0 ||
+                    keyspace_password_to_index(&ks, password) != index) {
+                    if (mismatches++ == 0) {
+                        char index_str[KEYSPACE_INDEX_STR];
+                        printf("  %s: índice %s deu \"%s\", esperado \"%s\"\n", name,
+                               keyspace_index_str(index, index_str), enumerated, password);
+                    }
+                }
+                index++;
+                visited++;
+            } while (enumerator_next(&e));
+            if (index != start + count) {
+                mismatches++;
+            }
+            start += count;
+        }
+
+        printf("  %s: %lld candidatos - %s\n", name, visited,
+               mismatches == 0 && visited == size ? "✓ PASSOU" : "✗ FALHOU");
+        failed += mismatches > 0 || visited != size;
+    }
+    return failed;
+}
+
+// ---------------------------------------------------------------------------
+// Busca ponta a ponta
+
+/**
+ * search_range com a saída dos workers descartada ("SENHA ENCONTRADA")
+ */
+static SearchStatus quiet_search(SearchContext *ctx, KeyspaceIndex start, KeyspaceIndex count,
+                                 int dynamic) {
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    int null = open("/dev/null", O_WRONLY);
+    dup2(null, STDOUT_FILENO);
+    close(null);
+
+    SearchStatus status = dynamic ? search_dynamic(ctx) : search_range(ctx, start, count);
+
+    fflush(stdout);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+    return status;
+}
+
+/**
+ * Planta o alvo em índices de fronteira e busca com a divisão estática (só
+ * a parte que contém o alvo o encontra, as vizinhas terminam sem ele) e com
+ * a fila dinâmica
+ *
+ * @return 1 se algum caso falhou, 0 caso contrário
+ */
+static int search_space(const Keyspace *ks, const char *name, SharedState *shared, int batch_only,
+                        uint32_t *seed) {
+    enum { PARTS = 7 };
+    KeyspaceIndex size = keyspace_size(ks);
+    int row = keyspace_row_length(ks);
+    KeyspaceIndex plants[8] = {0, row - 1, row, size - 1, size / 2, size - row,
+                               next_random(seed) % size, 0};
+    KeyspaceIndex count;
+
+    // Primeiro e último índice de cada parte da divisão estática
+    int part = (int)(next_random(seed) % (PARTS - 1));
+    plants[7] = keyspace_partition(size, PARTS, part + 1, &count) - 1;
+
+    int bad = 0;
+    for (int p = 0; p < 8; p++) {
+        char password[MAX_PASSWORD_LEN + 1], message[KEYSPACE_CANDIDATE_MAX + 1], hash[33];
+        keyspace_index_to_password(ks, plants[p], password);
+        keyspace_candidate(ks, password, message);
+        md5_string(message, hash);
+
+        SearchJob job;
+        search_job_init(&job, hash, ks);
+        if (batch_only) {
+            job.scan = NULL;
+        }
+
+        for (int i = 0; i < PARTS; i++) {
+            KeyspaceIndex start = keyspace_partition(size, PARTS, i, &count);
+            int inside = plants[p] >= start && plants[p] < start + count;
+            SearchContext ctx;
+            atomic_store(&shared->found, 0);
+            atomic_store(&shared->winner, -1);
+            search_context_init(&ctx, &job, shared, 0);
+            SearchStatus status = quiet_search(&ctx, start, count, 0);
+            if (status != (inside ? SEARCH_FOUND : SEARCH_DONE) ||
+                (inside && strcmp(shared->password, password) != 0)) {
+                printf("  %s%s: alvo \"%s\" na parte %d de %d - status %d\n", name,
+                       batch_only ? " (lote)" : "", password, i, PARTS, status);
+                bad++;
+            }
+        }
+
+        SearchContext ctx;
+        atomic_store(&shared->found, 0);
+        atomic_store(&shared->winner, -1);
+        atomic_store(&shared->next_index, 0);
+        shared->dynamic = 1;
+        shared->num_workers = 1;
+        shared_state_set_queue(shared, size);
+        search_context_init(&ctx, &job, shared, 0);
+        if (quiet_search(&ctx, 0, 0, 1) != SEARCH_FOUND || strcmp(shared->password, password) != 0) {
+            printf("  %s%s: alvo \"%s\" não encontrado pela fila dinâmica\n", name,
+                   batch_only ? " (lote)" : "", password);
+            bad++;
+        }
+    }
+    return bad > 0;
+}
+
+/**
+ * @return Número de espaços que falharam
+ */
+static int test_search_boundaries(void) {
+    SharedState *shared = shared_state_create_private();
+    uint32_t seed = 99;
+    int failed = 0;
+
+    if (shared == NULL) {
+        return NUM_SPACES;
+    }
+    // O vencedor avisa o coordinator (este processo) com SIGUSR1
+    signal(SIGUSR1, SIG_IGN);
+
+    for (int s = 0; s < NUM_SPACES; s++) {
+        Keyspace ks;
+        const char *name = test_space(&ks, s);
+        int bad = search_space(&ks, name, shared, 0, &seed) + search_space(&ks, name, shared, 1, &seed);
+        printf("  %s: núcleo e lote - %s\n", name, bad == 0 ? "✓ PASSOU" : "✗ FALHOU");
+        failed += bad > 0;
+    }
+    shared_state_destroy(shared, -1);
+    return failed;
+}
+
+int main(void) {
+    int num_tests = 0;
+    int failed = 0;
+
+    printf("=== Teste da Divisão do Espaço de Busca ===\n");
+    failed += test_static_partition();
+    failed += test_dynamic_queue();
+    num_tests += 3;
+    printf("\n");
+
+    printf("=== Teste do Enumerador (contra keyspace_index_to_password) ===\n");
+    failed += test_enumerator();
+    num_tests += NUM_SPACES;
+    printf("\n");
+
+    printf("=== Teste da Busca com o Alvo nas Fronteiras ===\n");
+    printf("Núcleo: %s\n", md5_isa_name(md5_isa_best()));
+    failed += test_search_boundaries();
+    num_tests += NUM_SPACES;
+    printf("\n");
+
+    printf("=== Resumo dos Testes ===\n");
+    printf("Total:   %d\n", num_tests);
+    printf("Passou:  %d\n", num_tests - failed);
+    printf("Falhou:  %d\n", failed);
+
+    if (failed == 0) {
+        printf("\n✓ Todos os testes passaram! Cada índice é verificado exatamente uma vez.\n");
+        return 0;
+    }
+    printf("\n✗ Alguns testes falharam. Verifique a divisão e a enumeração.\n");
+    return 1;
+}
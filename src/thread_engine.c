@@ -0,0 +1,134 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include "thread_engine.h"
+#include "perf_counters.h"
+
+/**
+ * Uma thread do pool; SearchContext é o primeiro campo e alinhado à linha
+ * de cache, então slots vizinhos nunca compartilham contadores
+ */
+typedef struct {
+    SearchContext ctx;
+    WorkerRange range;
+    int cpu;                    // CPU fixada, ou -1 sem afinidade
+    pthread_t thread;
+    SearchStatus status;
+    PerfSample perf;            // Medidas da thread (--perf)
+} ThreadSlot;
+
+/**
+ * Cópia do trabalho e do espaço de busca de uma thread
+ */
+typedef struct {
+    SearchJob job;
+    Keyspace keyspace;
+} LocalJob;
+
+static void *thread_main(void *arg) {
+    ThreadSlot *slot = arg;
+    SearchContext *ctx = &slot->ctx;
+
+    if (slot->cpu >= 0) {
+        topology_pin(slot->cpu);
+    }
+
+    // O charset de cada posição é lido a cada candidato: cada thread usa uma
+    // cópia que ela mesma escreve, já fixada, e que fica no seu nó NUMA
+    const SearchJob *shared_job = ctx->job;
+    LocalJob *local = shared_job->keyspace != NULL ? malloc(sizeof(LocalJob)) : NULL;
+    if (local != NULL) {
+        local->job = *shared_job;
+        local->keyspace = *shared_job->keyspace;
+        local->job.keyspace = &local->keyspace;
+        ctx->job = &local->job;
+    }
+
+    // Contadores abertos já na CPU fixada; cada thread mede só a si mesma
+    PerfCounters counters;
+    if (ctx->shared->profile) {
+        perf_counters_start(&counters);
+    }
+    if (ctx->shared->dynamic) {
+        slot->status = search_dynamic(ctx);
+    } else {
+        slot->status = search_range(ctx, slot->range.start_index, slot->range.count);
+    }
+    if (ctx->shared->profile) {
+        perf_counters_stop(&counters, &slot->perf);
+    }
+    ctx->job = shared_job;
+    free(local);
+    return NULL;
+}
+
+/**
+ * Lista as CPUs permitidas ao processo (respeita taskset/cgroups)
+ */
+static int allowed_cpus(int *cpus, int max_cpus) {
+    cpu_set_t set;
+    int count = 0;
+
+    if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+        return 0;
+    }
+    for (int cpu = 0; cpu < CPU_SETSIZE && count < max_cpus; cpu++) {
+        if (CPU_ISSET(cpu, &set)) {
+            cpus[count++] = cpu;
+        }
+    }
+    return count;
+}
+
+long long thread_engine_run(const SearchJob *job, SharedState *shared, int num_threads,
+                            const WorkerRange *ranges, const Topology *placement) {
+    ThreadSlot *slots = aligned_alloc(CACHE_LINE_SIZE, num_threads * sizeof(ThreadSlot));
+    int cpus[CPU_SETSIZE];
+    int num_cpus = placement == NULL ? allowed_cpus(cpus, CPU_SETSIZE) : 0;
+    int started = 0;
+
+    if (slots == NULL) {
+        perror("aligned_alloc");
+        return -1;
+    }
+
+    for (int i = 0; i < num_threads; i++) {
+        ThreadSlot *slot = &slots[i];
+        search_context_init(&slot->ctx, job, shared, i);
+        slot->range = ranges[i];
+        slot->cpu = placement != NULL ? topology_worker_cpu(placement, i) :
+                    num_cpus > 0 ? cpus[i % num_cpus] : -1;
+        slot->status = SEARCH_DONE;
+
+        if (pthread_create(&slot->thread, NULL, thread_main, slot) != 0) {
+            perror("pthread_create");
+            break;
+        }
+        started++;
+    }
+
+    long long total_checked = 0;
+    for (int i = 0; i < started; i++) {
+        pthread_join(slots[i].thread, NULL);
+        total_checked += slots[i].ctx.passwords_checked;
+        printf("Thread %d (CPU %d) terminou: %lld senhas%s", i, slots[i].cpu,
+               slots[i].ctx.passwords_checked,
+               slots[i].status == SEARCH_FOUND ? " - encontrou a senha" :
+               slots[i].status == SEARCH_STOPPED ? " - parou cedo" : "");
+        if (slots[i].ctx.cracked > 0) {
+            printf(" (%d hashes quebrados)", slots[i].ctx.cracked);
+        }
+        printf("\n");
+        if (shared->profile) {
+            char label[32];
+            snprintf(label, sizeof(label), "  [Thread %d]", i);
+            perf_counters_print(stdout, label, &slots[i].perf, slots[i].ctx.passwords_checked);
+        }
+    }
+
+    free(slots);
+    return started == num_threads ? total_checked : -1;
+}
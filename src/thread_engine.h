@@ -0,0 +1,38 @@
+#ifndef THREAD_ENGINE_H
+#define THREAD_ENGINE_H
+
+#include "search.h"
+#include "topology.h"
+
+/**
+ * Motor de execução com threads (--engine threads)
+ *
+ * Alternativa ao fork() + execl() por worker: um pool de pthreads dentro do
+ * próprio coordinator, cada uma fixada a uma CPU permitida pela máscara de
+ * afinidade do processo. O SearchJob (hash alvo, charset) é compartilhado
+ * somente leitura; cada thread tem seu SearchContext numa linha de cache própria.
+ */
+
+/**
+ * Intervalo de índices atribuído a um worker (ignorado no escalonamento dinâmico)
+ */
+typedef struct {
+    KeyspaceIndex start_index;
+    KeyspaceIndex count;
+} WorkerRange;
+
+/**
+ * Executa a busca com uma thread por worker e aguarda todas terminarem
+ *
+ * @param job Parâmetros da busca, compartilhados por todas as threads
+ * @param shared Flag de parada, slot de resultado e fila de blocos
+ * @param num_threads Número de threads (sem limite fixo)
+ * @param ranges Intervalo de cada thread (num_threads entradas)
+ * @param placement CPU de cada thread (num_workers = auto), ou NULL para as
+ *                  CPUs permitidas ao processo, em ordem
+ * @return Total de senhas verificadas, ou -1 se o pool não pôde ser criado
+ */
+long long thread_engine_run(const SearchJob *job, SharedState *shared, int num_threads,
+                            const WorkerRange *ranges, const Topology *placement);
+
+#endif // THREAD_ENGINE_H
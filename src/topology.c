@@ -0,0 +1,351 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include "topology.h"
+#include "hash_utils.h"
+#include "shared_state.h"
+
+#define SYSFS_CPU "/sys/devices/system/cpu"
+#define SYSFS_NODE "/sys/devices/system/node"
+#define TOPOLOGY_MAX_NODES 1024
+
+/**
+ * Primeiro inteiro de um arquivo do sysfs/cgroup
+ *
+ * @return 0 em caso de sucesso, -1 se o arquivo não existe ou não começa por um número
+ */
+static int read_long(const char *path, long long *value) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return -1;
+    }
+    int ok = fscanf(file, "%lld", value) == 1;
+    fclose(file);
+    return ok ? 0 : -1;
+}
+
+/**
+ * Lista de CPUs no formato do kernel ("0-3,8-11") numa máscara
+ */
+static int read_cpu_list(const char *path, cpu_set_t *set) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return -1;
+    }
+    CPU_ZERO(set);
+    int first, last;
+    char sep;
+    while (fscanf(file, "%d", &first) == 1) {
+        last = first;
+        if (fscanf(file, "%c", &sep) == 1 && sep == '-') {
+            if (fscanf(file, "%d", &last) != 1) {
+                break;
+            }
+            if (fscanf(file, "%c", &sep) != 1) {
+                sep = '\n';
+            }
+        }
+        for (int cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++) {
+            CPU_SET(cpu, set);
+        }
+        if (sep != ',') {
+            break;
+        }
+    }
+    fclose(file);
+    return 0;
+}
+
+/**
+ * Confere se a lista de controladores de uma linha v1 ("cpu,cpuacct") contém
+ * name como item inteiro: cpuset e cpuacct não são o controlador cpu
+ */
+static int has_controller(const char *list, const char *name) {
+    size_t len = strlen(name);
+    for (;;) {
+        size_t item = strcspn(list, ",");
+        if (item == len && strncmp(list, name, len) == 0) {
+            return 1;
+        }
+        if (list[item] == '\0') {
+            return 0;
+        }
+        list += item + 1;
+    }
+}
+
+/**
+ * CPUs inteiras que a cota do cgroup permite (cpu.max no v2, cfs_quota_us
+ * no v1), a menor entre o cgroup do processo e os seus ancestrais
+ *
+ * @return Cota arredondada para cima, ou 0 se não há cota
+ */
+static int read_quota_cpus(void) {
+    FILE *file = fopen("/proc/self/cgroup", "r");
+    if (file == NULL) {
+        return 0;
+    }
+
+    char line[4096], path[4096 + 64];
+    double quota = 0;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        // "0::/caminho" (v2) ou "N:cpu,cpuacct:/caminho" (v1)
+        char *controllers = strchr(line, ':');
+        char *group = controllers != NULL ? strchr(controllers + 1, ':') : NULL;
+        if (group == NULL) {
+            continue;
+        }
+        *group++ = '\0';
+        group[strcspn(group, "\n")] = '\0';
+        int v2 = strcmp(controllers + 1, "") == 0;
+        if (!v2 && !has_controller(controllers + 1, "cpu")) {
+            continue;
+        }
+
+        // Do cgroup até a raiz: a cota de um ancestral também limita
+        for (;;) {
+            long long limit = -1, period = 0;
+            if (v2) {
+                snprintf(path, sizeof(path), "/sys/fs/cgroup%s/cpu.max", group);
+                FILE *max = fopen(path, "r");
+                if (max != NULL) {
+                    if (fscanf(max, "%lld %lld", &limit, &period) != 2) {
+                        limit = -1;  // "max 100000": sem cota
+                    }
+                    fclose(max);
+                }
+            } else {
+                const char *mounts[] = {"/sys/fs/cgroup/cpu", "/sys/fs/cgroup/cpu,cpuacct"};
+                for (int m = 0; m < 2 && limit < 0; m++) {
+                    snprintf(path, sizeof(path), "%s%s/cpu.cfs_quota_us", mounts[m], group);
+                    if (read_long(path, &limit) == 0) {
+                        snprintf(path, sizeof(path), "%s%s/cpu.cfs_period_us", mounts[m], group);
+                        read_long(path, &period);
+                    }
+                }
+            }
+            if (limit > 0 && period > 0 && (quota == 0 || (double)limit / period < quota)) {
+                quota = (double)limit / period;
+            }
+            char *slash = strrchr(group, '/');
+            if (slash == NULL || group[1] == '\0') {
+                break;
+            }
+            if (slash == group) {
+                group[1] = '\0';
+            } else {
+                *slash = '\0';
+            }
+        }
+    }
+    fclose(file);
+
+    int cpus = (int)quota;
+    return cpus < quota ? cpus + 1 : cpus;
+}
+
+static int compare_placement(const void *a, const void *b) {
+    const TopologyCpu *x = a, *y = b;
+    if (x->sibling != y->sibling) return x->sibling - y->sibling;
+    if (x->node != y->node) return x->node - y->node;
+    if (x->core != y->core) return x->core - y->core;
+    return x->cpu - y->cpu;
+}
+
+/**
+ * CPUs permitidas, com núcleo e nó lidos do sysfs
+ */
+static int read_cpus(Topology *topology) {
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        return -1;
+    }
+    topology->cpus = calloc(CPU_COUNT(&allowed), sizeof(TopologyCpu));
+    if (topology->cpus == NULL) {
+        return -1;
+    }
+
+    char path[128];
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (!CPU_ISSET(cpu, &allowed)) {
+            continue;
+        }
+        TopologyCpu *entry = &topology->cpus[topology->num_cpus++];
+        long long package = 0, core = cpu;
+        snprintf(path, sizeof(path), SYSFS_CPU "/cpu%d/topology/physical_package_id", cpu);
+        read_long(path, &package);
+        snprintf(path, sizeof(path), SYSFS_CPU "/cpu%d/topology/core_id", cpu);
+        read_long(path, &core);
+        entry->cpu = cpu;
+        entry->core = (int)(package << 16 | (core & 0xffff));
+    }
+
+    // Nós NUMA: cada um lista as suas CPUs (sem o diretório, tudo no nó 0)
+    for (int node = 0; node < TOPOLOGY_MAX_NODES; node++) {
+        cpu_set_t set;
+        snprintf(path, sizeof(path), SYSFS_NODE "/node%d/cpulist", node);
+        if (read_cpu_list(path, &set) != 0) {
+            continue;
+        }
+        for (int i = 0; i < topology->num_cpus; i++) {
+            if (CPU_ISSET(topology->cpus[i].cpu, &set)) {
+                topology->cpus[i].node = node;
+            }
+        }
+    }
+
+    // Irmãos SMT: posição entre as CPUs permitidas do mesmo núcleo
+    // (as CPUs estão em ordem crescente aqui)
+    for (int i = 0; i < topology->num_cpus; i++) {
+        for (int j = 0; j < i; j++) {
+            topology->cpus[i].sibling += topology->cpus[j].core == topology->cpus[i].core;
+        }
+        topology->num_cores += topology->cpus[i].sibling == 0;
+    }
+    char seen[TOPOLOGY_MAX_NODES] = {0};
+    for (int i = 0; i < topology->num_cpus; i++) {
+        topology->num_nodes += !seen[topology->cpus[i].node];
+        seen[topology->cpus[i].node] = 1;
+    }
+
+    qsort(topology->cpus, topology->num_cpus, sizeof(TopologyCpu), compare_placement);
+    return 0;
+}
+
+typedef struct {
+    int cpu;
+    long long hashes;
+    double seconds;
+} CalibrationSlot;
+
+/**
+ * Lotes MD5 do núcleo SIMD escolhido, fixado na CPU, por um tempo fixo
+ */
+static void *calibration_thread(void *arg) {
+    CalibrationSlot *slot = arg;
+    MD5Block blocks[MD5_BATCH_MAX];
+    uint32_t states[MD5_BATCH_MAX][4] = {{0}};
+    int lanes = md5_isa_lanes(md5_isa_best());
+
+    topology_pin(slot->cpu);
+    for (int i = 0; i < MD5_BATCH_MAX; i++) {
+        md5_block_init(&blocks[i], "calibra", 7);
+    }
+    double start = monotonic_seconds(), elapsed;
+    do {
+        for (int round = 0; round < 256; round++) {
+            md5_block_set_byte(&blocks[round % lanes], 0, (uint8_t)(states[0][0] + round));
+            md5_batch(blocks, lanes, states);
+        }
+        slot->hashes += 256LL * lanes;
+    } while ((elapsed = monotonic_seconds() - start) < TOPOLOGY_CALIBRATION_SECONDS);
+    slot->seconds = elapsed;
+    return NULL;
+}
+
+/**
+ * Vazão somada de um thread por CPU
+ */
+static double calibration_rate(const int *cpus, int count) {
+    CalibrationSlot slots[2] = {{cpus[0], 0, 0}, {count > 1 ? cpus[1] : 0, 0, 0}};
+    pthread_t threads[2];
+    int started = 0;
+    for (; started < count; started++) {
+        if (pthread_create(&threads[started], NULL, calibration_thread, &slots[started]) != 0) {
+            break;
+        }
+    }
+    double rate = 0;
+    for (int i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+        rate += slots[i].hashes / slots[i].seconds;
+    }
+    return started == count ? rate : 0;
+}
+
+/**
+ * Dois irmãos SMT de um mesmo núcleo contra um deles sozinho
+ */
+static double calibrate_smt(const Topology *topology) {
+    for (int i = 0; i < topology->num_cpus; i++) {
+        if (topology->cpus[i].sibling != 1) {
+            continue;
+        }
+        for (int j = 0; j < topology->num_cpus; j++) {
+            if (topology->cpus[j].sibling == 0 && topology->cpus[j].core == topology->cpus[i].core) {
+                int pair[2] = {topology->cpus[j].cpu, topology->cpus[i].cpu};
+                double single = calibration_rate(pair, 1);
+                double both = calibration_rate(pair, 2);
+                return single > 0 ? both / single : 0;
+            }
+        }
+    }
+    return 0;
+}
+
+int topology_auto(Topology *topology) {
+    memset(topology, 0, sizeof(*topology));
+    if (read_cpus(topology) != 0 || topology->num_cpus == 0) {
+        // Sem afinidade: um worker por CPU online, sem fixar
+        free(topology->cpus);
+        memset(topology, 0, sizeof(*topology));
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        topology->num_workers = online > 0 ? (int)online : 1;
+        return topology->num_workers;
+    }
+    topology->quota_cpus = read_quota_cpus();
+
+    int limit = topology->num_cpus;
+    if (topology->quota_cpus > 0 && topology->quota_cpus < limit) {
+        limit = topology->quota_cpus;
+    }
+    topology->num_workers = limit;
+    if (limit > topology->num_cores) {
+        topology->smt_gain = calibrate_smt(topology);
+        if (topology->smt_gain < TOPOLOGY_SMT_GAIN) {
+            topology->num_workers = topology->num_cores;
+        }
+    }
+    return topology->num_workers;
+}
+
+int topology_worker_cpu(const Topology *topology, int worker) {
+    return topology->cpus[worker % topology->num_cpus].cpu;
+}
+
+int topology_pin(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0 ? 0 : -1;
+}
+
+void topology_print(const Topology *topology) {
+    if (topology->num_cpus == 0) {
+        printf("Topologia: indisponível, um worker por CPU online\n");
+        return;
+    }
+    printf("Topologia: %d CPUs permitidas, %d núcleos físicos, %d nó(s) NUMA", topology->num_cpus,
+           topology->num_cores, topology->num_nodes);
+    if (topology->quota_cpus > 0) {
+        printf(", cota do cgroup de %d CPU(s)", topology->quota_cpus);
+    }
+    printf("\n");
+    if (topology->smt_gain > 0) {
+        printf("SMT: dois irmãos rendem %.2fx um só - %s\n", topology->smt_gain,
+               topology->smt_gain >= TOPOLOGY_SMT_GAIN ? "usando os irmãos" :
+                                                        "um worker por núcleo");
+    }
+    printf("Workers fixados: um por núcleo físico primeiro, nó NUMA por nó NUMA\n");
+}
+
+void topology_free(Topology *topology) {
+    free(topology->cpus);
+    topology->cpus = NULL;
+    topology->num_cpus = 0;
+}
@@ -0,0 +1,66 @@
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+/**
+ * Topologia de CPUs para num_workers = auto
+ *
+ * Lê do sysfs as CPUs permitidas ao processo (afinidade), o núcleo físico e
+ * o nó NUMA de cada uma, e a cota de CPU do cgroup (v2 ou v1). O número de
+ * workers é o que a cota deixa usar, com no máximo um worker por núcleo
+ * físico a não ser que uma calibração curta mostre que dois irmãos SMT no
+ * mesmo núcleo rendem pelo menos TOPOLOGY_SMT_GAIN vezes um só. O MD5 é
+ * limitado pelas unidades de execução, e irmãos SMT podem só dividir o núcleo.
+ *
+ * As CPUs ficam na ordem de ocupação: primeiro um thread de cada núcleo,
+ * nó NUMA por nó NUMA, depois os irmãos SMT na mesma ordem.
+ */
+
+#define TOPOLOGY_SMT_GAIN 1.10              // Ganho mínimo para usar os irmãos SMT
+#define TOPOLOGY_CALIBRATION_SECONDS 0.1    // Duração de cada medida da calibração
+
+typedef struct {
+    int cpu;                    // Número da CPU lógica
+    int core;                   // Núcleo físico (pacote e core_id)
+    int node;                   // Nó NUMA
+    int sibling;                // 0 = primeiro thread do núcleo, 1 = primeiro irmão SMT, ...
+} TopologyCpu;
+
+typedef struct {
+    TopologyCpu *cpus;          // CPUs permitidas, na ordem de ocupação
+    int num_cpus;
+    int num_cores;
+    int num_nodes;
+    int quota_cpus;             // Cota do cgroup arredondada para cima, ou 0 = sem cota
+    double smt_gain;            // Vazão de dois irmãos SMT sobre um (calibração), ou 0
+    int num_workers;            // Escolha de topology_auto()
+} Topology;
+
+/**
+ * Lê a topologia, calibra o SMT se a cota deixar usar irmãos e escolhe o
+ * número de workers
+ * Sem sysfs, cada CPU permitida conta como um núcleo num único nó.
+ *
+ * @return Número de workers (pelo menos 1)
+ */
+int topology_auto(Topology *topology);
+
+/**
+ * CPU em que o worker deve ser fixado (as CPUs se repetem em ciclo)
+ */
+int topology_worker_cpu(const Topology *topology, int worker);
+
+/**
+ * Fixa a thread que chama numa CPU
+ *
+ * @return 0 em caso de sucesso, -1 caso contrário
+ */
+int topology_pin(int cpu);
+
+/**
+ * Mostra o que foi lido e a escolha
+ */
+void topology_print(const Topology *topology);
+
+void topology_free(Topology *topology);
+
+#endif // TOPOLOGY_H
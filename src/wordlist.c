@@ -0,0 +1,59 @@
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "wordlist.h"
+
+int wordlist_open(Wordlist *w, const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        perror("fstat");
+        close(fd);
+        return -1;
+    }
+
+    w->data = NULL;
+    w->size = st.st_size;
+    if (w->size > 0) {
+        void *data = mmap(NULL, w->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            perror("mmap");
+            close(fd);
+            return -1;
+        }
+        // Cada worker lê o seu trecho do início ao fim: leitura antecipada agressiva
+        madvise(data, w->size, MADV_SEQUENTIAL);
+        w->data = data;
+    }
+
+    // O mapeamento continua válido sem o descritor
+    close(fd);
+    return 0;
+}
+
+void wordlist_close(Wordlist *w) {
+    if (w->data != NULL) {
+        munmap((void *)w->data, w->size);
+        w->data = NULL;
+    }
+}
+
+size_t wordlist_line_start(const Wordlist *w, size_t offset) {
+    if (offset == 0 || offset >= w->size) {
+        return offset < w->size ? offset : w->size;
+    }
+    if (w->data[offset - 1] == '\n') {
+        return offset;
+    }
+
+    const char *newline = memchr(w->data + offset, '\n', w->size - offset);
+    return newline != NULL ? (size_t)(newline - w->data) + 1 : w->size;
+}
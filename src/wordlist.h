@@ -0,0 +1,38 @@
+#ifndef WORDLIST_H
+#define WORDLIST_H
+
+#include <stddef.h>
+
+/**
+ * Wordlist mapeada em memória (--wordlist)
+ *
+ * O arquivo inteiro é mapeado somente leitura e as linhas são hasheadas direto
+ * do mapeamento, sem stdio nem cópia intermediária: cada linha vai da página
+ * do arquivo para o bloco MD5. O trabalho é dividido em intervalos de bytes; um
+ * intervalo é dono das linhas que começam dentro dele, então qualquer divisão
+ * cobre cada linha exatamente uma vez.
+ */
+
+#define WORDLIST_LINE_MAX 63   // Linhas maiores são ignoradas (não cabem no slot de resultado)
+
+typedef struct {
+    const char *data;          // NULL se o arquivo estiver vazio
+    size_t size;
+} Wordlist;
+
+/**
+ * Mapeia o arquivo (leitura sequencial)
+ *
+ * @return 0 em caso de sucesso, -1 se o arquivo não pôde ser aberto ou mapeado
+ */
+int wordlist_open(Wordlist *w, const char *path);
+
+void wordlist_close(Wordlist *w);
+
+/**
+ * Início da primeira linha que começa em offset ou depois dele
+ * Usado pelo coordinator para alinhar a divisão estática a quebras de linha.
+ */
+size_t wordlist_line_start(const Wordlist *w, size_t offset);
+
+#endif // WORDLIST_H
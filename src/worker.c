@@ -2,10 +2,18 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
-#include <fcntl.h>
 #include <sys/types.h>
 #include <time.h>
 #include "hash_utils.h"
+#include "shared_state.h"
+#include "keyspace.h"
+#include "search.h"
+#include "target_set.h"
+#include "wordlist.h"
+#include "rules.h"
+#include "cluster.h"
+#include "pool.h"
+#include "perf_counters.h"
 
 /**
  * PROCESSO TRABALHADOR - Mini-Projeto 1: Quebra de Senhas Paralelo
@@ -13,138 +21,204 @@
  * Este programa verifica um subconjunto do espaço de senhas, usando a biblioteca
  * MD5 FORNECIDA para calcular hashes e comparar com o hash alvo.
  * 
- * Uso: ./worker <hash_alvo> <senha_inicial> <senha_final> <charset> <tamanho> <worker_id>
+ * Uso: ./worker <hash_alvo> <senha_inicial> <senha_final> <charset> <tamanho> <worker_id> [shm_fd]
+ *      ./worker --wordlist <arquivo> <hash_alvo> <byte_inicial> <byte_final> <worker_id> [shm_fd]
+ *      ./worker --connect <host:porta> <worker_id>
+ *      ./worker --pool <shm_fd> <worker_id>
  * 
- * EXECUTADO AUTOMATICAMENTE pelo coordinator através de fork() + execl()
- * SEU TRABALHO: Implementar os TODOs de busca e comunicação
- */
-
-#define RESULT_FILE "password_found.txt"
-#define PROGRESS_INTERVAL 100000  // Reportar progresso a cada N senhas
-
-/**
- * Incrementa uma senha para a próxima na ordem lexicográfica (aaa -> aab -> aac...)
- * 
- * @param password Senha atual (será modificada)
- * @param charset Conjunto de caracteres permitidos
- * @param charset_len Tamanho do conjunto
- * @param password_len Comprimento da senha
- * @return 1 se incrementou com sucesso, 0 se chegou ao limite (overflow)
- */
-int increment_password(char *password, const char *charset, int charset_len, int password_len) {
-    
-    // TODO 1: Implementar o algoritmo de incremento de senha
-    // OBJETIVO: Incrementar senha como um contador (ex: aaa -> aab -> aac -> aad...)
-    // DICA: Começar do último caractere, como somar 1 em um número
-    // DICA: Se um caractere "estoura", volta ao primeiro e incrementa o caracter a esquerda (aay -> aaz -> aba)
-    
-    // IMPLEMENTE AQUI:
-    // - Percorrer password de trás para frente
-    // - Para cada posição, encontrar índice atual no charset
-    // - Incrementar índice
-    // - Se não estourou: atualizar caractere e retornar 1
-    // - Se estourou: definir como primeiro caractere e continuar loop
-    // - Se todos estouraram: retornar 0 (fim do espaço)
-    
-    return 0;  // SUBSTITUA por sua implementação
-}
-
-/**
- * Compara duas senhas lexicograficamente
+ * Quando lançado pelo coordinator, recebe em shm_fd a página compartilhada com a
+ * flag de parada e o slot de resultado. Sem ela (execução manual), usa o arquivo
+ * password_found.txt como antes. A página também traz o espaço de busca com o
+ * charset de cada posição (necessário no modo --mask, em que o argumento charset
+ * é apenas a máscara, para exibição). No modo --list ela traz ainda o conjunto
+ * de alvos, e hash_alvo é apenas o nome do arquivo da lista. Na forma --wordlist
+ * o worker mapeia o arquivo e verifica as linhas que começam em [byte_inicial,
+ * byte_final); se a página trouxer regras (--rules), testa os candidatos que
+ * elas geram a partir de cada linha. Na forma --connect o trabalho e os blocos
+ * vêm de um coordinator --server pela rede (cluster.c). Na forma --pool o
+ * worker fica vivo entre trabalhos e os recebe pela página (coordinator
+ * --queue, pool.c).
  * 
- * @return -1 se a < b, 0 se a == b, 1 se a > b
- */
-int password_compare(const char *a, const char *b) {
-    return strcmp(a, b);
-}
-
-/**
- * Verifica se o arquivo de resultado já existe
- * Usado para parada antecipada se outro worker já encontrou a senha
- */
-int check_result_exists() {
-    return access(RESULT_FILE, F_OK) == 0;
-}
-
-/**
- * Salva a senha encontrada no arquivo de resultado
- * Usa O_CREAT | O_EXCL para garantir escrita atômica (apenas um worker escreve)
+ * EXECUTADO AUTOMATICAMENTE pelo coordinator através de fork() + execl()
+ * O laço de busca em si fica em search.c, compartilhado com o motor de threads.
  */
-void save_result(int worker_id, const char *password) {
-    // TODO 2: Implementar gravação atômica do resultado
-    // OBJETIVO: Garantir que apenas UM worker escreva no arquivo
-    // DICA: Use O_CREAT | O_EXCL - falha se arquivo já existe
-    // FORMATO DO ARQUIVO: "worker_id:password\n"
-    
-    // IMPLEMENTE AQUI:
-    // - Tentar abrir arquivo com O_CREAT | O_EXCL | O_WRONLY
-    // - Se sucesso: escrever resultado e fechar
-    // - Se falhou: outro worker já encontrou
-}
 
 /**
  * Função principal do worker
  */
 int main(int argc, char *argv[]) {
+    // Worker remoto: tudo vem do servidor de blocos
+    if (argc == 4 && strcmp(argv[1], "--connect") == 0) {
+        return cluster_work(argv[2], atoi(argv[3])) == 0 ? 0 : 1;
+    }
+    
+    // Worker permanente da fila de trabalhos
+    if (argc == 4 && strcmp(argv[1], "--pool") == 0) {
+        int shm_fd = atoi(argv[2]);
+        SharedState *shared = shared_state_attach(shm_fd);
+        close(shm_fd);
+        if (shared == NULL || pool_from_shared(shared) == NULL) {
+            fprintf(stderr, "[Worker %s] Página sem fila de trabalhos\n", argv[3]);
+            return 1;
+        }
+        pool_work(shared, atoi(argv[3]));
+        shared_state_destroy(shared, -1);
+        return 0;
+    }
+    
     // Validar argumentos
-    if (argc != 7) {
-        fprintf(stderr, "Uso interno: %s <hash> <start> <end> <charset> <len> <id>\n", argv[0]);
+    if (argc != 7 && argc != 8) {
+        fprintf(stderr, "Uso interno: %s <hash> <start> <end> <charset> <len> <id> [shm_fd]\n", argv[0]);
+        fprintf(stderr, "             %s --wordlist <arquivo> <hash> <byte_inicial> <byte_final> <id> [shm_fd]\n",
+                argv[0]);
+        fprintf(stderr, "             %s --connect <host:porta> <id>\n", argv[0]);
+        fprintf(stderr, "             %s --pool <shm_fd> <id>\n", argv[0]);
         return 1;
     }
     
-    // Parse dos argumentos
-    const char *target_hash = argv[1];
-    char *start_password = argv[2];
-    const char *end_password = argv[3];
-    const char *charset = argv[4];
-    int password_len = atoi(argv[5]);
+    // Parse dos argumentos (a forma --wordlist tem o mesmo número de posições)
+    int use_wordlist = strcmp(argv[1], "--wordlist") == 0;
+    const char *target_hash = argv[use_wordlist ? 3 : 1];
+    const char *start_arg = argv[use_wordlist ? 4 : 2];
+    const char *end_arg = argv[use_wordlist ? 5 : 3];
     int worker_id = atoi(argv[6]);
-    int charset_len = strlen(charset);
     
-    printf("[Worker %d] Iniciado: %s até %s\n", worker_id, start_password, end_password);
+    // Página compartilhada com o coordinator (flag de parada, resultado e fila)
+    SharedState *shared = NULL;
+    if (argc == 8) {
+        int shm_fd = atoi(argv[7]);
+        shared = shared_state_attach(shm_fd);
+        close(shm_fd);
+        if (shared == NULL) {
+            return 1;
+        }
+    }
+    
+    // Espaço de busca: wordlist mapeada, o da página (charset ou máscara), ou o
+    // charset do argv. O intervalo é [início, fim]; na wordlist, em bytes [início, fim)
+    Wordlist wordlist = {NULL, 0};
+    Keyspace local_keyspace;
+    const Keyspace *keyspace = NULL;
+    KeyspaceIndex start_index = -1, count = -1;
+    if (use_wordlist) {
+        char *start_end, *end_end;
+        start_index = strtoll(start_arg, &start_end, 10);
+        long long end_offset = strtoll(end_arg, &end_end, 10);
+        if (*start_end == '\0' && *end_end == '\0' && wordlist_open(&wordlist, argv[2]) == 0 &&
+            end_offset <= (long long)wordlist.size) {
+            count = end_offset - start_index;
+        }
+    } else {
+        if (shared != NULL) {
+            // Cópia privada, lida a cada candidato: escrita pelo worker (já
+            // fixado na sua CPU com auto), fica no nó NUMA dele, e não no do
+            // coordinator, que criou a página
+            local_keyspace = shared->keyspace;
+            keyspace = &local_keyspace;
+        } else if (keyspace_init_charset(&local_keyspace, argv[4], atoi(argv[5])) == 0) {
+            keyspace = &local_keyspace;
+        }
+        if (keyspace != NULL) {
+            KeyspaceIndex end_index = keyspace_password_to_index(keyspace, end_arg);
+            start_index = keyspace_password_to_index(keyspace, start_arg);
+            if (start_index >= 0 && end_index >= start_index) {
+                count = end_index - start_index + 1;
+            }
+        }
+    }
+    if (start_index < 0 || count < 0) {
+        fprintf(stderr, "[Worker %d] Parâmetros de intervalo inválidos\n", worker_id);
+        wordlist_close(&wordlist);
+        shared_state_destroy(shared, -1);
+        return 1;
+    }
+    int dynamic = shared != NULL && shared->dynamic;
+    
+    if (dynamic) {
+        printf("[Worker %d] Iniciado: blocos dinâmicos da fila compartilhada\n", worker_id);
+    } else if (use_wordlist) {
+        printf("[Worker %d] Iniciado: bytes %s até %s de %s\n", worker_id, start_arg, end_arg,
+               argv[2]);
+    } else {
+        printf("[Worker %d] Iniciado: %s até %s\n", worker_id, start_arg, end_arg);
+    }
     
-    // Buffer para a senha atual
-    char current_password[11];
-    strcpy(current_password, start_password);
+    // Hash alvo decodificado uma única vez: cada candidato é comparado
+    // com quatro comparações de inteiros, sem sprintf nem strcmp
+    // No modo --list os alvos vêm da página compartilhada e argv[1] é só o nome da lista
+    SearchJob job;
+    SearchContext ctx;
+    TargetSet *targets = shared != NULL ? target_set_from_shared(shared) : NULL;
+    int target_valid = 1;
+    if (targets != NULL) {
+        search_job_init_list(&job, targets, keyspace);
+    } else {
+        target_valid = search_job_init(&job, target_hash, keyspace) == 0;
+    }
+    if (use_wordlist) {
+        search_job_use_wordlist(&job, &wordlist);
+        if (shared != NULL) {
+            search_job_use_rules(&job, rules_from_shared(shared), shared->num_rules);
+        }
+    }
+    search_context_init(&ctx, &job, shared, worker_id);
     
-    // Buffer para o hash calculado
-    char computed_hash[33];
+    // Contadores da thread do worker, só em volta da busca
+    int profile = shared != NULL && shared->profile;
+    PerfCounters counters;
+    PerfSample sample;
+    if (profile) {
+        perf_counters_start(&counters);
+    }
     
-    // Contadores para estatísticas
-    long long passwords_checked = 0;
-    time_t start_time = time(NULL);
-    time_t last_progress_time = start_time;
+    double start_time = monotonic_seconds();
+    SearchStatus status = SEARCH_DONE;
+    if (!target_valid) {
+        printf("[Worker %d] Hash alvo inválido - nenhuma senha pode corresponder\n", worker_id);
+    } else if (dynamic) {
+        status = search_dynamic(&ctx);
+    } else {
+        status = search_range(&ctx, start_index, count);
+    }
+    if (profile) {
+        perf_counters_stop(&counters, &sample);
+    }
     
-    // Loop principal de verificação
-    while (1) {
-        // TODO 3: Verificar periodicamente se outro worker já encontrou a senha
-        // DICA: A cada PROGRESS_INTERVAL senhas, verificar se arquivo resultado existe
-        
-        // TODO 4: Calcular o hash MD5 da senha atual
-        // IMPORTANTE: Use a biblioteca MD5 FORNECIDA - md5_string(senha, hash_buffer)
-        
-        // TODO 5: Comparar com o hash alvo
-        // Se encontrou: salvar resultado e terminar
-        
-        // TODO 6: Incrementar para a próxima senha
-        // DICA: Use a função increment_password implementada acima
-        
-        // TODO: Verificar se chegou ao fim do intervalo
-        // Se sim: terminar loop
-        
-        passwords_checked++;
+    if (status == SEARCH_STOPPED && targets != NULL) {
+        printf("[Worker %d] Parando - todos os hashes da lista foram quebrados\n", worker_id);
+    } else if (status == SEARCH_STOPPED) {
+        printf("[Worker %d] Parando - senha já foi encontrada por outro worker\n", worker_id);
+    } else if (status == SEARCH_DONE && dynamic) {
+        printf("[Worker %d] Fila esgotada. %lld blocos, %lld senhas verificadas.\n",
+               worker_id, ctx.chunks_claimed, ctx.passwords_checked);
+    } else if (status == SEARCH_DONE) {
+        printf("[Worker %d] Intervalo completo. %lld senhas verificadas.\n",
+               worker_id, ctx.passwords_checked);
     }
     
     // Estatísticas finais
-    time_t end_time = time(NULL);
-    double total_time = difftime(end_time, start_time);
+    double total_time = monotonic_seconds() - start_time;
     
     printf("[Worker %d] Finalizado. Total: %lld senhas em %.2f segundos", 
-           worker_id, passwords_checked, total_time);
+           worker_id, ctx.passwords_checked, total_time);
     if (total_time > 0) {
-        printf(" (%.0f senhas/s)", passwords_checked / total_time);
+        printf(" (%.0f senhas/s)", ctx.passwords_checked / total_time);
     }
     printf("\n");
+    if (profile) {
+        char label[32];
+        snprintf(label, sizeof(label), "[Worker %d]", worker_id);
+        perf_counters_print(stdout, label, &sample, ctx.passwords_checked);
+    }
+    if (targets != NULL) {
+        printf("[Worker %d] Hashes quebrados por este worker: %d\n", worker_id, ctx.cracked);
+    }
+    if (ctx.words_skipped > 0) {
+        printf("[Worker %d] Linhas com mais de %d bytes ignoradas: %lld\n", worker_id,
+               job.rules != NULL ? MD5_BLOCK_MAX_INPUT : WORDLIST_LINE_MAX, ctx.words_skipped);
+    }
     
+    wordlist_close(&wordlist);
+    shared_state_destroy(shared, -1);
     return 0;
-}
\ No newline at end of file
+}
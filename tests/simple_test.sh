@@ -46,7 +46,7 @@ run_test() {
     rm -f password_found.txt
     
     # Executar com timeout de 30 segundos
-    timeout 30s ./coordinator "$hash" "$length" "$charset" "$workers" > test_output.tmp 2>&1
+    timeout 30s ./coordinator --no-potfile "$hash" "$length" "$charset" "$workers" > test_output.tmp 2>&1
     local exit_code=$?
     
     if [ $exit_code -eq 124 ]; then
@@ -114,7 +114,7 @@ performance_test() {
         rm -f password_found.txt
         
         start_time=$(date +%s.%N)
-        timeout 60s ./coordinator "$hash" "$length" "$charset" "$workers" >/dev/null 2>&1
+        timeout 60s ./coordinator --no-potfile "$hash" "$length" "$charset" "$workers" >/dev/null 2>&1
         end_time=$(date +%s.%N)
         
         if [ -f "password_found.txt" ]; then
@@ -192,7 +192,275 @@ run_test "Charset Maior" \
     "4" \
     "hello"
 
-# Teste de Performance
+# Teste 6: Lista de hashes numa única passada (--list)
+echo -e "\n${YELLOW}[Teste] Lista de Hashes (--list)${NC}"
+rm -f password_found.txt
+printf '%s\n' "900150983cd24fb0d6963f7d28e17f72" "hash_invalido" \
+    "4a8a08f09d37b73795649038408b5f33" "1af6d6f2f682f76f80e606aeaaee1680" > hashes.tmp
+timeout 30s ./coordinator --no-potfile --list hashes.tmp 3 "abc" 2 > test_output.tmp 2>&1
+LIST_LINES=$(grep -cE '^[0-9a-f]{32}:[0-9]+:[abc]{3}$' password_found.txt 2>/dev/null)
+if grep -q "^900150983cd24fb0d6963f7d28e17f72:[0-9]*:abc$" password_found.txt 2>/dev/null && \
+   [ "$LIST_LINES" = "1" ] && grep -q "1 de 3 hashes quebrados" test_output.tmp; then
+    echo -e "${GREEN}✓ PASSOU: 1 de 3 hashes quebrados, uma linha por resultado${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ FALHOU: Resultado da lista incorreto${NC}"
+    cat test_output.tmp password_found.txt 2>/dev/null
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+rm -f hashes.tmp
+
+# Teste 7: Máscara com charset por posição, charset personalizado e literal
+echo -e "\n${YELLOW}[Teste] Máscara (--mask '?u?l?d?1_' -1 'xyz')${NC}"
+rm -f password_found.txt
+timeout 30s ./coordinator --no-potfile --mask '?u?l?d?1_' -1 'xyz' "$(./test_hash 'Qa7y_' | awk '/MD5:/{print $2}')" 2 \
+    > test_output.tmp 2>&1
+if grep -q "^[0-9]*:Qa7y_$" password_found.txt 2>/dev/null && \
+   grep -q "Espaço de busca total: 20280 " test_output.tmp; then
+    echo -e "${GREEN}✓ PASSOU: Senha 'Qa7y_' encontrada em 26 x 26 x 10 x 3 x 1 = 20280 combinações${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ FALHOU: Busca por máscara incorreta${NC}"
+    cat test_output.tmp password_found.txt 2>/dev/null
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+
+# Teste 8: Wordlist mapeada em memória, dividida em intervalos de bytes
+echo -e "\n${YELLOW}[Teste] Wordlist (--wordlist)${NC}"
+rm -f password_found.txt
+printf 'senha\nadmin\r\nqwerty\n123456\nhello\nletmein' > wordlist.tmp
+timeout 30s ./coordinator --no-potfile --wordlist wordlist.tmp "0d107d09f5bbe40cade3de5c71e9e9b7" 3 \
+    > test_output.tmp 2>&1
+if grep -q "^[0-9]*:letmein$" password_found.txt 2>/dev/null; then
+    echo -e "${GREEN}✓ PASSOU: Senha 'letmein' (última linha, sem quebra de linha) encontrada${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ FALHOU: Senha da wordlist não encontrada${NC}"
+    cat test_output.tmp
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+rm -f wordlist.tmp
+
+# Teste 9: Regras aplicadas às linhas da wordlist
+echo -e "\n${YELLOW}[Teste] Regras (--rules)${NC}"
+rm -f password_found.txt
+printf 'admin\npassword\nqwerty\n' > wordlist.tmp
+printf '# comentário\n:\nu\nc $1\nsa@ so0 $!\n' > rules.tmp
+timeout 30s ./coordinator --no-potfile --wordlist wordlist.tmp --rules rules.tmp \
+    "d5ec75d5fe70d428685510fae36492d9" 2 > test_output.tmp 2>&1
+if grep -q "^[0-9]*:p@ssw0rd!$" password_found.txt 2>/dev/null; then
+    echo -e "${GREEN}✓ PASSOU: Senha 'p@ssw0rd!' gerada pela regra 'sa@ so0 \$!'${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ FALHOU: Candidato gerado por regra não encontrado${NC}"
+    cat test_output.tmp
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+rm -f wordlist.tmp rules.tmp
+
+# Teste 10: Checkpoint de uma busca interrompida e retomada com --resume
+echo -e "\n${YELLOW}[Teste] Checkpoint e --resume${NC}"
+rm -f checkpoint.tmp
+setsid ./coordinator --no-potfile --checkpoint checkpoint.tmp "ffffffffffffffffffffffffffffffff" 7 \
+    abcdefghijklmnopqrstuvwxyz 2 > /dev/null 2>&1 &
+COORD_PID=$!
+sleep 6
+kill -KILL -- -$COORD_PID 2>/dev/null   # Simula uma queda: coordinator e workers
+wait $COORD_PID 2>/dev/null
+timeout -s KILL 3s setsid ./coordinator --no-potfile --checkpoint checkpoint.tmp --resume \
+    "ffffffffffffffffffffffffffffffff" 7 abcdefghijklmnopqrstuvwxyz 2 > test_output.tmp 2>&1
+pkill -KILL -x worker 2>/dev/null
+./coordinator --no-potfile --checkpoint checkpoint.tmp --resume "ffffffffffffffffffffffffffffffff" 7 abc 2 \
+    > test_mismatch.tmp 2>&1
+if grep -q "^feito [0-9]* [0-9]*$" checkpoint.tmp 2>/dev/null &&
+   grep -q "já verificados" test_output.tmp && grep -q "outro trabalho" test_mismatch.tmp; then
+    echo -e "${GREEN}✓ PASSOU: $(grep -o '[0-9]* de [0-9]* já verificados' test_output.tmp)${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ FALHOU: Checkpoint não gravado ou não retomado${NC}"
+    cat checkpoint.tmp test_output.tmp test_mismatch.tmp 2>/dev/null
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+rm -f checkpoint.tmp checkpoint.tmp.tmp test_mismatch.tmp
+
+# Teste 11: Servidor de blocos e nó remoto no loopback (--server / --connect)
+echo -e "\n${YELLOW}[Teste] Modo distribuído (--server / --connect)${NC}"
+PORT=$((20000 + $$ % 20000))
+timeout 30s ./coordinator --no-potfile --server $PORT "5d41402abc4b2a76b9719d911017c592" 5 \
+    abcdefghijklmnopqrstuvwxyz 0 > test_output.tmp 2>&1 &
+SERVER_PID=$!
+sleep 0.5
+timeout 30s ./coordinator --connect 127.0.0.1:$PORT 2 > test_node.tmp 2>&1
+wait $SERVER_PID
+if grep -q "Senha: hello" test_output.tmp && grep -q "Servidor encerrou" test_node.tmp; then
+    echo -e "${GREEN}✓ PASSOU: Senha 'hello' encontrada por um nó remoto${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ FALHOU: Servidor ou nó remoto não concluíram a busca${NC}"
+    cat test_output.tmp test_node.tmp 2>/dev/null
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+rm -f test_node.tmp
+
+# Teste 12: Telemetria ao vivo (--status)
+echo -e "\n${YELLOW}[Teste] Telemetria (--status 1)${NC}"
+timeout 30s ./coordinator --no-potfile --status 1 "ffffffffffffffffffffffffffffffff" 6 \
+    abcdefghijklmnopqrstuvwxyz 2 > test_output.tmp 2>&1
+if grep -q "^\[Status [0-9:]*\] [0-9.]*% coberto, [0-9]* senhas, [0-9.]* M senhas/s, fim em" test_output.tmp &&
+   grep -q "Por worker (M/s): 0=[0-9.]* 1=[0-9.]*" test_output.tmp; then
+    echo -e "${GREEN}✓ PASSOU: $(grep -c '^\[Status' test_output.tmp) relatório(s) com taxa, cobertura e ETA${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ FALHOU: Nenhum relatório de status${NC}"
+    cat test_output.tmp
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+
+# Teste 13: Tabela rainbow (gerada aqui, ~96% de cobertura; a busca de 12345 é determinística)
+echo -e "\n${YELLOW}[Teste] Tabela rainbow (rainbow_gen + --rainbow)${NC}"
+rm -f test_table.rt
+if timeout 30s ./rainbow_gen -t 2 test_table.rt 5 0123456789 4000 200 > test_node.tmp 2>&1 &&
+   timeout 30s ./coordinator --no-potfile --rainbow test_table.rt "827ccb0eea8a706c4c34a16891f84e7b" 2 > test_output.tmp 2>&1 &&
+   grep -q "Senha: 12345" test_output.tmp && grep -q "^[0-9]*:12345$" password_found.txt; then
+    echo -e "${GREEN}✓ PASSOU: Senha '12345' encontrada na tabela ($(grep -o '[0-9]* cadeias' test_node.tmp | tail -1))${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ FALHOU: Senha não encontrada na tabela rainbow${NC}"
+    cat test_node.tmp test_output.tmp 2>/dev/null
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+rm -f test_table.rt test_node.tmp
+
+# Teste 14: Potfile - a segunda execução responde sem criar workers
+echo -e "\n${YELLOW}[Teste] Potfile (--potfile)${NC}"
+rm -f potfile.tmp potfile.tmp.idx password_found.txt
+timeout 30s ./coordinator --potfile potfile.tmp "5d41402abc4b2a76b9719d911017c592" 5 \
+    abcdefghijklmnopqrstuvwxyz 2 > /dev/null 2>&1
+rm -f password_found.txt
+timeout 5s ./coordinator --potfile potfile.tmp "5d41402abc4b2a76b9719d911017c592" 5 \
+    abcdefghijklmnopqrstuvwxyz 2 > test_output.tmp 2>&1
+if grep -q "^5d41402abc4b2a76b9719d911017c592:hello$" potfile.tmp && \
+   grep -q "Senha: hello" test_output.tmp && grep -q "Encontrada no potfile" test_output.tmp && \
+   ! grep -q "Iniciando workers" test_output.tmp && grep -q "^[0-9]*:hello$" password_found.txt; then
+    echo -e "${GREEN}✓ PASSOU: Senha 'hello' lida do potfile, sem criar workers${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ FALHOU: Segunda execução não usou o potfile${NC}"
+    cat test_output.tmp potfile.tmp 2>/dev/null
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+rm -f potfile.tmp potfile.tmp.idx
+
+# Teste 15: Fila de trabalhos - workers permanentes, um resultado por trabalho
+echo -e "\n${YELLOW}[Teste] Fila de trabalhos (--queue)${NC}"
+rm -f password_found.txt
+cat > jobs.tmp <<EOF
+900150983cd24fb0d6963f7d28e17f72 3 abc
+# comentário
+81dc9bdb52d04dc20036dbd8313ed055 ?d?d?d?d
+linha inválida
+c3e0e8f21f1f2d5a1f4b8f0f0fa8e5ba 4 ab
+EOF
+timeout 30s ./coordinator --no-potfile --queue jobs.tmp 2 > test_output.tmp 2>&1
+if grep -q "^\[Trabalho 1\] 900150983cd24fb0d6963f7d28e17f72  abc  Worker" test_output.tmp && \
+   grep -q "^\[Trabalho 2\] 81dc9bdb52d04dc20036dbd8313ed055  1234  Worker" test_output.tmp && \
+   grep -q "^\[Trabalho 3\] Linha inválida" test_output.tmp && \
+   grep -q "^\[Trabalho 4\] .*não encontrada" test_output.tmp && \
+   [ "$(grep -c "Iniciando workers" test_output.tmp)" -eq 1 ] && \
+   grep -q "^81dc9bdb52d04dc20036dbd8313ed055:[0-9]*:1234$" password_found.txt; then
+    echo -e "${GREEN}✓ PASSOU: 4 trabalhos (2 quebrados) com o mesmo pool de workers${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ FALHOU: Fila de trabalhos${NC}"
+    cat test_output.tmp
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+rm -f jobs.tmp
+
+# Teste 16: Prefixo (sal de 70 bytes: um bloco MD5 pré-calculado) e sufixo
+echo -e "\n${YELLOW}[Teste] Prefixo e sufixo com midstate (--prefix, --suffix)${NC}"
+rm -f password_found.txt
+PREFIX="0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdefsalt!!"
+timeout 30s ./coordinator --no-potfile --prefix "$PREFIX" --suffix '#x' \
+    62409c33ab4789d9c05c07c00d640dc4 3 abc123 2 > test_output.tmp 2>&1
+if grep -q "Senha: b1c" test_output.tmp && grep -q "1 blocos MD5 pré-calculados" test_output.tmp && \
+   grep -q "^[0-9]*:b1c$" password_found.txt; then
+    echo -e "${GREEN}✓ PASSOU: Senha 'b1c' encontrada entre um prefixo de 70 bytes e o sufixo '#x'${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ FALHOU: Prefixo e sufixo${NC}"
+    cat test_output.tmp
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+
+# Teste 17: Ordem Markov - modelo treinado em nomes acha 'jade' nos primeiros candidatos
+echo -e "\n${YELLOW}[Teste] Ordem por probabilidade (markov_train + --markov)${NC}"
+rm -f password_found.txt
+printf 'john\njane\njake\njoan\nmary\nmark\nmike\nmatt\nluke\nlisa\nkate\nkyle\n' > names.tmp
+if timeout 10s ./markov_train names.tmp names.mkv > /dev/null 2>&1; then
+    timeout 30s ./coordinator --no-potfile --markov names.mkv bf17e568257ec4f32a1128167e882312 \
+        4 abcdefghijklmnopqrstuvwxyz 2 > test_output.tmp 2>&1
+fi
+CHECKED=$(grep -a "Finalizado. Total:" test_output.tmp 2>/dev/null | awk '{s += $5} END {print s + 0}')
+if grep -q "Senha: jade" test_output.tmp && [ "$CHECKED" -gt 0 ] && [ "$CHECKED" -lt 10000 ]; then
+    echo -e "${GREEN}✓ PASSOU: Senha 'jade' após $CHECKED de 456976 candidatos (lexicográfica: ~158000)${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ FALHOU: Ordem Markov ($CHECKED candidatos)${NC}"
+    cat test_output.tmp
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+rm -f names.tmp names.mkv
+
+# Teste 18: Senha de 20 caracteres, espaço de 26^20 (mais de 2^94) dividido entre 2 workers
+echo -e "\n${YELLOW}[Teste] Espaço de busca acima de 2^63 (índices de 128 bits)${NC}"
+rm -f password_found.txt
+timeout 30s ./coordinator --no-potfile --mask '?l?l?l?l?l?l?l?l?l?l?l?l?l?l?l?l?l?l?l?l' \
+    54df6dd28948f4bf6e0c6b93e37bf8f2 2 > test_output.tmp 2>&1
+if grep -q "Senha: naaaaaaaaaaaaaaaaabc" test_output.tmp && \
+   grep -q "Espaço de busca total: 19928148895209409152340197376 " test_output.tmp && \
+   grep -q "^[0-9]*:naaaaaaaaaaaaaaaaabc$" password_found.txt; then
+    echo -e "${GREEN}✓ PASSOU: Senha de 20 caracteres no início da metade do Worker 1${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ FALHOU: Espaço de busca de 128 bits${NC}"
+    cat test_output.tmp
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+
+# Teste 19: Contadores por worker; sem PMU (container) cai nos relógios de software
+echo -e "\n${YELLOW}[Teste] Contadores de hardware por worker (--perf)${NC}"
+timeout 30s ./coordinator --no-potfile --perf 900150983cd24fb0d6963f7d28e17f72 3 abc 2 \
+    > test_output.tmp 2>&1
+if grep -q "Senha: abc" test_output.tmp && \
+   grep -Eq "^\[Worker [01]\] Contadores(:| de hardware indisponíveis)" test_output.tmp && \
+   grep -q "^\[Worker [01]\] CPU: .* ns/senha" test_output.tmp; then
+    echo -e "${GREEN}✓ PASSOU: Resumo de contadores (ou relógios de software) de cada worker${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ FALHOU: Contadores por worker${NC}"
+    cat test_output.tmp
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+
+# Teste 20: num_workers = auto pela topologia (núcleos, SMT, cota), nos dois motores
+echo -e "\n${YELLOW}[Teste] Workers automáticos pela topologia (auto)${NC}"
+rm -f password_found.txt
+timeout 30s ./coordinator --no-potfile 900150983cd24fb0d6963f7d28e17f72 3 abc auto \
+    > test_output.tmp 2>&1
+timeout 30s ./coordinator --no-potfile -e threads 900150983cd24fb0d6963f7d28e17f72 3 abc auto \
+    >> test_output.tmp 2>&1
+if [ "$(grep -c "Senha: abc" test_output.tmp)" -eq 2 ] && \
+   [ "$(grep -c "^Topologia: [0-9]* CPUs permitidas, [0-9]* núcleos físicos" test_output.tmp)" -eq 2 ] && \
+   grep -q "^[0-9]*:abc$" password_found.txt; then
+    echo -e "${GREEN}✓ PASSOU: Número de workers e CPUs escolhidos pela topologia${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ FALHOU: Workers automáticos${NC}"
+    cat test_output.tmp
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+
 echo -e "\n${YELLOW}[Teste de Performance] Speedup com Múltiplos Workers${NC}"
 echo "Testando se paralelização realmente acelera a busca:"
 performance_test "Speedup Test" \
@@ -215,7 +483,7 @@ fi
 
 echo -n "Hash inválido (não encontrado): "
 rm -f password_found.txt
-timeout 10s ./coordinator "hash_inexistente" "2" "ab" "2" >/dev/null 2>&1
+timeout 10s ./coordinator --no-potfile "hash_inexistente" "2" "ab" "2" >/dev/null 2>&1
 if [ ! -f "password_found.txt" ]; then
     echo -e "${GREEN}✓ Nenhuma senha encontrada (correto)${NC}"
     TESTS_PASSED=$((TESTS_PASSED + 1))
@@ -224,9 +492,45 @@ else
     TESTS_FAILED=$((TESTS_FAILED + 1))
 fi
 
+echo -n "Hash em maiúsculas: "
+rm -f password_found.txt potfile.tmp potfile.tmp.idx
+timeout 10s ./coordinator --potfile potfile.tmp "900150983CD24FB0D6963F7D28E17F72" "3" "abc" "2" \
+    > test_output.tmp 2>&1
+timeout 10s ./coordinator --potfile potfile.tmp "900150983CD24FB0D6963F7D28E17F72" "3" "abc" "2" \
+    >> test_output.tmp 2>&1
+if [ "$(grep -c "Verificação: ✓ Hash corresponde!" test_output.tmp)" -eq 2 ] && \
+   grep -q "Encontrada no potfile" test_output.tmp; then
+    echo -e "${GREEN}✓ Senha encontrada e verificada, na busca e no potfile${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ A verificação deveria aceitar o hash em maiúsculas${NC}"
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+rm -f potfile.tmp potfile.tmp.idx
+
+echo -n "Worker morto no meio da busca: "
+rm -f checkpoint.tmp
+timeout 60s ./coordinator --no-potfile --checkpoint checkpoint.tmp "ffffffffffffffffffffffffffffffff" 7 \
+    abcdefghijklmnopqrstuvwxyz 2 > test_output.tmp 2>&1 &
+COORD_PID=$!
+sleep 2
+pkill -KILL -x worker 2>/dev/null
+wait $COORD_PID
+COORD_STATUS=$?
+if [ $COORD_STATUS -ne 0 ] && grep -q "^feito [0-9]* [0-9]*$" checkpoint.tmp 2>/dev/null && \
+   grep -q "Busca incompleta" test_output.tmp && ! grep -q "não encontrada" test_output.tmp; then
+    echo -e "${GREEN}✓ Busca relatada como incompleta e checkpoint mantido${NC}"
+    TESTS_PASSED=$((TESTS_PASSED + 1))
+else
+    echo -e "${RED}✗ O checkpoint deveria ficar para o --resume (código $COORD_STATUS)${NC}"
+    cat test_output.tmp checkpoint.tmp 2>/dev/null
+    TESTS_FAILED=$((TESTS_FAILED + 1))
+fi
+rm -f checkpoint.tmp checkpoint.tmp.tmp
+
 # Verificar processos zumbi
 echo -n "Verificando processos zumbi: "
-./coordinator "900150983cd24fb0d6963f7d28e17f72" "3" "abc" "4" >/dev/null 2>&1
+./coordinator --no-potfile "900150983cd24fb0d6963f7d28e17f72" "3" "abc" "4" >/dev/null 2>&1
 sleep 1
 ZOMBIES=$(ps aux | grep -v grep | grep defunct | wc -l)
 if [ $ZOMBIES -eq 0 ]; then